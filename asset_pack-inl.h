@@ -0,0 +1,293 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_ASSET_PACK_INL_H_
+#define OGLWRAP_ASSET_PACK_INL_H_
+
+#include <limits>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "./asset_pack.h"
+#include "context/pixel_ops.h"
+#include "debug/bind_checking.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline AssetPackWriter::AssetPackWriter(uint32_t alignment)
+    : alignment_(alignment) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    throw std::invalid_argument("The alignment of an asset pack must be a "
+                                "power of two.");
+  }
+}
+
+inline AssetPackEntry& AssetPackWriter::newEntry(const std::string& name,
+                                                 AssetKind kind) {
+  AssetPackEntry entry;
+  std::memset(&entry, 0, sizeof(entry));
+  if (name.size() >= sizeof(entry.name)) {
+    throw std::invalid_argument("Asset name '" + name + "' is too long.");
+  }
+  std::memcpy(entry.name, name.c_str(), name.size());
+  entry.kind = uint32_t(kind);
+  entries_.push_back(entry);
+  return entries_.back();
+}
+
+inline uint64_t AssetPackWriter::appendBlob(const void* data, size_t size) {
+  // The blobs are stored right after the header, but the alignment is
+  // relative to the beginning of the file.
+  size_t header_size = sizeof(AssetPackHeader);
+  size_t file_offset = header_size + blobs_.size();
+  size_t aligned = (file_offset + alignment_ - 1) / alignment_ * alignment_;
+  blobs_.resize(aligned - header_size, 0);
+
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  blobs_.insert(blobs_.end(), bytes, bytes + size);
+  return aligned;
+}
+
+inline void AssetPackWriter::addBuffer(
+    const std::string& name, BufferType type, const void* data, size_t size,
+    const std::vector<AssetPackAttrib>& attribs) {
+  if (attribs.size() > kAssetPackMaxAttribs) {
+    throw std::invalid_argument("Asset '" + name + "' has too many vertex "
+                                "attributes.");
+  }
+
+  uint64_t offset = appendBlob(data, size);
+  AssetPackEntry& entry = newEntry(name, AssetKind::kBuffer);
+  entry.offset = offset;
+  entry.size = size;
+  entry.buffer_type = uint32_t(GLenum(type));
+  entry.attrib_count = attribs.size();
+  for (size_t i = 0; i < attribs.size(); ++i) {
+    entry.attribs[i] = attribs[i];
+  }
+}
+
+inline void AssetPackWriter::addIndexBuffer(const std::string& name,
+                                            IndexType index_type,
+                                            const void* data, size_t size) {
+  addBuffer(name, BufferType::kElementArrayBuffer, data, size);
+  entries_.back().index_type = uint32_t(GLenum(index_type));
+}
+
+inline void AssetPackWriter::addTexture2D(
+    const std::string& name, PixelDataInternalFormat internal_format,
+    PixelDataFormat format, PixelDataType type, GLsizei width, GLsizei height,
+    const std::vector<Level>& levels) {
+  addCompressedTexture2D(name, internal_format, width, height, levels);
+  entries_.back().format = uint32_t(GLenum(format));
+  entries_.back().type = uint32_t(GLenum(type));
+}
+
+inline void AssetPackWriter::addCompressedTexture2D(
+    const std::string& name, PixelDataInternalFormat internal_format,
+    GLsizei width, GLsizei height, const std::vector<Level>& levels) {
+  if (levels.size() > kAssetPackMaxLevels) {
+    throw std::invalid_argument("Asset '" + name + "' has too many mipmap "
+                                "levels.");
+  }
+
+  std::vector<uint64_t> offsets;
+  uint64_t begin = 0;
+  for (size_t i = 0; i < levels.size(); ++i) {
+    offsets.push_back(appendBlob(levels[i].data, levels[i].size));
+    if (i == 0) {
+      begin = offsets.back();
+    }
+  }
+
+  AssetPackEntry& entry = newEntry(name, AssetKind::kTexture2D);
+  entry.offset = begin;
+  entry.size = sizeof(AssetPackHeader) + blobs_.size() - begin;
+  entry.internal_format = uint32_t(GLenum(internal_format));
+  entry.level_count = levels.size();
+  for (size_t i = 0; i < levels.size(); ++i) {
+    AssetPackLevel& level = entry.levels[i];
+    level.offset = offsets[i];
+    level.size = levels[i].size;
+    level.width = std::max<GLsizei>(width >> i, 1);
+    level.height = std::max<GLsizei>(height >> i, 1);
+  }
+}
+
+inline void AssetPackWriter::write(const std::string& path) const {
+  std::ofstream file(path.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Asset pack '" + path + "' couldn't be created.");
+  }
+
+  size_t blobs_end = sizeof(AssetPackHeader) + blobs_.size();
+  size_t toc_offset = (blobs_end + alignof(AssetPackEntry) - 1)
+                      / alignof(AssetPackEntry) * alignof(AssetPackEntry);
+
+  AssetPackHeader header;
+  std::memcpy(header.magic, kAssetPackMagic, sizeof(header.magic));
+  header.version = kAssetPackVersion;
+  header.alignment = alignment_;
+  header.entry_count = entries_.size();
+  header.toc_offset = toc_offset;
+  header.file_size = toc_offset + entries_.size() * sizeof(AssetPackEntry);
+
+  const char padding[alignof(AssetPackEntry)] = {};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(blobs_.data()), blobs_.size());
+  file.write(padding, toc_offset - blobs_end);
+  file.write(reinterpret_cast<const char*>(entries_.data()),
+             entries_.size() * sizeof(AssetPackEntry));
+
+  if (!file.good()) {
+    throw std::runtime_error("Asset pack '" + path + "' couldn't be written.");
+  }
+}
+
+inline AssetPack::AssetPack(const std::string& path) : file_(path) {
+  validate(path);
+}
+
+inline void AssetPack::validate(const std::string& path) const {
+  if (file_.size() < sizeof(AssetPackHeader)) {
+    throw std::runtime_error("'" + path + "' is not an asset pack.");
+  }
+
+  const AssetPackHeader& head = header();
+  if (std::memcmp(head.magic, kAssetPackMagic, sizeof(head.magic)) != 0) {
+    throw std::runtime_error("'" + path + "' is not an asset pack.");
+  }
+  uint32_t swapped_version = (kAssetPackVersion >> 24) |
+                             ((kAssetPackVersion >> 8) & 0xFF00u) |
+                             ((kAssetPackVersion << 8) & 0xFF0000u) |
+                             (kAssetPackVersion << 24);
+  if (head.version == swapped_version) {
+    throw std::runtime_error("Asset pack '" + path + "' was written on a "
+                             "machine with a different byte order.");
+  }
+  if (head.version != kAssetPackVersion) {
+    throw std::runtime_error("Asset pack '" + path + "' has an unsupported "
+                             "version.");
+  }
+  if (head.file_size != file_.size() ||
+      head.toc_offset % alignof(AssetPackEntry) != 0 ||
+      head.toc_offset > file_.size() ||
+      (file_.size() - head.toc_offset) / sizeof(AssetPackEntry)
+          < head.entry_count) {
+    throw std::runtime_error("Asset pack '" + path + "' is truncated.");
+  }
+
+  for (size_t i = 0; i < head.entry_count; ++i) {
+    const AssetPackEntry& entry = entries()[i];
+    bool valid = entry.name[sizeof(entry.name) - 1] == '\0' &&
+                 entry.offset <= head.toc_offset &&
+                 entry.size <= head.toc_offset - entry.offset &&
+                 entry.attrib_count <= kAssetPackMaxAttribs &&
+                 entry.level_count <= kAssetPackMaxLevels;
+    for (size_t level = 0; valid && level < entry.level_count; ++level) {
+      const AssetPackLevel& lvl = entry.levels[level];
+      valid = lvl.offset <= head.toc_offset &&
+              lvl.size <= head.toc_offset - lvl.offset;
+    }
+    if (!valid) {
+      throw std::runtime_error("Asset pack '" + path + "' is corrupted.");
+    }
+  }
+}
+
+inline const AssetPackEntry* AssetPack::find(const std::string& name) const {
+  for (size_t i = 0; i < size(); ++i) {
+    if (name == entries()[i].name) {
+      return &entries()[i];
+    }
+  }
+  return nullptr;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+    && defined(glDeleteBuffers) && defined(glBufferData))
+template<BufferType BUFFER_TYPE>
+void AssetPack::upload(const AssetPackEntry& entry,
+                       BufferObject<BUFFER_TYPE>& buffer,
+                       BufferUsage usage) const {
+#if OGLWRAP_DEBUG
+  if (entry.kind != uint32_t(AssetKind::kBuffer)) {
+    OGLWRAP_PRINT_ERROR("Asset kind mismatch",
+      std::string("AssetPack::upload was called with '") + entry.name +
+      "', that is not a buffer asset.");
+    return;
+  }
+#endif
+  if (entry.size > uint64_t(std::numeric_limits<GLsizei>::max())) {
+    throw std::runtime_error(std::string("Asset '") + entry.name + "' is too "
+                             "large to be uploaded into a single buffer.");
+  }
+  buffer.data(GLsizei(entry.size), data(entry), usage);
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetAttribLocation) \
+    && defined(glVertexAttribPointer) && defined(glVertexAttribIPointer) \
+    && defined(glEnableVertexAttribArray))
+inline void AssetPack::setupVertexFormat(const AssetPackEntry& entry) const {
+  for (size_t i = 0; i < entry.attrib_count; ++i) {
+    const AssetPackAttrib& attrib = entry.attribs[i];
+    VertexAttribObject attrib_object(attrib.location);
+    attrib_object.setup(attrib.values_per_vertex, DataType(attrib.type),
+                        attrib.stride,
+                        reinterpret_cast<const void*>(
+                            static_cast<uintptr_t>(attrib.offset)));
+    attrib_object.enable();
+  }
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexImage2D) \
+    && defined(glCompressedTexImage2D) && defined(glPixelStorei))
+template<Texture2DType texture_t>
+void AssetPack::upload(const AssetPackEntry& entry,
+                       Texture2DBase<texture_t>& texture) const {
+  OGLWRAP_CHECK_BINDING_EXPLICIT(texture);
+#if OGLWRAP_DEBUG
+  if (entry.kind != uint32_t(AssetKind::kTexture2D)) {
+    OGLWRAP_PRINT_ERROR("Asset kind mismatch",
+      std::string("AssetPack::upload was called with '") + entry.name +
+      "', that is not a texture asset.");
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < entry.level_count; ++i) {
+    const AssetPackLevel& level = entry.levels[i];
+    if (entry.format == 0) {
+      gl(CompressedTexImage2D(GLenum(texture_t), i, entry.internal_format,
+                              level.width, level.height, 0, level.size,
+                              levelData(entry, i)));
+    } else {
+      // The rows are tightly packed in the pack. The previous unpack
+      // parameters are restored after the upload.
+      PixelDataFormat format = PixelDataFormat(entry.format);
+      PixelDataType type = PixelDataType(entry.type);
+      ScopedUnpackRegion region(level.width * GetPixelSize(format, type), 0, 0,
+                                format, type);
+      texture.uploadMipmap(i, PixelDataInternalFormat(entry.internal_format),
+                           level.width, level.height, format, type,
+                           levelData(entry, i));
+    }
+  }
+
+  // Without this, a texture with an incomplete mip chain would be unusable.
+  if (entry.level_count > 0) {
+    texture.maxLevel(entry.level_count - 1);
+  }
+}
+#endif
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_ASSET_PACK_INL_H_
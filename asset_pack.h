@@ -0,0 +1,295 @@
+// Copyright (c) Tamas Csala
+
+/** @file asset_pack.h
+    @brief Implements a binary asset format, whose contents can be uploaded to
+           the GPU directly from a memory mapped file.
+
+    A pack consists of:
+     - an AssetPackHeader at the beginning of the file,
+     - the blobs, each one starting at a multiple of the alignment of the pack,
+     - the table of contents, an array of AssetPackEntries, at toc_offset.
+    The structures are written and read in place, in the native byte order
+    of the machine, that created the pack, so packs aren't portable between
+    little and big endian machines (the reader detects, and rejects them).
+*/
+
+#ifndef OGLWRAP_ASSET_PACK_H_
+#define OGLWRAP_ASSET_PACK_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "./config.h"
+#include "./buffer.h"
+#include "./mapped_file.h"
+#include "./vertex_attrib.h"
+#include "textures/texture_2D.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The first four bytes of every asset pack.
+static const char kAssetPackMagic[4] = {'O', 'G', 'L', 'P'};
+
+/// The version of the format, that this header can read and write.
+static const uint32_t kAssetPackVersion = 1;
+
+/// The maximum number of vertex attributes an asset can describe.
+static const size_t kAssetPackMaxAttribs = 16;
+
+/// The maximum number of mipmap levels a texture asset can contain.
+static const size_t kAssetPackMaxLevels = 16;
+
+/// The kinds of assets a pack can store.
+enum class AssetKind : uint32_t {
+  kBuffer = 1,
+  kTexture2D = 2
+};
+
+/// The header at the beginning of an asset pack.
+struct AssetPackHeader {
+  char magic[4];
+  uint32_t version;
+  /// Every blob starts at a multiple of this many bytes.
+  uint32_t alignment;
+  uint32_t entry_count;
+  uint64_t toc_offset;
+  uint64_t file_size;
+};
+static_assert(sizeof(AssetPackHeader) == 32,
+              "AssetPackHeader must not contain padding");
+
+/// Describes a vertex attribute stored in a buffer asset.
+/** The fields are the parameters of VertexAttribObject::setup(). */
+struct AssetPackAttrib {
+  uint32_t location;
+  uint32_t values_per_vertex;
+  /// A DataType value.
+  uint32_t type;
+  uint32_t stride;
+  uint32_t offset;
+  uint32_t reserved[3];
+};
+static_assert(sizeof(AssetPackAttrib) == 32,
+              "AssetPackAttrib must not contain padding");
+
+/// Describes a mipmap level of a texture asset.
+struct AssetPackLevel {
+  /// The offset of the level from the beginning of the file in bytes.
+  uint64_t offset;
+  uint64_t size;
+  uint32_t width;
+  uint32_t height;
+  uint32_t reserved[2];
+};
+static_assert(sizeof(AssetPackLevel) == 32,
+              "AssetPackLevel must not contain padding");
+
+/// An entry of the table of contents of an asset pack.
+struct AssetPackEntry {
+  /// The null terminated name of the asset.
+  char name[64];
+  /// An AssetKind value.
+  uint32_t kind;
+  uint32_t reserved;
+  /// The offset of the blob from the beginning of the file in bytes.
+  uint64_t offset;
+  uint64_t size;
+
+  // Buffer assets
+  /// A BufferType value.
+  uint32_t buffer_type;
+  /// An IndexType value for index buffers, 0 otherwise.
+  uint32_t index_type;
+  uint32_t attrib_count;
+  uint32_t reserved2;
+  AssetPackAttrib attribs[kAssetPackMaxAttribs];
+
+  // Texture assets
+  /// A PixelDataInternalFormat value.
+  uint32_t internal_format;
+  /// A PixelDataFormat value, or 0 if the levels are compressed.
+  uint32_t format;
+  /// A PixelDataType value, or 0 if the levels are compressed.
+  uint32_t type;
+  uint32_t level_count;
+  AssetPackLevel levels[kAssetPackMaxLevels];
+};
+static_assert(sizeof(AssetPackEntry) == 1144,
+              "AssetPackEntry must not contain padding");
+
+/// Creates asset pack files.
+/** Meant to be used by offline tools, that bake the assets once. */
+class AssetPackWriter {
+ public:
+  /// Creates an empty pack.
+  /** @param alignment - Every blob will start at a multiple of this many
+    *                    bytes. Should be at least the alignment of the largest
+    *                    element type, that is stored in the pack.
+    * @throw std::invalid_argument if the alignment isn't a power of two. */
+  explicit AssetPackWriter(uint32_t alignment = 256);
+
+  /// Adds a buffer asset.
+  /** @param name - The name of the asset (at most 63 characters).
+    * @param type - The target the buffer is meant to be bound to.
+    * @param data - The contents of the buffer.
+    * @param size - The size of the buffer in bytes.
+    * @param attribs - The vertex attributes stored in the buffer.
+    * @throw std::invalid_argument if the name is too long, or there are too
+    *        many attributes. */
+  void addBuffer(const std::string& name, BufferType type,
+                 const void* data, size_t size,
+                 const std::vector<AssetPackAttrib>& attribs = {});
+
+  /// Adds an index buffer asset.
+  /** @param name - The name of the asset (at most 63 characters).
+    * @param index_type - The type of the indices.
+    * @param data - The indices.
+    * @param size - The size of the buffer in bytes.
+    * @throw std::invalid_argument if the name is too long. */
+  void addIndexBuffer(const std::string& name, IndexType index_type,
+                      const void* data, size_t size);
+
+  /// A mipmap level of a texture, that is added to the pack.
+  struct Level {
+    const void* data;
+    size_t size;
+  };
+
+  /// Adds a two-dimensional texture asset with every mipmap level given.
+  /** The rows of the levels must be tightly packed (unpack alignment of 1).
+    * @param name - The name of the asset (at most 63 characters).
+    * @param internal_format - The internal format of the texture.
+    * @param format - The format of the pixel data.
+    * @param type - The data type of the pixel data.
+    * @param width - The width of the base level.
+    * @param height - The height of the base level.
+    * @param levels - The levels, starting with the base level.
+    * @throw std::invalid_argument if the name is too long, or there are too
+    *        many levels. */
+  void addTexture2D(const std::string& name,
+                    PixelDataInternalFormat internal_format,
+                    PixelDataFormat format, PixelDataType type,
+                    GLsizei width, GLsizei height,
+                    const std::vector<Level>& levels);
+
+  /// Adds a compressed two-dimensional texture asset with every mipmap level.
+  /** @param name - The name of the asset (at most 63 characters).
+    * @param internal_format - The compressed internal format of the texture.
+    * @param width - The width of the base level.
+    * @param height - The height of the base level.
+    * @param levels - The compressed levels, starting with the base level.
+    * @throw std::invalid_argument if the name is too long, or there are too
+    *        many levels. */
+  void addCompressedTexture2D(const std::string& name,
+                              PixelDataInternalFormat internal_format,
+                              GLsizei width, GLsizei height,
+                              const std::vector<Level>& levels);
+
+  /// Writes the pack to a file.
+  /** @param path - The path of the file.
+    * @throw std::runtime_error if the file can't be written. */
+  void write(const std::string& path) const;
+
+ private:
+  uint32_t alignment_;
+  std::vector<AssetPackEntry> entries_;
+  std::vector<unsigned char> blobs_;  // Everything between the header and the TOC
+
+  AssetPackEntry& newEntry(const std::string& name, AssetKind kind);
+  uint64_t appendBlob(const void* data, size_t size);
+};
+
+/// Reads asset packs through a memory mapping.
+/** The table of contents is used in place, and the blobs are uploaded straight
+  * from the mapping, without parsing or converting them. */
+class AssetPack {
+ public:
+  /// Maps a pack, and validates its header and table of contents.
+  /** @param path - The path of the pack.
+    * @throw std::runtime_error if the file can't be mapped, or isn't a valid
+    *        pack of a supported version. */
+  explicit AssetPack(const std::string& path);
+
+  /// Returns the number of assets in the pack.
+  size_t size() const { return header().entry_count; }
+
+  /// Returns the i-th entry of the table of contents.
+  const AssetPackEntry& entry(size_t i) const { return entries()[i]; }
+
+  /// Returns the entry with the given name, or nullptr if there is no such one.
+  const AssetPackEntry* find(const std::string& name) const;
+
+  /// Returns the blob of an asset.
+  const void* data(const AssetPackEntry& entry) const {
+    return file_.data() + entry.offset;
+  }
+
+  /// Returns the data of a mipmap level of a texture asset.
+  const void* levelData(const AssetPackEntry& entry, size_t level) const {
+    return file_.data() + entry.levels[level].offset;
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+    && defined(glDeleteBuffers) && defined(glBufferData))
+  template<BufferType BUFFER_TYPE>
+  /// Creates the data store of a buffer from a buffer asset.
+  /** The buffer should be bound.
+    * @param entry - The buffer asset.
+    * @param buffer - The buffer to upload to.
+    * @param usage - Specifies the expected usage pattern of the data store.
+    * @throw std::runtime_error if the asset is larger than what glBufferData
+    *        can allocate (2 GiB).
+    * @see glBufferData */
+  void upload(const AssetPackEntry& entry, BufferObject<BUFFER_TYPE>& buffer,
+              BufferUsage usage = BufferUsage::kStaticDraw) const;
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetAttribLocation) \
+    && defined(glVertexAttribPointer) && defined(glVertexAttribIPointer) \
+    && defined(glEnableVertexAttribArray))
+  /// Sets up and enables the vertex attributes described by a buffer asset.
+  /** The vertex array object, and the ArrayBuffer created from the asset
+    * should be bound.
+    * @param entry - The buffer asset.
+    * @see glVertexAttribPointer, glEnableVertexAttribArray */
+  void setupVertexFormat(const AssetPackEntry& entry) const;
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexImage2D) \
+    && defined(glCompressedTexImage2D) && defined(glPixelStorei))
+  template<Texture2DType texture_t>
+  /// Uploads every mipmap level of a texture asset.
+  /** The texture should be bound. The unpack parameters are restored after
+    * the upload.
+    * @param entry - The texture asset.
+    * @param texture - The texture to upload to.
+    * @see glTexImage2D, glCompressedTexImage2D */
+  void upload(const AssetPackEntry& entry,
+              Texture2DBase<texture_t>& texture) const;
+#endif
+
+ private:
+  MappedFile file_;
+
+  const AssetPackHeader& header() const {
+    return *reinterpret_cast<const AssetPackHeader*>(file_.data());
+  }
+
+  const AssetPackEntry* entries() const {
+    return reinterpret_cast<const AssetPackEntry*>(
+        file_.data() + header().toc_offset);
+  }
+
+  void validate(const std::string& path) const;
+};
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./asset_pack-inl.h"
+
+#endif  // OGLWRAP_ASSET_PACK_H_
@@ -0,0 +1,118 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_BINDLESS_TEXTURES_INL_H_
+#define OGLWRAP_BINDLESS_TEXTURES_INL_H_
+
+#include "./bindless_textures.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetTextureHandleARB) \
+    && defined(glMakeTextureHandleResidentARB) \
+    && defined(glMakeTextureHandleNonResidentARB))
+
+inline BindlessTextureManager::~BindlessTextureManager() {
+  for (Slot slot : lru_) {
+    gl(MakeTextureHandleNonResidentARB(entries_[slot].handle));
+  }
+}
+
+inline BindlessTextureManager::Slot BindlessTextureManager::addHandle(
+    GLuint64 handle, size_t size) {
+  Slot slot;
+  if (free_slots_.empty()) {
+    slot = entries_.size();
+    entries_.emplace_back();
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+
+  Entry& entry = entries_[slot];
+  entry.handle = handle;
+  entry.size = size;
+  table_dirty_ = true;
+  return slot;
+}
+
+template <TextureType TEXTURE_TYPE>
+BindlessTextureManager::Slot BindlessTextureManager::add(
+    TextureBase<TEXTURE_TYPE>& texture, size_t size) {
+  if (texture.bindless_handle() == 0) {
+    texture.makeBindless();
+  }
+  return addHandle(texture.bindless_handle(), size);
+}
+
+inline void BindlessTextureManager::makeNonResident(Slot slot) {
+  Entry& entry = entries_[slot];
+  if (entry.resident) {
+    gl(MakeTextureHandleNonResidentARB(entry.handle));
+    lru_.erase(entry.lru_position);
+    resident_size_ -= entry.size;
+    entry.resident = false;
+  }
+}
+
+inline void BindlessTextureManager::remove(Slot slot) {
+  makeNonResident(slot);
+  entries_[slot] = Entry{};
+  free_slots_.push_back(slot);
+  table_dirty_ = true;
+}
+
+inline void BindlessTextureManager::evict(size_t needed_size) {
+  while (!lru_.empty() && resident_size_ + needed_size > budget_) {
+    Slot slot = lru_.front();
+    // Every texture after this one was used in the current frame too.
+    if (entries_[slot].last_used == frame_) {
+      break;
+    }
+    makeNonResident(slot);
+  }
+}
+
+inline void BindlessTextureManager::use(Slot slot) {
+  Entry& entry = entries_[slot];
+  entry.last_used = frame_;
+  if (entry.resident) {
+    lru_.splice(lru_.end(), lru_, entry.lru_position);
+    return;
+  }
+
+  evict(entry.size);
+  gl(MakeTextureHandleResidentARB(entry.handle));
+  entry.resident = true;
+  entry.lru_position = lru_.insert(lru_.end(), slot);
+  resident_size_ += entry.size;
+}
+
+inline void BindlessTextureManager::budget(size_t budget) {
+  budget_ = budget;
+  evict(0);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+template <BufferType BUFFER_TYPE>
+void BindlessTextureManager::uploadTable(BufferObject<BUFFER_TYPE>& buffer,
+                                         BufferUsage usage) {
+  // std140 rounds up the stride of arrays to the size of a vec4.
+  size_t stride = GLenum(BUFFER_TYPE) == GL_UNIFORM_BUFFER ? 2 : 1;
+  std::vector<GLuint64> table(entries_.size() * stride, 0);
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    table[i * stride] = entries_[i].handle;
+  }
+  buffer.data(table, usage);
+  table_dirty_ = false;
+}
+#endif
+
+#endif  // glGetTextureHandleARB && glMake*TextureHandle*ResidentARB
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_BINDLESS_TEXTURES_INL_H_
@@ -0,0 +1,139 @@
+// Copyright (c) Tamas Csala
+
+/** @file bindless_textures.h
+    @brief Implements a manager for the residency of bindless textures.
+*/
+
+#ifndef OGLWRAP_BINDLESS_TEXTURES_H_
+#define OGLWRAP_BINDLESS_TEXTURES_H_
+
+#include <list>
+#include <vector>
+#include <cstddef>
+
+#include "./config.h"
+#include "./buffer.h"
+#include "textures/texture_base.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetTextureHandleARB) \
+    && defined(glMakeTextureHandleResidentARB) \
+    && defined(glMakeTextureHandleNonResidentARB))
+/// Keeps the used bindless textures resident, within a memory budget.
+/** Every texture added to the manager gets a slot in a handle table, that can
+  * be uploaded into a buffer, so shaders can index the textures without any
+  * of them being bound. The textures, that are used in a frame are made
+  * resident. If the resident textures would exceed the budget, the ones used
+  * least recently (but not in the current frame) are made non-resident.
+  * @see GL_ARB_bindless_texture */
+class BindlessTextureManager {
+ public:
+  /// The index of a texture in the handle table.
+  using Slot = size_t;
+
+  /// Creates a manager.
+  /** @param budget - The maximum size of the resident textures in bytes. */
+  explicit BindlessTextureManager(size_t budget) : budget_(budget) {}
+
+  /// Makes every texture of the manager non-resident.
+  ~BindlessTextureManager();
+
+  BindlessTextureManager(const BindlessTextureManager&) = delete;
+  BindlessTextureManager& operator=(const BindlessTextureManager&) = delete;
+
+  template <TextureType TEXTURE_TYPE>
+  /// Adds a texture to the handle table.
+  /** The texture is made bindless if it isn't already, so its state can't be
+    * changed after this call. It isn't made resident until it is used.
+    * @param texture - The texture to add. It must outlive its slot.
+    * @param size - The size of the texture in the video memory in bytes.
+    * @return The slot of the texture, which is the index of its handle in
+    *         the handle table.
+    * @see glGetTextureHandleARB */
+  Slot add(TextureBase<TEXTURE_TYPE>& texture, size_t size);
+
+  /// Removes a texture from the handle table.
+  /** The texture is made non-resident, and its slot might be reused.
+    * @see glMakeTextureHandleNonResidentARB */
+  void remove(Slot slot);
+
+  /// Marks the beginning of a new frame.
+  /** The textures used in the previous frames become candidates of eviction. */
+  void beginFrame() { ++frame_; }
+
+  /// Marks a texture as used in the current frame, and makes it resident.
+  /** If the resident textures would exceed the budget, the least recently used
+    * ones are evicted. The textures used in the current frame are never
+    * evicted, so the budget might be exceeded if a frame uses too much.
+    * @see glMakeTextureHandleResidentARB, glMakeTextureHandleNonResidentARB */
+  void use(Slot slot);
+
+  /// Returns the bindless handle of a texture.
+  GLuint64 handle(Slot slot) const { return entries_[slot].handle; }
+
+  /// Returns true if a texture is resident.
+  bool isResident(Slot slot) const { return entries_[slot].resident; }
+
+  /// Returns the size of the resident textures in bytes.
+  size_t residentSize() const { return resident_size_; }
+
+  /// Returns the budget in bytes.
+  size_t budget() const { return budget_; }
+
+  /// Changes the budget, and evicts textures if it is exceeded.
+  /** @param budget - The maximum size of the resident textures in bytes. */
+  void budget(size_t budget);
+
+  /// Returns the number of slots in the handle table.
+  size_t size() const { return entries_.size(); }
+
+  /// Returns true if the handle table changed since it was last uploaded.
+  bool isTableDirty() const { return table_dirty_; }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+  template <BufferType BUFFER_TYPE>
+  /// Uploads the handle table into a buffer.
+  /** Slots without a texture contain zero. In uniform buffers every handle is
+    * padded to 16 bytes (an array of uvec2 in a std140 block), in every other
+    * buffer they are tightly packed (an array of uvec2 or uint64_t in a
+    * std430 block). The buffer should be bound.
+    * @param buffer - The buffer to upload to.
+    * @param usage - Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void uploadTable(BufferObject<BUFFER_TYPE>& buffer,
+                   BufferUsage usage = BufferUsage::kDynamicDraw);
+#endif
+
+ private:
+  struct Entry {
+    GLuint64 handle = 0;
+    size_t size = 0;
+    bool resident = false;
+    size_t last_used = 0;
+    std::list<Slot>::iterator lru_position;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<Slot> free_slots_;
+  std::list<Slot> lru_;  // The resident textures, least recently used first
+  size_t budget_;
+  size_t resident_size_ = 0;
+  size_t frame_ = 1;
+  bool table_dirty_ = true;
+
+  Slot addHandle(GLuint64 handle, size_t size);
+  void makeNonResident(Slot slot);
+  void evict(size_t needed_size);
+};
+#endif  // glGetTextureHandleARB && glMake*TextureHandle*ResidentARB
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./bindless_textures-inl.h"
+
+#endif  // OGLWRAP_BINDLESS_TEXTURES_H_
@@ -18,19 +18,32 @@ namespace OGLWRAP_NAMESPACE_NAME {
 template<BufferType BUFFER_TYPE>
 void BufferObject<BUFFER_TYPE>::data(GLsizei size, const void* data,
                                      BufferUsage usage) {
+#if OGLWRAP_USE_DSA
+  gl(NamedBufferData(buffer_, size, data, GLenum(usage)));
+#else
   OGLWRAP_CHECK_BINDING();
 
   gl(BufferData(GLenum(BUFFER_TYPE), size, data, GLenum(usage)));
+#endif
 }
 
 template<BufferType BUFFER_TYPE>
 template<typename GLtype>
 void BufferObject<BUFFER_TYPE>::data(
     const std::vector<GLtype>& data, BufferUsage usage) {
-  OGLWRAP_CHECK_BINDING();
+  this->data(data.size() * sizeof(GLtype), data.data(), usage);
+}
 
-  gl(BufferData(GLenum(BUFFER_TYPE), data.size() * sizeof(GLtype),
-                data.data(), GLenum(usage)));
+template<BufferType BUFFER_TYPE>
+template<typename ContiguousRange, typename>
+void BufferObject<BUFFER_TYPE>::data(const ContiguousRange& range,
+                                     BufferUsage usage) {
+  using Element = OGLWRAP_RangeElement<ContiguousRange>;
+  static_assert(std::is_trivially_copyable<Element>::value,
+                "Only trivially copyable types can be uploaded to a buffer");
+
+  data(OGLWRAP_RangeSize(range) * sizeof(Element), OGLWRAP_RangeData(range),
+       usage);
 }
 #endif
 
@@ -39,19 +52,132 @@ template<BufferType BUFFER_TYPE>
 template<typename GLtype>
 void BufferObject<BUFFER_TYPE>::subData(GLintptr offset, GLsizei size,
                                         const GLtype* data) {
+#if OGLWRAP_USE_DSA
+  gl(NamedBufferSubData(buffer_, offset, size, data));
+#else
   OGLWRAP_CHECK_BINDING();
 
   gl(BufferSubData(GLenum(BUFFER_TYPE), offset, size, data));
+#endif
 }
 
 template<BufferType BUFFER_TYPE>
 template<typename GLtype>
 void BufferObject<BUFFER_TYPE>::subData(GLintptr offset,
                                         const std::vector<GLtype>& data) {
+  subData(offset, data.size() * sizeof(GLtype), data.data());
+}
+
+template<BufferType BUFFER_TYPE>
+template<typename ContiguousRange, typename>
+void BufferObject<BUFFER_TYPE>::subData(GLintptr offset,
+                                        const ContiguousRange& range) {
+  using Element = OGLWRAP_RangeElement<ContiguousRange>;
+  static_assert(std::is_trivially_copyable<Element>::value,
+                "Only trivially copyable types can be uploaded to a buffer");
+
+  subData(offset, OGLWRAP_RangeSize(range) * sizeof(Element),
+          OGLWRAP_RangeData(range));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::orphan(GLsizei size, BufferUsage usage) {
+  data(size, nullptr, usage);
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBufferData) \
+    && defined(glGetBufferParameteriv) && defined(GL_BUFFER_USAGE))
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::orphan() {
+  GLint size, usage;
+#if OGLWRAP_USE_DSA
+  gl(GetNamedBufferParameteriv(buffer_, GL_BUFFER_SIZE, &size));
+  gl(GetNamedBufferParameteriv(buffer_, GL_BUFFER_USAGE, &usage));
+#else
+  OGLWRAP_CHECK_BINDING();
+
+  gl(GetBufferParameteriv(GLenum(BUFFER_TYPE), GL_BUFFER_SIZE, &size));
+  gl(GetBufferParameteriv(GLenum(BUFFER_TYPE), GL_BUFFER_USAGE, &usage));
+#endif
+  data(size, nullptr, BufferUsage(usage));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateBufferData)
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::invalidate() {
+  gl(InvalidateBufferData(buffer_));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateBufferSubData)
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::invalidateRange(GLintptr offset,
+                                                GLsizeiptr length) {
+  gl(InvalidateBufferSubData(buffer_, offset, length));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferData)
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::clear() {
+  // A null data pointer fills the data store with zeros.
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedBufferData(buffer_, GL_R8, GL_RED, GL_UNSIGNED_BYTE, nullptr));
+#else
   OGLWRAP_CHECK_BINDING();
+  gl(ClearBufferData(GLenum(BUFFER_TYPE), GL_R8, GL_RED, GL_UNSIGNED_BYTE,
+                     nullptr));
+#endif
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferSubData)
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::clearRange(GLintptr offset, GLsizeiptr size) {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedBufferSubData(buffer_, GL_R8, offset, size, GL_RED,
+                             GL_UNSIGNED_BYTE, nullptr));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(ClearBufferSubData(GLenum(BUFFER_TYPE), GL_R8, offset, size, GL_RED,
+                        GL_UNSIGNED_BYTE, nullptr));
+#endif
+}
 
-  gl(BufferSubData(GLenum(BUFFER_TYPE), offset,
-                   data.size() * sizeof(GLtype), data.data()));
+template<BufferType BUFFER_TYPE>
+void BufferObject<BUFFER_TYPE>::fill(GLintptr offset, GLsizeiptr size,
+                                     GLuint value) {
+#if OGLWRAP_DEBUG
+  if (offset % 4 != 0 || size % 4 != 0) {
+    OGLWRAP_PRINT_ERROR("Unaligned buffer fill",
+      "BufferObject::fill requires the offset and the size to be multiples "
+      "of 4.");
+  }
+#endif
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedBufferSubData(buffer_, GL_R32UI, offset, size, GL_RED_INTEGER,
+                             GL_UNSIGNED_INT, &value));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(ClearBufferSubData(GLenum(BUFFER_TYPE), GL_R32UI, offset, size,
+                        GL_RED_INTEGER, GL_UNSIGNED_INT, &value));
+#endif
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBufferData) \
+    && defined(glCopyBufferSubData) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync))
+template<BufferType BUFFER_TYPE>
+BufferReadback BufferObject<BUFFER_TYPE>::readBack(GLintptr offset,
+                                                   GLsizeiptr size) const {
+  OGLWRAP_CHECK_BINDING();
+  return BufferReadback(BUFFER_TYPE, offset, size);
 }
 #endif
 
@@ -59,13 +185,61 @@ void BufferObject<BUFFER_TYPE>::subData(GLintptr offset,
     || (defined(glGetBufferParameteriv) && defined(GL_BUFFER_SIZE))
   template<BufferType BUFFER_TYPE>
   size_t BufferObject<BUFFER_TYPE>::size() const {
-    OGLWRAP_CHECK_BINDING();
     GLint size;
+#if OGLWRAP_USE_DSA
+    gl(GetNamedBufferParameteriv(buffer_, GL_BUFFER_SIZE, &size));
+#else
+    OGLWRAP_CHECK_BINDING();
     gl(GetBufferParameteriv(GLenum(BUFFER_TYPE), GL_BUFFER_SIZE, &size));
+#endif
     return size;
   }
 #endif  // glGetBufferParameteriv && GL_BUFFER_SIZE
 
+template<typename T, BufferType BUFFER_TYPE>
+BufferView<T, BUFFER_TYPE> BufferView<T, BUFFER_TYPE>::subView(
+    size_t first, size_t count) const {
+#if OGLWRAP_DEBUG
+  if (first + count > count_) {
+    OGLWRAP_PRINT_ERROR("BufferView out of range",
+      "BufferView::subView was called with a range that exceeds the view.");
+  }
+#endif
+  return BufferView(*buffer_, offset_ + first * sizeof(T), count);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferSubData)
+template<typename T, BufferType BUFFER_TYPE>
+template<typename ContiguousRange, typename>
+void BufferView<T, BUFFER_TYPE>::upload(const ContiguousRange& range,
+                                        size_t first) const {
+  using Element = OGLWRAP_RangeElement<ContiguousRange>;
+  static_assert(std::is_trivially_copyable<Element>::value,
+                "Only trivially copyable types can be uploaded to a buffer");
+  static_assert(sizeof(Element) == sizeof(T),
+                "The uploaded elements must have the same size as the "
+                "elements of the BufferView");
+
+  size_t count = OGLWRAP_RangeSize(range);
+#if OGLWRAP_DEBUG
+  if (first + count > count_) {
+    OGLWRAP_PRINT_ERROR("BufferView out of range",
+      "BufferView::upload was called with more elements than what fits "
+      "into the view.");
+    return;
+  }
+#endif
+#if OGLWRAP_USE_DSA
+  gl(NamedBufferSubData(buffer_->expose(), offset_ + first * sizeof(T),
+                        count * sizeof(T), OGLWRAP_RangeData(range)));
+#else
+  OGLWRAP_CHECK_BINDING_EXPLICIT(*buffer_);
+  gl(BufferSubData(GLenum(BUFFER_TYPE), offset_ + first * sizeof(T),
+                   count * sizeof(T), OGLWRAP_RangeData(range)));
+#endif
+}
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || (defined(glMapBuffer) \
      && defined(glUnmapBuffer) && defined(glMapBufferRange))
 
@@ -83,7 +257,7 @@ BufferObject<BUFFER_TYPE>::TypedMap<T>::TypedMap(
     GLintptr offset, GLsizeiptr length, Bitfield<BufferMapAccessFlags> access) {
   OGLWRAP_CHECK_FOR_DEFAULT_BINDING(GLenum(GetBindingTarget(BUFFER_TYPE)));
   data_ = gl(MapBufferRange(GLenum(BUFFER_TYPE), offset, length, access));
-  gl(GetBufferParameteriv(GLenum(BUFFER_TYPE), GL_BUFFER_SIZE, (GLint*)&size_));
+  size_ = length;
 }
 
 template<BufferType BUFFER_TYPE>
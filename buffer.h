@@ -8,6 +8,8 @@
 #define OGLWRAP_BUFFER_H_
 
 #include <vector>
+#include <cstddef>
+#include <type_traits>
 
 #include "enums/buffer_type.h"
 #include "enums/buffer_binding.h"
@@ -20,13 +22,54 @@
 #include "./config.h"
 #include "./globjects.h"
 #include "./bitfield.h"
+#include "./buffer_readback.h"
 
 #include "./define_internal_macros.h"
 
 namespace OGLWRAP_NAMESPACE_NAME {
 
+/// Returns a pointer to the first element of a built-in array.
+template<typename T, size_t N>
+const T* OGLWRAP_RangeData(const T (&range)[N]) {
+  return range;
+}
+
+/// Returns a pointer to the first element of a contiguous container, that
+/// is a type, whose data() returns a pointer, and that has a size().
+template<typename ContiguousRange>
+auto OGLWRAP_RangeData(const ContiguousRange& range)
+    -> typename std::enable_if<
+        std::is_pointer<decltype(range.data())>::value &&
+        std::is_integral<decltype(range.size())>::value,
+        decltype(range.data())>::type {
+  return range.data();
+}
+
+/// Returns the number of elements in a built-in array.
+template<typename T, size_t N>
+size_t OGLWRAP_RangeSize(const T (&)[N]) {
+  return N;
+}
+
+/// Returns the number of elements in a contiguous container.
+template<typename ContiguousRange>
+size_t OGLWRAP_RangeSize(const ContiguousRange& range) {
+  return range.size();
+}
+
+/// The element type of a contiguous range. Using it in a template's
+/// signature removes the overloads, that don't take a contiguous range
+/// (std::deque and std::list have iterators, but aren't contiguous).
+template<typename ContiguousRange>
+using OGLWRAP_RangeElement = typename std::remove_cv<
+    typename std::remove_pointer<decltype(OGLWRAP_RangeData(
+        std::declval<const ContiguousRange&>()))>::type>::type;
+
 #if OGLWRAP_DEFINE_EVERYTHING \
       || (defined(glGenBuffers) && defined(glDeleteBuffers))
+template<typename T, BufferType BUFFER_TYPE>
+class BufferView;
+
 template<BufferType BUFFER_TYPE>
 /// Buffer Objects are OpenGL data stores, arrays on the server memory.
 /** Buffer Objects are OpenGL Objects that store an array
@@ -68,6 +111,18 @@ class BufferObject {
     * @see glBufferData */
   void data(const std::vector<GLtype>& data,
             BufferUsage usage = BufferUsage::kStaticDraw);
+
+  template<typename ContiguousRange,
+           typename = OGLWRAP_RangeElement<ContiguousRange>>
+  /// Creates and initializes a buffer object's data store.
+  /** Uploads directly from the memory of the range, without copying it first.
+    * @param range - Specifies a contiguous range of trivially copyable
+    *                elements to upload, like an std::array, a C array, or any
+    *                span-like type with data() and size() members.
+    * @param usage - Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void data(const ContiguousRange& range,
+            BufferUsage usage = BufferUsage::kStaticDraw);
 #endif  // glBufferData
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferSubData)
@@ -93,8 +148,95 @@ class BufferObject {
     *                copied into the data store.
     * @see glBufferSubData */
   void subData(GLintptr offset, const std::vector<GLtype>& data);
+
+  template<typename ContiguousRange,
+           typename = OGLWRAP_RangeElement<ContiguousRange>>
+  /// Updates a subset of a buffer object's data store.
+  /** Uploads directly from the memory of the range, without copying it first.
+    * @param offset  Specifies the offset into the buffer object's data store
+    *                where data replacement will begin, measured in bytes.
+    * @param range   Specifies a contiguous range of trivially copyable
+    *                elements, that will be copied into the data store.
+    * @see glBufferSubData */
+  void subData(GLintptr offset, const ContiguousRange& range);
 #endif  // glBufferSubData
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+  /// Orphans the data store, and allocates a new one with the given size.
+  /** The driver can keep the old storage alive until the commands that use
+    * it finish, so the buffer can be rewritten without waiting for the GPU.
+    * The contents of the new data store are undefined.
+    * @param size    Specifies the size in bytes of the new data store.
+    * @param usage   Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void orphan(GLsizei size, BufferUsage usage = BufferUsage::kStreamDraw);
+#endif  // glBufferData
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBufferData) \
+    && defined(glGetBufferParameteriv) && defined(GL_BUFFER_USAGE))
+  /// Orphans the data store, and allocates a new one with the same size and usage.
+  /** @see glBufferData, glGetBufferParameteriv, GL_BUFFER_SIZE, GL_BUFFER_USAGE */
+  void orphan();
+#endif  // glBufferData && glGetBufferParameteriv && GL_BUFFER_USAGE
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateBufferData)
+  /// Tells the driver, that the contents of the data store are no longer needed.
+  /** Doesn't require the buffer to be bound.
+    * @see glInvalidateBufferData
+    * @version OpenGL 4.3 */
+  void invalidate();
+#endif  // glInvalidateBufferData
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateBufferSubData)
+  /// Tells the driver, that a range of the data store is no longer needed.
+  /** Doesn't require the buffer to be bound.
+    * @param offset  The offset of the range to be invalidated in bytes.
+    * @param length  The length of the range to be invalidated in bytes.
+    * @see glInvalidateBufferSubData
+    * @version OpenGL 4.3 */
+  void invalidateRange(GLintptr offset, GLsizeiptr length);
+#endif  // glInvalidateBufferSubData
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferData)
+  /// Fills the whole data store with zeros.
+  /** @see glClearBufferData
+    * @version OpenGL 4.3 */
+  void clear();
+#endif  // glClearBufferData
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferSubData)
+  /// Fills a range of the data store with zeros.
+  /** @param offset  The offset of the range to be cleared in bytes.
+    * @param size    The size of the range to be cleared in bytes.
+    * @see glClearBufferSubData
+    * @version OpenGL 4.3 */
+  void clearRange(GLintptr offset, GLsizeiptr size);
+
+  /// Fills a range of the data store with a repeated 32 bit unsigned integer.
+  /** @param offset  The offset of the range to be filled in bytes. Must be a
+    *                multiple of 4.
+    * @param size    The size of the range to be filled in bytes. Must be a
+    *                multiple of 4.
+    * @param value   The value to write.
+    * @see glClearBufferSubData
+    * @version OpenGL 4.3 */
+  void fill(GLintptr offset, GLsizeiptr size, GLuint value);
+#endif  // glClearBufferSubData
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBufferData) \
+    && defined(glCopyBufferSubData) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync))
+  /// Starts reading a range of the data store without stalling the pipeline.
+  /** The range is copied into a staging buffer on the GPU, that can be mapped
+    * after the copy finishes, unlike TypedMap, that waits for every pending
+    * command that writes the buffer.
+    * @param offset  The offset of the range to be read in bytes.
+    * @param size    The size of the range to be read in bytes.
+    * @see glCopyBufferSubData, glFenceSync, glMapBufferRange */
+  BufferReadback readBack(GLintptr offset, GLsizeiptr size) const;
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING \
     || (defined(glGetBufferParameteriv) && defined(GL_BUFFER_SIZE))
   /// A getter for the buffer's size.
@@ -104,6 +246,14 @@ class BufferObject {
   size_t size() const;
 #endif  // glGetBufferParameteriv && GL_BUFFER_SIZE
 
+  template<typename T>
+  /// Returns a typed view of a range of this buffer.
+  /** @param offset  The offset of the first element in bytes.
+    * @param count   The number of elements in the view. */
+  BufferView<T, BUFFER_TYPE> view(GLintptr offset, size_t count) const {
+    return BufferView<T, BUFFER_TYPE>(*this, offset, count);
+  }
+
   /// Returns the handle for the buffer.
   const glObject& expose() const { return buffer_; }
 
@@ -134,6 +284,25 @@ class BufferObject {
     /** @see glUnmapBuffer */
     ~TypedMap();
 
+    /// Access flags for rewriting the whole buffer each frame.
+    /** The previous contents are discarded, and the mapping doesn't wait for
+      * the commands using the buffer to finish, so the driver won't stall. */
+    static Bitfield<BufferMapAccessFlags> StreamWriteBuffer() {
+      return {BufferMapAccessFlags::kMapWriteBit,
+              BufferMapAccessFlags::kMapInvalidateBufferBit,
+              BufferMapAccessFlags::kMapUnsynchronizedBit};
+    }
+
+    /// Access flags for writing a range of the buffer, that isn't in use.
+    /** Only the contents of the mapped range are discarded. It is the caller's
+      * responsibility to not overwrite data that pending commands still use,
+      * for example by writing a ring buffer in round-robin order. */
+    static Bitfield<BufferMapAccessFlags> StreamWriteRange() {
+      return {BufferMapAccessFlags::kMapWriteBit,
+              BufferMapAccessFlags::kMapInvalidateRangeBit,
+              BufferMapAccessFlags::kMapUnsynchronizedBit};
+    }
+
     /// Returns the size of the mapped buffer in bytes
     size_t size() const { return size_; }
 
@@ -158,6 +327,80 @@ class BufferObject {
   globjects::Buffer buffer_;
 };
 
+template<typename T, BufferType BUFFER_TYPE>
+/// A typed range of a buffer object's data store.
+/** Refers to count elements of type T starting at a byte offset inside the
+  * buffer. The view doesn't own the buffer, so the buffer must outlive it. */
+class BufferView {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "BufferView can only refer to trivially copyable types");
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SHADER_STORAGE_BUFFER)
+  // The std430 layout is built of 4 byte basic machine units. Note that vec3s
+  // are 16 byte aligned in it, so structs containing them need manual padding.
+  static_assert(BUFFER_TYPE != BufferType::kShaderStorageBuffer
+                || sizeof(T) % 4 == 0,
+                "The size of a shader storage buffer element must be a "
+                "multiple of 4 bytes to match the std430 layout");
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_ATOMIC_COUNTER_BUFFER)
+  static_assert(BUFFER_TYPE != BufferType::kAtomicCounterBuffer
+                || std::is_same<T, GLuint>::value,
+                "Atomic counters are 32 bit unsigned integers");
+#endif
+
+ public:
+  /// The type of the elements of the view.
+  using value_type = T;
+
+  /// Creates a view of a range of the buffer.
+  /** @param buffer  The buffer that stores the elements.
+    * @param offset  The offset of the first element in bytes.
+    * @param count   The number of elements in the view. */
+  BufferView(const BufferObject<BUFFER_TYPE>& buffer,
+             GLintptr offset, size_t count)
+      : buffer_(&buffer), offset_(offset), count_(count) {}
+
+  /// Returns the buffer the view refers to.
+  const BufferObject<BUFFER_TYPE>& buffer() const { return *buffer_; }
+
+  /// Returns the offset of the first element in bytes.
+  GLintptr offset() const { return offset_; }
+
+  /// Returns the number of elements in the view.
+  size_t count() const { return count_; }
+
+  /// Returns the size of the viewed range in bytes.
+  GLsizeiptr byteSize() const { return count_ * sizeof(T); }
+
+  /// Returns the offset of the first element in the form that gl*Pointer and
+  /// glDraw*Elements* functions expect it.
+  const void* offsetPointer() const {
+    return reinterpret_cast<const void*>(offset_);
+  }
+
+  /// Returns a view of a subrange of this view.
+  /** @param first  The index of the first element of the subrange.
+    * @param count  The number of elements in the subrange. */
+  BufferView subView(size_t first, size_t count) const;
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferSubData)
+  template<typename ContiguousRange,
+           typename = OGLWRAP_RangeElement<ContiguousRange>>
+  /// Uploads elements to the viewed range.
+  /** The buffer should be bound. The element type of the range must have the
+    * same size as T.
+    * @param range  A contiguous range of the elements to be uploaded.
+    * @param first  The index of the first element to be overwritten.
+    * @see glBufferSubData */
+  void upload(const ContiguousRange& range, size_t first = 0) const;
+#endif  // glBufferSubData
+
+ private:
+  const BufferObject<BUFFER_TYPE>* buffer_;
+  GLintptr offset_;
+  size_t count_;
+};
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_ARRAY_BUFFER)
 /// A Buffer that stores vertex attribute data.
 /** The buffer will be used as a source for vertex data,
@@ -165,6 +408,10 @@ class BufferObject {
   * @see GL_ARRAY_BUFFER */
 using ArrayBuffer = BufferObject<BufferType::kArrayBuffer>;
 
+/// A typed range of an ArrayBuffer.
+template<typename T>
+using ArrayBufferView = BufferView<T, BufferType::kArrayBuffer>;
+
 #endif  // GL_ARRAY_BUFFER
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_ELEMENT_ARRAY_BUFFER)
@@ -177,6 +424,10 @@ using ArrayBuffer = BufferObject<BufferType::kArrayBuffer>;
   * @see GL_ELEMENT_ARRAY_BUFFER */
 using IndexBuffer = BufferObject<BufferType::kElementArrayBuffer>;
 
+/// A typed range of an IndexBuffer.
+template<typename T>
+using IndexBufferView = BufferView<T, BufferType::kElementArrayBuffer>;
+
 #endif  // GL_ELEMENT_ARRAY_BUFFER
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_BUFFER)
@@ -193,7 +444,23 @@ template<IndexedBufferType BUFFER_TYPE, GLuint index>
 /** Buffer Objects are OpenGL Objects that store an array
   * of unformatted memory allocated by the OpenGL context (aka: the GPU).
   * IndexBufferObject is a buffer that is bound to an indexed target. */
-class IndexedBufferObject : public BufferObject<BufferType(BUFFER_TYPE)> {};
+class IndexedBufferObject : public BufferObject<BufferType(BUFFER_TYPE)> {
+ public:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferSubData)
+  /// Sets consecutive atomic counters stored in the buffer to a value.
+  /** Can only be used with AtomicCounterBuffers.
+    * @param first  The index of the first counter to be reset.
+    * @param count  The number of counters to be reset.
+    * @param value  The new value of the counters.
+    * @see glClearBufferSubData
+    * @version OpenGL 4.3 */
+  void resetCounters(GLuint first = 0, GLuint count = 1, GLuint value = 0) {
+    static_assert(GLenum(BUFFER_TYPE) == GL_ATOMIC_COUNTER_BUFFER,
+                  "resetCounters can only be used with AtomicCounterBuffers");
+    this->fill(first * sizeof(GLuint), count * sizeof(GLuint), value);
+  }
+#endif  // glClearBufferSubData
+};
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNIFORM_BUFFER)
 /// An indexed buffer binding for buffers used as storage for uniform blocks.
@@ -209,6 +476,30 @@ template <GLuint index>
 using TransformFeedbackBuffer = IndexedBufferObject<IndexedBufferType::kTransformFeedbackBuffer, index>;
 #endif  // GL_TRANSFORM_FEEDBACK_BUFFER
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SHADER_STORAGE_BUFFER)
+/// An indexed buffer binding for buffers used as storage for shader storage
+/// blocks.
+/** Shaders can both read and write them, so a MemoryBarrier() is needed
+  * before the results of a shader are used.
+  * @see GL_SHADER_STORAGE_BUFFER */
+template <GLuint index>
+using ShaderStorageBuffer = IndexedBufferObject<IndexedBufferType::kShaderStorageBuffer, index>;
+
+/// A typed range of a ShaderStorageBuffer, with std430 compatible elements.
+template<typename T>
+using ShaderStorageBufferView = BufferView<T, BufferType::kShaderStorageBuffer>;
+#endif  // GL_SHADER_STORAGE_BUFFER
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_ATOMIC_COUNTER_BUFFER)
+/// An indexed buffer binding for buffers used as storage for atomic counters.
+/** @see GL_ATOMIC_COUNTER_BUFFER */
+template <GLuint index>
+using AtomicCounterBuffer = IndexedBufferObject<IndexedBufferType::kAtomicCounterBuffer, index>;
+
+/// A range of atomic counters in an AtomicCounterBuffer.
+using AtomicCounterBufferView = BufferView<GLuint, BufferType::kAtomicCounterBuffer>;
+#endif  // GL_ATOMIC_COUNTER_BUFFER
+
 #endif  // glBindBufferBase
 #endif  // glGenBuffers && glDeleteBuffers
 
@@ -0,0 +1,121 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_BUFFER_READBACK_INL_H_
+#define OGLWRAP_BUFFER_READBACK_INL_H_
+
+#include <utility>
+
+#include "./buffer_readback.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+    && defined(glDeleteBuffers) && defined(glBufferData) \
+    && defined(glCopyBufferSubData) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync))
+
+inline BufferReadback::BufferReadback(BufferType source, GLintptr offset,
+                                      GLsizeiptr size)
+    : size_(size) {
+  // The staging target must differ from the source target.
+  GLenum staging_target = source == BufferType::kCopyWriteBuffer ?
+      GL_COPY_READ_BUFFER : GL_COPY_WRITE_BUFFER;
+
+  gl(BindBuffer(staging_target, staging_));
+  gl(BufferData(staging_target, size, nullptr, GL_STREAM_READ));
+  gl(CopyBufferSubData(GLenum(source), staging_target, offset, 0, size));
+  gl(BindBuffer(staging_target, 0));
+
+  fence_.reset(new Sync{});
+}
+
+inline BufferReadback::BufferReadback(BufferReadback&& other) noexcept
+    : staging_(std::move(other.staging_)), fence_(std::move(other.fence_))
+    , mapped_(other.mapped_), size_(other.size_), flushed_(other.flushed_)
+    , failed_(other.failed_) {
+  other.mapped_ = nullptr;
+}
+
+inline BufferReadback& BufferReadback::operator=(BufferReadback&& other) {
+  if (this != &other) {
+    unmap();
+    staging_ = std::move(other.staging_);
+    fence_ = std::move(other.fence_);
+    mapped_ = other.mapped_;
+    size_ = other.size_;
+    flushed_ = other.flushed_;
+    failed_ = other.failed_;
+    other.mapped_ = nullptr;
+  }
+  return *this;
+}
+
+inline bool BufferReadback::finishWait(GLenum result) {
+  flushed_ = true;
+  if (result == GL_TIMEOUT_EXPIRED) {
+    return false;
+  }
+  // Anything else than a timeout is final: retrying a GL_WAIT_FAILED would
+  // fail again, so the fence is given up on.
+  fence_.reset();
+  failed_ = result != GL_ALREADY_SIGNALED &&
+            result != GL_CONDITION_SATISFIED;
+  return !failed_;
+}
+
+inline bool BufferReadback::ready() {
+  if (!fence_) {
+    return !failed_;
+  }
+  return finishWait(fence_->clientWaitStatus(0, !flushed_));
+}
+
+inline bool BufferReadback::wait(GLuint64 timeout) {
+  if (!fence_) {
+    return !failed_;
+  }
+  return finishWait(fence_->clientWaitStatus(timeout));
+}
+
+inline bool BufferReadback::wait() {
+  // glClientWaitSync has no infinite timeout, so wait in one second chunks.
+  while (!wait(1000000000)) {
+    if (failed_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline const void* BufferReadback::map() {
+  if (!mapped_) {
+    if (!wait()) {
+      return nullptr;
+    }
+    gl(BindBuffer(GL_COPY_READ_BUFFER, staging_));
+    mapped_ = gl(MapBufferRange(GL_COPY_READ_BUFFER, 0, size_,
+                                GL_MAP_READ_BIT));
+    gl(BindBuffer(GL_COPY_READ_BUFFER, 0));
+  }
+  return mapped_;
+}
+
+inline void BufferReadback::unmap() {
+  if (mapped_) {
+    gl(BindBuffer(GL_COPY_READ_BUFFER, staging_));
+    gl(UnmapBuffer(GL_COPY_READ_BUFFER));
+    gl(BindBuffer(GL_COPY_READ_BUFFER, 0));
+    mapped_ = nullptr;
+  }
+}
+
+#endif
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_BUFFER_READBACK_INL_H_
@@ -0,0 +1,115 @@
+// Copyright (c) Tamas Csala
+
+/** @file buffer_readback.h
+    @brief Implements asynchronous reading of buffer data.
+*/
+
+#ifndef OGLWRAP_BUFFER_READBACK_H_
+#define OGLWRAP_BUFFER_READBACK_H_
+
+#include <memory>
+
+#include "./config.h"
+#include "./globjects.h"
+#include "./sync.h"
+#include "enums/buffer_type.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+    && defined(glDeleteBuffers) && defined(glBufferData) \
+    && defined(glCopyBufferSubData) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync))
+/// The pending result of a BufferObject::readBack() call.
+/** The requested range is copied into a staging buffer on the GPU, and a fence
+  * is inserted after the copy. The data can be accessed through map() after the
+  * fence is signaled. Poll ready() each frame to avoid blocking the client.
+  * The staging buffer is bound to GL_COPY_READ_BUFFER or GL_COPY_WRITE_BUFFER
+  * temporarily, and those targets are left unbound.
+  * @see glCopyBufferSubData, glFenceSync */
+class BufferReadback {
+ public:
+  /// Starts copying a range of the buffer bound to a target.
+  /** Prefer BufferObject::readBack() instead of calling this directly.
+    * @param source  The target the source buffer is bound to.
+    * @param offset  The offset of the range to be read in bytes.
+    * @param size    The size of the range to be read in bytes. */
+  BufferReadback(BufferType source, GLintptr offset, GLsizeiptr size);
+
+  /// Moves a pending readback.
+  /** The mapping moves too, the moved-from readback doesn't unmap it. */
+  BufferReadback(BufferReadback&& other) noexcept;
+
+  /// Moves a pending readback.
+  /** The previous mapping of this readback is unmapped. */
+  BufferReadback& operator=(BufferReadback&& other);
+
+  /// Unmaps the staging buffer, if it's mapped.
+  ~BufferReadback() { unmap(); }
+
+  /// Returns true if the data can be mapped without blocking.
+  /** The first call flushes the command stream, so the fence surely becomes
+    * signaled eventually.
+    * @see glClientWaitSync */
+  bool ready();
+
+  /// Blocks until the copy finishes, or the timeout expires.
+  /** @param timeout  The maximum time to wait in nanoseconds.
+    * @return True if the copy has finished. False if the timeout expired, or
+    *         the wait failed (see failed()).
+    * @see glClientWaitSync */
+  bool wait(GLuint64 timeout);
+
+  /// Blocks until the copy finishes.
+  /** @return False if the wait failed, the data can't be mapped then.
+    * @see glClientWaitSync */
+  bool wait();
+
+  /// Returns true if glClientWaitSync has returned GL_WAIT_FAILED.
+  /** The fence can't become signaled anymore in this case. */
+  bool failed() const { return failed_; }
+
+  /// Returns a read-only pointer to the data.
+  /** Blocks if the copy hasn't finished yet. The staging buffer is mapped on the
+    * first call, and stays mapped until unmap() is called or the readback is
+    * destroyed. Returns nullptr if the wait or the mapping failed.
+    * @see glMapBufferRange */
+  const void* map();
+
+  template<typename T>
+  /// Returns the data as a read-only array of T.
+  /** @see map() */
+  const T* data() { return static_cast<const T*>(map()); }
+
+  /// Returns the number of Ts the data contains.
+  template<typename T>
+  size_t count() const { return size_ / sizeof(T); }
+
+  /// Unmaps the staging buffer. The pointers returned by map() become invalid.
+  /** @see glUnmapBuffer */
+  void unmap();
+
+  /// Returns the size of the data in bytes.
+  size_t size() const { return size_; }
+
+ private:
+  globjects::Buffer staging_;
+  std::unique_ptr<Sync> fence_;
+  const void* mapped_ = nullptr;
+  size_t size_;
+  bool flushed_ = false;
+  bool failed_ = false;
+
+  bool finishWait(GLenum result);
+};
+#endif
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./buffer_readback-inl.h"
+
+#endif  // OGLWRAP_BUFFER_READBACK_H_
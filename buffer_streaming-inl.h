@@ -0,0 +1,160 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_BUFFER_STREAMING_INL_H_
+#define OGLWRAP_BUFFER_STREAMING_INL_H_
+
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "./buffer_streaming.h"
+#include "debug/bind_checking.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+     && defined(glDeleteBuffers) && defined(glMapBufferRange) \
+     && defined(glUnmapBuffer))
+
+template<BufferType BUFFER_TYPE>
+void StreamToBuffer(const BufferObject<BUFFER_TYPE>& buffer,
+                    const MappedFile& file, GLintptr buffer_offset,
+                    size_t file_offset, size_t size, size_t chunk_size) {
+  OGLWRAP_CHECK_BINDING_EXPLICIT(buffer);
+
+  if (chunk_size == 0) {
+    throw std::invalid_argument("StreamToBuffer was called with a zero "
+                                "chunk size.");
+  }
+
+#if OGLWRAP_DEBUG
+  if (file_offset > file.size() || size > file.size() - file_offset) {
+    OGLWRAP_PRINT_ERROR("File range out of bounds",
+      "StreamToBuffer was called with a range, that doesn't fit into the "
+      "file.");
+    return;
+  }
+#endif
+
+  using Map = typename BufferObject<BUFFER_TYPE>::template TypedMap<GLubyte>;
+
+  file.adviseSequential();
+  for (size_t copied = 0; copied < size; copied += chunk_size) {
+    size_t current_chunk = std::min(chunk_size, size - copied);
+    {
+      // Only the mapped range is invalidated, the rest of the buffer is kept.
+      Map map(buffer_offset + copied, current_chunk,
+              {BufferMapAccessFlags::kMapWriteBit,
+               BufferMapAccessFlags::kMapInvalidateRangeBit});
+      if (!map.data()) {
+        return;
+      }
+      std::memcpy(map.data(), file.data() + file_offset + copied,
+                  current_chunk);
+    }
+    file.release(file_offset + copied, current_chunk);
+  }
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+template<BufferType BUFFER_TYPE>
+void LoadFileToBuffer(BufferObject<BUFFER_TYPE>& buffer,
+                      const std::string& path, BufferUsage usage,
+                      size_t chunk_size) {
+  MappedFile file(path);
+  if (file.size() > size_t(std::numeric_limits<GLsizeiptr>::max())) {
+    throw std::runtime_error("File '" + path + "' is too large to be loaded "
+                             "into a single buffer.");
+  }
+
+  // BufferObject::data takes a GLsizei, that would limit the file to 2 GiB.
+  // The data store is allocated with the full GLsizeiptr range instead, and
+  // filled chunk by chunk.
+  GLsizeiptr size = GLsizeiptr(file.size());
+#if OGLWRAP_USE_DSA
+  gl(NamedBufferData(buffer.expose(), size, nullptr, GLenum(usage)));
+#else
+  OGLWRAP_CHECK_BINDING_EXPLICIT(buffer);
+  gl(BufferData(GLenum(BUFFER_TYPE), size, nullptr, GLenum(usage)));
+#endif
+  StreamToBuffer(buffer, file, 0, 0, file.size(), chunk_size);
+}
+#endif  // glBufferData
+
+template<BufferType BUFFER_TYPE>
+AsyncBufferStream<BUFFER_TYPE>::AsyncBufferStream(
+    const BufferObject<BUFFER_TYPE>& buffer, MappedFile file,
+    GLintptr buffer_offset, size_t file_offset, size_t size,
+    size_t chunk_size)
+    : buffer_(&buffer), file_(std::move(file)), mapped_(nullptr)
+    , size_(size), copied_(0) {
+  OGLWRAP_CHECK_BINDING_EXPLICIT(buffer);
+
+  if (chunk_size == 0) {
+    // The worker would never finish, and the destructor would wait forever.
+    throw std::invalid_argument("AsyncBufferStream was created with a zero "
+                                "chunk size.");
+  }
+
+#if OGLWRAP_DEBUG
+  if (file_offset > file_.size() || size > file_.size() - file_offset) {
+    OGLWRAP_PRINT_ERROR("File range out of bounds",
+      "AsyncBufferStream was created with a range, that doesn't fit into the "
+      "file.");
+    size_ = 0;
+    finished_ = true;
+    return;
+  }
+#endif
+
+  Bitfield<BufferMapAccessFlags> access =
+      {BufferMapAccessFlags::kMapWriteBit,
+       BufferMapAccessFlags::kMapInvalidateRangeBit};
+  mapped_ = gl(MapBufferRange(GLenum(BUFFER_TYPE), buffer_offset, size,
+                              access));
+  if (!mapped_) {
+    size_ = 0;
+    finished_ = true;
+    unmap_result_ = false;
+    return;
+  }
+
+  // The worker only touches client memory, so it doesn't need a GL context.
+  worker_ = std::async(std::launch::async, [=]() {
+    GLubyte* dst = static_cast<GLubyte*>(mapped_);
+    const GLubyte* src = file_.data() + file_offset;
+    file_.adviseSequential();
+    for (size_t copied = 0; copied < size; copied += chunk_size) {
+      size_t current_chunk = std::min(chunk_size, size - copied);
+      std::memcpy(dst + copied, src + copied, current_chunk);
+      file_.release(file_offset + copied, current_chunk);
+      copied_ += current_chunk;
+    }
+  });
+}
+
+template<BufferType BUFFER_TYPE>
+bool AsyncBufferStream<BUFFER_TYPE>::finish() {
+  if (finished_) {
+    return unmap_result_;
+  }
+
+  worker_.wait();
+  file_.close();
+
+  OGLWRAP_CHECK_BINDING_EXPLICIT(*buffer_);
+  unmap_result_ = gl(UnmapBuffer(GLenum(BUFFER_TYPE)));
+  finished_ = true;
+  return unmap_result_;
+}
+
+#endif  // glGenBuffers && glDeleteBuffers && glMapBufferRange && glUnmapBuffer
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_BUFFER_STREAMING_INL_H_
@@ -0,0 +1,136 @@
+// Copyright (c) Tamas Csala
+
+/** @file buffer_streaming.h
+    @brief Implements uploading memory mapped files into buffers without
+           intermediate copies.
+*/
+
+#ifndef OGLWRAP_BUFFER_STREAMING_H_
+#define OGLWRAP_BUFFER_STREAMING_H_
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <cstddef>
+
+#include "./config.h"
+#include "./buffer.h"
+#include "./mapped_file.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The default size of the chunks, that the streaming functions copy at once.
+static const size_t kDefaultStreamChunkSize = size_t(4) << 20;
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenBuffers) \
+     && defined(glDeleteBuffers) && defined(glMapBufferRange) \
+     && defined(glUnmapBuffer))
+
+template<BufferType BUFFER_TYPE>
+/// Copies a range of a mapped file into a buffer chunk by chunk.
+/** Every chunk is copied straight from the file mapping into a mapped range of
+  * the buffer, and the pages of the file are released after they are copied,
+  * so neither the whole file, nor an intermediate copy of it is ever resident.
+  * The buffer should be bound, and its data store must be large enough.
+  * @param buffer         The destination buffer.
+  * @param file           The source file.
+  * @param buffer_offset  The offset of the destination range in bytes.
+  * @param file_offset    The offset of the source range in bytes.
+  * @param size           The number of bytes to copy.
+  * @param chunk_size     The number of bytes to copy with one mapping.
+  * @throw std::invalid_argument if chunk_size is zero.
+  * @see glMapBufferRange, glUnmapBuffer */
+void StreamToBuffer(const BufferObject<BUFFER_TYPE>& buffer,
+                    const MappedFile& file, GLintptr buffer_offset,
+                    size_t file_offset, size_t size,
+                    size_t chunk_size = kDefaultStreamChunkSize);
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+template<BufferType BUFFER_TYPE>
+/// Creates the data store of a buffer from a whole file.
+/** The buffer should be bound. The file can be larger than 2 GiB, it's
+  * copied in chunks of chunk_size bytes.
+  * @param buffer      The destination buffer.
+  * @param path        The path to the file.
+  * @param usage       Specifies the expected usage pattern of the data store.
+  * @param chunk_size  The number of bytes to copy with one mapping.
+  * @throw std::runtime_error if the file can't be opened or mapped, or if
+  *        it's larger than what a GLsizeiptr can address.
+  * @throw std::invalid_argument if chunk_size is zero.
+  * @see glBufferData, glMapBufferRange, glUnmapBuffer */
+void LoadFileToBuffer(BufferObject<BUFFER_TYPE>& buffer,
+                      const std::string& path,
+                      BufferUsage usage = BufferUsage::kStaticDraw,
+                      size_t chunk_size = kDefaultStreamChunkSize);
+#endif  // glBufferData
+
+template<BufferType BUFFER_TYPE>
+/// Copies a range of a mapped file into a buffer on a worker thread.
+/** The destination range is mapped once on the calling thread, and a worker
+  * thread copies the file into it, while the calling thread can keep
+  * rendering. Call finish() (on the thread of the GL context) to unmap the
+  * range before the buffer is used. The buffer must stay alive, and must not
+  * be used, mapped or reallocated until then.
+  * @see glMapBufferRange, glUnmapBuffer */
+class AsyncBufferStream {
+ public:
+  /// Maps the destination range, and starts copying into it.
+  /** The buffer should be bound.
+    * @param buffer         The destination buffer.
+    * @param file           The source file. It is owned by the stream until
+    *                       the copy finishes.
+    * @param buffer_offset  The offset of the destination range in bytes.
+    * @param file_offset    The offset of the source range in bytes.
+    * @param size           The number of bytes to copy.
+    * @param chunk_size     The number of bytes, after which the pages of the
+    *                       file are released.
+    * @throw std::invalid_argument if chunk_size is zero. */
+  AsyncBufferStream(const BufferObject<BUFFER_TYPE>& buffer, MappedFile file,
+                    GLintptr buffer_offset, size_t file_offset, size_t size,
+                    size_t chunk_size = kDefaultStreamChunkSize);
+
+  /// Waits for the copy, and unmaps the destination range.
+  ~AsyncBufferStream() { finish(); }
+
+  AsyncBufferStream(const AsyncBufferStream&) = delete;
+  AsyncBufferStream& operator=(const AsyncBufferStream&) = delete;
+
+  /// Returns true if the worker thread has finished copying.
+  bool ready() const { return copied_ == size_; }
+
+  /// Returns the number of bytes copied so far.
+  size_t bytesCopied() const { return copied_; }
+
+  /// Returns the number of bytes to copy.
+  size_t size() const { return size_; }
+
+  /// Waits for the worker thread, and unmaps the destination range.
+  /** The buffer should be bound. Calling it more than once is a no-op.
+    * @return False if the data store became corrupted while it was mapped
+    *         (this can happen for example on a screen mode change), and the
+    *         upload should be restarted.
+    * @see glUnmapBuffer */
+  bool finish();
+
+ private:
+  const BufferObject<BUFFER_TYPE>* buffer_;
+  MappedFile file_;
+  void* mapped_;
+  size_t size_;
+  std::atomic<size_t> copied_;
+  std::future<void> worker_;
+  bool finished_ = false;
+  bool unmap_result_ = true;
+};
+
+#endif  // glGenBuffers && glDeleteBuffers && glMapBufferRange && glUnmapBuffer
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./buffer_streaming-inl.h"
+
+#endif  // OGLWRAP_BUFFER_STREAMING_H_
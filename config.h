@@ -67,6 +67,18 @@
   #endif
 #endif
 
+/**
+ * @brief If true, objects are created with glCreate*, and modified through the
+ * direct state access functions (OpenGL 4.5 or ARB_direct_state_access), so
+ * they don't have to be bound to be modified.
+ *
+ * Only the functions that have a DSA counterpart stop requiring binding, for
+ * example mutable texture image uploads (glTexImage*) still use the binding.
+ */
+#ifndef OGLWRAP_USE_DSA
+  #define OGLWRAP_USE_DSA 0
+#endif
+
 /**
  * @brief If set to true, disables the oglwrap debug output.
  *
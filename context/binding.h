@@ -8,6 +8,7 @@
 #include "../framebuffer.h"
 #include "../transform_feedback.h"
 #include "../vertex_array.h"
+#include "../sampler.h"
 #include "../textures/texture_base.h"
 #include "../program.h"
 
@@ -62,6 +63,39 @@ void BindRange(const IndexedBufferObject<BUFFER_TYPE, index>& buffer,
                GLintptr offset, GLsizeiptr size) {
   gl(BindBufferRange(GLenum(BUFFER_TYPE), index, buffer.expose(), offset, size));
 }
+
+template<GLuint index, typename T, BufferType BUFFER_TYPE>
+/// Binds the range of a buffer view to the index-th binding point.
+/** The target is the one the view's buffer type belongs to, so it should be
+  * an indexed one, for example: gl::BindRange<2>(particles.view<Particle>(...))
+  * The offset of the view must respect the offset alignment of the target. */
+void BindRange(const BufferView<T, BUFFER_TYPE>& view) {
+#if OGLWRAP_DEBUG
+  GLint alignment = sizeof(GLuint);
+  switch (GLenum(BUFFER_TYPE)) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+    case GL_UNIFORM_BUFFER:
+      gl(GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+      break;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING \
+    || defined(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT)
+    case GL_SHADER_STORAGE_BUFFER:
+      gl(GetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment));
+      break;
+#endif
+    default:
+      break;
+  }
+  if (view.offset() % alignment != 0) {
+    OGLWRAP_PRINT_ERROR("Unaligned buffer range binding",
+      "BindRange was called with a buffer view, whose offset isn't a multiple "
+      "of the offset alignment of the target.");
+  }
+#endif
+  gl(BindBufferRange(GLenum(BUFFER_TYPE), index, view.buffer().expose(),
+                     view.offset(), view.byteSize()));
+}
 #endif
 
 template<IndexedBufferType BUFFER_TYPE, GLuint index>
@@ -260,6 +294,18 @@ TextureBase<TEXTURE_TYPE> GetCurrentlyBoundObject(const TextureBase<TEXTURE_TYPE
   return TextureBase<TEXTURE_TYPE>{GLuint(currently_bound_texture)};
 }
 
+// Sampler
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBindSampler) \
+    && defined(glGenSamplers) && defined(glDeleteSamplers))
+inline void BindToTexUnit(const Sampler& sampler, GLuint tex_unit) {
+  gl(BindSampler(tex_unit, sampler.expose()));
+}
+
+inline void UnbindFromTexUnit(const Sampler&, GLuint tex_unit) {
+  gl(BindSampler(tex_unit, 0));
+}
+#endif
+
 // Program
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glUseProgram)
 inline void Bind(const Program& prog) {
@@ -3,12 +3,17 @@
 #ifndef OGLWRAP_CONTEXT_BUFFER_CLEARING_H_
 #define OGLWRAP_CONTEXT_BUFFER_CLEARING_H_
 
+#include <vector>
+
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include "../config.h"
 #include "../bitfield.h"
 #include "../enums/buffer_select_bit.h"
+#include "../enums/framebuffer_type.h"
+#include "../enums/framebuffer_attachment.h"
 
 #include "../define_internal_macros.h"
 
@@ -92,6 +97,102 @@ inline ClearBuffers Clear() {
 	return ClearBuffers();
 }
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfv)
+/// Clears a color buffer of the bound draw framebuffer to a floating point
+/// value.
+/** Unlike Clear(), this doesn't touch the other buffers, and doesn't change
+  * the clear color.
+  * @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi), which
+  *                      isn't necessarily the index of the attachment.
+  * @param value - The value to clear to.
+  * @see glClearBufferfv */
+inline void ClearColorBuffer(GLint draw_buffer, const glm::vec4& value) {
+	gl(ClearBufferfv(GL_COLOR, draw_buffer, glm::value_ptr(value)));
+}
+
+/// Clears the depth buffer of the bound draw framebuffer.
+/** @param depth - The value to clear to.
+  * @see glClearBufferfv */
+inline void ClearDepthBuffer(GLfloat depth) {
+	gl(ClearBufferfv(GL_DEPTH, 0, &depth));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferiv)
+/// Clears a signed integer color buffer of the bound draw framebuffer.
+/** @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi).
+  * @param value - The value to clear to.
+  * @see glClearBufferiv */
+inline void ClearColorBuffer(GLint draw_buffer, const glm::ivec4& value) {
+	gl(ClearBufferiv(GL_COLOR, draw_buffer, glm::value_ptr(value)));
+}
+
+/// Clears the stencil buffer of the bound draw framebuffer.
+/** @param stencil - The value to clear to.
+  * @see glClearBufferiv */
+inline void ClearStencilBuffer(GLint stencil) {
+	gl(ClearBufferiv(GL_STENCIL, 0, &stencil));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferuiv)
+/// Clears an unsigned integer color buffer of the bound draw framebuffer.
+/** @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi).
+  * @param value - The value to clear to.
+  * @see glClearBufferuiv */
+inline void ClearColorBuffer(GLint draw_buffer, const glm::uvec4& value) {
+	gl(ClearBufferuiv(GL_COLOR, draw_buffer, glm::value_ptr(value)));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfi)
+/// Clears the depth and the stencil buffer of the bound draw framebuffer at
+/// once.
+/** @param depth - The depth value to clear to.
+  * @param stencil - The stencil value to clear to.
+  * @see glClearBufferfi */
+inline void ClearDepthStencilBuffer(GLfloat depth, GLint stencil) {
+	gl(ClearBufferfi(GL_DEPTH_STENCIL, 0, depth, stencil));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateFramebuffer)
+/// Tells the driver, that the contents of some attachments of the bound
+/// framebuffer aren't needed anymore.
+/** On tiled GPUs this saves writing them back to the memory at the end of
+  * the pass (or loading them at the beginning of the next one). Use kColor,
+  * kDepth and kStencil for the default framebuffer.
+  * @param target - The framebuffer target.
+  * @param attachments - The attachments, whose contents become undefined.
+  * @see glInvalidateFramebuffer */
+inline void InvalidateFramebuffer(
+		FramebufferType target,
+		const std::vector<FramebufferAttachment>& attachments) {
+	// FramebufferAttachment is stored as a GLenum.
+	gl(InvalidateFramebuffer(
+		GLenum(target), GLsizei(attachments.size()),
+		reinterpret_cast<const GLenum*>(attachments.data())));
+}
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateSubFramebuffer)
+/// Tells the driver, that the contents of a region of some attachments of
+/// the bound framebuffer aren't needed anymore.
+/** @param target - The framebuffer target.
+  * @param attachments - The attachments, whose contents become undefined.
+  * @param x, y, width, height - The region to invalidate.
+  * @see glInvalidateSubFramebuffer */
+inline void InvalidateSubFramebuffer(
+		FramebufferType target,
+		const std::vector<FramebufferAttachment>& attachments,
+		GLint x, GLint y, GLsizei width, GLsizei height) {
+	gl(InvalidateSubFramebuffer(
+		GLenum(target), GLsizei(attachments.size()),
+		reinterpret_cast<const GLenum*>(attachments.data()),
+		x, y, width, height));
+}
+#endif
+
 } // namespace oglwrap
 
 #include "../undefine_internal_macros.h"
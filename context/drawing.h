@@ -4,6 +4,7 @@
 #define OGLWRAP_CONTEXT_DRAWING_H_
 
 #include "../config.h"
+#include "../buffer.h"
 #include "../enums/index_type.h"
 #include "../enums/primitive_type.h"
 
@@ -1291,6 +1292,55 @@ inline void DrawElements<GLuint>(PrimType type, GLsizei count,
   gl(DrawElements(GLenum(type), count, GL_UNSIGNED_INT, indices));
 }
 
+#if OGLWRAP_DEFINE_EVERYTHING \
+      || (defined(glGenBuffers) && defined(glDeleteBuffers))
+template <typename GLtype>
+/**
+ * @brief Draws a sequence of primitives, in the order specified by a range of
+ *        the bound index buffer.
+ *
+ * The element type of the view selects the index type at compile time, and
+ * must be one of GLubyte, GLushort, or GLuint.
+ *
+ * @param type       Specifies what kind of primitives to render.
+ * @param indices    Specifies the range of the index buffer to be rendered.
+ *                   Its buffer must be bound to GL_ELEMENT_ARRAY_BUFFER.
+ * @see glDrawElements
+ * @version OpenGL 1.1
+ */
+inline void DrawElements(PrimType type,
+                         const IndexBufferView<GLtype>& indices) {
+  DrawElements(type, indices.count(),
+               static_cast<const GLtype*>(indices.offsetPointer()));
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glDrawElementsInstanced)
+template <typename GLtype>
+/**
+ * @brief Draws multiple instances of a sequence of primitives, in the order
+ *        specified by a range of the bound index buffer.
+ *
+ * The element type of the view selects the index type at compile time, and
+ * must be one of GLubyte, GLushort, or GLuint.
+ *
+ * @param type         Specifies what kind of primitives to render.
+ * @param indices      Specifies the range of the index buffer to be rendered.
+ *                     Its buffer must be bound to GL_ELEMENT_ARRAY_BUFFER.
+ * @param inst_count   Specifies the number of instances of the specified range
+ *                     of indices to be rendered.
+ * @see glDrawElementsInstanced
+ * @version OpenGL 3.1
+ */
+inline void DrawElementsInstanced(PrimType type,
+                                  const IndexBufferView<GLtype>& indices,
+                                  GLsizei inst_count) {
+  DrawElementsInstanced(type, indices.count(),
+                        static_cast<const GLtype*>(indices.offsetPointer()),
+                        inst_count);
+}
+#endif  // glDrawElementsInstanced
+#endif  // glGenBuffers && glDeleteBuffers
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glDrawElementsInstanced)
 template<>
 inline void DrawElementsInstanced<GLubyte>(PrimType type, GLsizei count,
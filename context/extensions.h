@@ -11,6 +11,12 @@
 namespace OGLWRAP_NAMESPACE_NAME {
 
 // See http://www.opengl.org/archives/resources/features/OGLextensions
+/// Returns true if the current context supports an extension.
+/** The extension string isn't available in core profile contexts, so the
+  * extensions are enumerated one by one with glGetStringi where it's
+  * available, and the string is only parsed on older contexts.
+  * @param extension - The name of the extension, like "GL_ARB_multi_bind".
+  * @see glGetStringi, glGetString, GL_NUM_EXTENSIONS */
 inline bool IsExtensionSupported(const char *extension) {
   const GLubyte *extensions = NULL;
   const GLubyte *start;
@@ -23,7 +29,23 @@ inline bool IsExtensionSupported(const char *extension) {
   if (where || *extension == '\0')
     return false;
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glGetStringi)
+  GLint extension_count = 0;
+  gl(GetIntegerv(GL_NUM_EXTENSIONS, &extension_count));
+  if (extension_count > 0) {
+    for (GLint i = 0; i < extension_count; ++i) {
+      const GLubyte* name = gl(GetStringi(GL_EXTENSIONS, i));
+      if (name && strcmp((const char *) name, extension) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+#endif
+
   extensions = gl(GetString(GL_EXTENSIONS));
+  if (!extensions)
+    return false;
 
   /* It takes a bit of care to be fool-proof about parsing the
      OpenGL extensions string. Don't be fooled by sub-strings,
@@ -7,7 +7,12 @@
 #ifndef OGLWRAP_CONTEXT_PIXEL_OPS_H_
 #define OGLWRAP_CONTEXT_PIXEL_OPS_H_
 
+#include <cmath>
+#include <vector>
+#include <utility>
+
 #include "../config.h"
+#include "../textures/pixel_size.h"
 #include "../enums/blit_filter.h"
 #include "../enums/pixel_data_type.h"
 #include "../enums/pixel_data_format.h"
@@ -18,6 +23,69 @@
 
 namespace OGLWRAP_NAMESPACE_NAME {
 
+/// Shadows the pixel storage parameters of the context.
+/** Redundant glPixelStore calls are skipped, and the parameters can be read
+  * without a glGet, that could stall the pipeline. A parameter, that wasn't
+  * set through oglwrap yet is queried on its first read. Call invalidate() if
+  * the parameters are changed without oglwrap, or the current context
+  * changes. */
+class PixelStoreState {
+ public:
+  /// Returns the shadowed state of the current context.
+  static PixelStoreState& Get() {
+    static PixelStoreState state;
+    return state;
+  }
+
+  /// Sets a parameter, unless it already has the given value.
+  /** @param parameter - The parameter to set.
+    * @param value - The new value of the parameter.
+    * @see glPixelStorei */
+  void set(PixelStorageMode parameter, GLint value) {
+    GLint* shadow = find(parameter);
+    if (shadow && *shadow == value) {
+      return;
+    }
+    gl(PixelStorei(GLenum(parameter), value));
+    if (shadow) {
+      *shadow = value;
+    } else {
+      values_.push_back(std::make_pair(GLenum(parameter), value));
+    }
+  }
+
+  /// Returns the value of a parameter.
+  /** @param parameter - The parameter to read.
+    * @see glGetIntegerv */
+  GLint get(PixelStorageMode parameter) {
+    GLint* shadow = find(parameter);
+    if (shadow) {
+      return *shadow;
+    }
+    GLint value = 0;
+    gl(GetIntegerv(GLenum(parameter), &value));
+    values_.push_back(std::make_pair(GLenum(parameter), value));
+    return value;
+  }
+
+  /// Forgets the value of every parameter.
+  void invalidate() { values_.clear(); }
+
+ private:
+  std::vector<std::pair<GLenum, GLint>> values_;
+
+  PixelStoreState() = default;
+
+  GLint* find(PixelStorageMode parameter) {
+    for (auto& value : values_) {
+      if (value.first == GLenum(parameter)) {
+        return &value.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
 /**
  * @brief set pixel storage modes
  * @param parameter Specifies the symbolic name of the parameter to be set.
@@ -26,7 +94,8 @@ namespace OGLWRAP_NAMESPACE_NAME {
  * @version OpenGL 1.0
  */
 inline void PixelStore(PixelStorageMode parameter, GLfloat value) {
-  gl(PixelStoref(GLenum(parameter), value));
+  // Every parameter is an integer or a boolean, glPixelStoref rounds too.
+  PixelStoreState::Get().set(parameter, GLint(std::lround(value)));
 }
 
 /**
@@ -37,9 +106,163 @@ inline void PixelStore(PixelStorageMode parameter, GLfloat value) {
  * @version OpenGL 1.0
  */
 inline void PixelStore(PixelStorageMode parameter, GLint value) {
-  gl(PixelStorei(GLenum(parameter), value));
+  PixelStoreState::Get().set(parameter, value);
+}
+
+/// Finds the row length and alignment pixel storage parameters, that make the
+/// rows of an image row_pitch bytes apart.
+/** @param row_pitch - The distance of the rows in bytes.
+  * @param format, type - The layout of the pixels.
+  * @param row_length - Returns the value of GL_(UN)PACK_ROW_LENGTH.
+  * @param alignment - Returns the value of GL_(UN)PACK_ALIGNMENT.
+  * @return False if the pitch can't be expressed with these parameters. */
+inline bool GetRowLengthAndAlignment(GLsizei row_pitch, PixelDataFormat format,
+                                     PixelDataType type, GLint* row_length,
+                                     GLint* alignment) {
+  GLsizei pixel_size = GetPixelSize(format, type);
+  GLsizei element_size = GetElementSize(type);
+  if (pixel_size == 0 || element_size == 0 || row_pitch < pixel_size) {
+    return false;
+  }
+
+  // The rows are padded to the alignment, unless the elements are larger.
+  GLint length = row_pitch / pixel_size;
+  for (GLint candidate = 8; candidate >= 1; candidate /= 2) {
+    GLsizei row_size = length * pixel_size;
+    if (element_size < candidate) {
+      row_size = (row_size + candidate - 1) / candidate * candidate;
+    }
+    if (row_size == row_pitch) {
+      *row_length = length;
+      *alignment = candidate;
+      return true;
+    }
+  }
+  return false;
 }
 
+/// Sets the pixel storage parameters, so that pixel transfers access a
+/// sub-rectangle of a larger client side image, and restores the previous
+/// values when it's destroyed.
+/** Use ScopedUnpackRegion for uploads, and ScopedPackRegion for readbacks. */
+class ScopedPixelRegion {
+ public:
+  ScopedPixelRegion(const ScopedPixelRegion&) = delete;
+  ScopedPixelRegion& operator=(const ScopedPixelRegion&) = delete;
+
+  /// Restores the previous values of the parameters.
+  ~ScopedPixelRegion() {
+    PixelStoreState& state = PixelStoreState::Get();
+    for (int i = 0; i < 4; ++i) {
+      state.set(parameters_[i], previous_[i]);
+    }
+  }
+
+  /// Returns false if the row pitch couldn't be expressed with the parameters.
+  /** In this case, the parameters describe a tightly packed image. */
+  bool valid() const { return valid_; }
+
+ protected:
+  ScopedPixelRegion(PixelStorageMode row_length, PixelStorageMode skip_pixels,
+                    PixelStorageMode skip_rows, PixelStorageMode alignment,
+                    GLsizei row_pitch, GLint x, GLint y,
+                    PixelDataFormat format, PixelDataType type)
+      : parameters_{row_length, skip_pixels, skip_rows, alignment} {
+    PixelStoreState& state = PixelStoreState::Get();
+    for (int i = 0; i < 4; ++i) {
+      previous_[i] = state.get(parameters_[i]);
+    }
+
+    GLint length = 0, align = 1;
+    valid_ = GetRowLengthAndAlignment(row_pitch, format, type, &length, &align);
+    if (!valid_) {
+      length = x = y = 0;
+      align = 1;
+    }
+    state.set(row_length, length);
+    state.set(skip_pixels, x);
+    state.set(skip_rows, y);
+    state.set(alignment, align);
+  }
+
+ private:
+  PixelStorageMode parameters_[4];
+  GLint previous_[4];
+  bool valid_;
+};
+
+/// Makes the uploads read a sub-rectangle of a larger client side image.
+/** Sets GL_UNPACK_ROW_LENGTH, GL_UNPACK_SKIP_PIXELS, GL_UNPACK_SKIP_ROWS and
+  * GL_UNPACK_ALIGNMENT while it's alive. The data pointer passed to the
+  * upload should point to the beginning of the whole image. */
+class ScopedUnpackRegion : public ScopedPixelRegion {
+ public:
+  /// Sets the unpack parameters.
+  /** @param row_pitch - The distance of the rows of the image in bytes.
+    * @param x, y - The position of the sub-rectangle in the image.
+    * @param format, type - The layout of the pixels. */
+  ScopedUnpackRegion(GLsizei row_pitch, GLint x, GLint y,
+                     PixelDataFormat format, PixelDataType type)
+      : ScopedPixelRegion(PixelStorageMode::kUnpackRowLength,
+                          PixelStorageMode::kUnpackSkipPixels,
+                          PixelStorageMode::kUnpackSkipRows,
+                          PixelStorageMode::kUnpackAlignment,
+                          row_pitch, x, y, format, type) {}
+};
+
+/// Makes the three-dimensional uploads read a box of a larger client side
+/// volume.
+/** Sets GL_UNPACK_IMAGE_HEIGHT and GL_UNPACK_SKIP_IMAGES too, besides the
+  * parameters set by ScopedUnpackRegion. */
+class ScopedUnpackVolumeRegion : public ScopedUnpackRegion {
+ public:
+  /// Sets the unpack parameters.
+  /** @param row_pitch - The distance of the rows of the volume in bytes.
+    * @param image_height - The number of rows of a slice of the volume.
+    * @param x, y, z - The position of the box in the volume.
+    * @param format, type - The layout of the pixels. */
+  ScopedUnpackVolumeRegion(GLsizei row_pitch, GLint image_height, GLint x,
+                           GLint y, GLint z, PixelDataFormat format,
+                           PixelDataType type)
+      : ScopedUnpackRegion(row_pitch, x, y, format, type) {
+    PixelStoreState& state = PixelStoreState::Get();
+    previous_image_height_ = state.get(PixelStorageMode::kUnpackImageHeight);
+    previous_skip_images_ = state.get(PixelStorageMode::kUnpackSkipImages);
+    state.set(PixelStorageMode::kUnpackImageHeight, valid() ? image_height : 0);
+    state.set(PixelStorageMode::kUnpackSkipImages, valid() ? z : 0);
+  }
+
+  /// Restores the previous values of the parameters.
+  ~ScopedUnpackVolumeRegion() {
+    PixelStoreState& state = PixelStoreState::Get();
+    state.set(PixelStorageMode::kUnpackImageHeight, previous_image_height_);
+    state.set(PixelStorageMode::kUnpackSkipImages, previous_skip_images_);
+  }
+
+ private:
+  GLint previous_image_height_;
+  GLint previous_skip_images_;
+};
+
+/// Makes the readbacks write a sub-rectangle of a larger client side image.
+/** Sets GL_PACK_ROW_LENGTH, GL_PACK_SKIP_PIXELS, GL_PACK_SKIP_ROWS and
+  * GL_PACK_ALIGNMENT while it's alive. The data pointer passed to the
+  * readback should point to the beginning of the whole image. */
+class ScopedPackRegion : public ScopedPixelRegion {
+ public:
+  /// Sets the pack parameters.
+  /** @param row_pitch - The distance of the rows of the image in bytes.
+    * @param x, y - The position of the sub-rectangle in the image.
+    * @param format, type - The layout of the pixels. */
+  ScopedPackRegion(GLsizei row_pitch, GLint x, GLint y,
+                   PixelDataFormat format, PixelDataType type)
+      : ScopedPixelRegion(PixelStorageMode::kPackRowLength,
+                          PixelStorageMode::kPackSkipPixels,
+                          PixelStorageMode::kPackSkipRows,
+                          PixelStorageMode::kPackAlignment,
+                          row_pitch, x, y, format, type) {}
+};
+
 /**
  * read a block of pixels from the frame buffer
  * @see <a href="https://www.opengl.org/wiki/GLAPI/glReadPixels">glReadPixels</a>
@@ -4,6 +4,8 @@
 #define OGLWRAP_CONTEXT_SYNCHRONIZATION_H_
 
 #include "../config.h"
+#include "../enums/buffer_type.h"
+#include "../enums/indexed_buffer_type.h"
 #include "../enums/memory_barrier_bit.h"
 
 #include "../define_internal_macros.h"
@@ -29,6 +31,61 @@ namespace OGLWRAP_NAMESPACE_NAME {
 inline void MemoryBarrier(Bitfield<MemoryBarrierBit> bits) {
   gl(MemoryBarrier(bits));
 }
+
+/**
+ * @brief Returns the barrier bit, that is needed before a buffer written by
+ *        shaders (through image stores, shader storage blocks, or atomic
+ *        counters) can be used as the given type.
+ *
+ * For example, if a compute shader writes particles to a buffer that is later
+ * used as an ArrayBuffer, call
+ * MemoryBarrier(GetMemoryBarrierBit(BufferType::kArrayBuffer)) between the
+ * dispatch and the draw call.
+ *
+ * @param type  The way the buffer is used after the shader writes it.
+ * @see glMemoryBarrier
+ */
+inline MemoryBarrierBit GetMemoryBarrierBit(BufferType type) {
+  switch (GLenum(type)) {
+    case GL_ARRAY_BUFFER:
+      return MemoryBarrierBit::kVertexAttribArrayBarrierBit;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return MemoryBarrierBit::kElementArrayBarrierBit;
+    case GL_UNIFORM_BUFFER:
+      return MemoryBarrierBit::kUniformBarrierBit;
+    case GL_TEXTURE_BUFFER:
+      return MemoryBarrierBit::kTextureFetchBarrierBit;
+    case GL_DRAW_INDIRECT_BUFFER:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DISPATCH_INDIRECT_BUFFER)
+    case GL_DISPATCH_INDIRECT_BUFFER:
+#endif
+      return MemoryBarrierBit::kCommandBarrierBit;
+    case GL_PIXEL_PACK_BUFFER:
+    case GL_PIXEL_UNPACK_BUFFER:
+      return MemoryBarrierBit::kPixelBufferBarrierBit;
+    case GL_TRANSFORM_FEEDBACK_BUFFER:
+      return MemoryBarrierBit::kTransformFeedbackBarrierBit;
+    case GL_ATOMIC_COUNTER_BUFFER:
+      return MemoryBarrierBit::kAtomicCounterBarrierBit;
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SHADER_STORAGE_BUFFER)
+    case GL_SHADER_STORAGE_BUFFER:
+      return MemoryBarrierBit::kShaderStorageBarrierBit;
+#endif
+    default:  // Copy targets and reads through mapping or glGetBufferSubData
+      return MemoryBarrierBit::kBufferUpdateBarrierBit;
+  }
+}
+
+/**
+ * @brief Returns the barrier bit, that is needed before a buffer written by
+ *        shaders can be used through the given indexed target.
+ *
+ * @param type  The way the buffer is used after the shader writes it.
+ * @see glMemoryBarrier
+ */
+inline MemoryBarrierBit GetMemoryBarrierBit(IndexedBufferType type) {
+  return GetMemoryBarrierBit(BufferType(type));
+}
 #endif
 
 /**
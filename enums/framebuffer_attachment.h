@@ -66,6 +66,15 @@ enum class FramebufferAttachment : GLenum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL_ATTACHMENT)
   kDepthStencilAttachment = GL_DEPTH_STENCIL_ATTACHMENT,
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR)
+  kColor = GL_COLOR,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH)
+  kDepth = GL_DEPTH,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL)
+  kStencil = GL_STENCIL,
+#endif
 };
 
 }  // namespace enums
@@ -15,6 +15,24 @@ enum class PixelDataInternalFormat : GLenum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL)
   kDepthStencil = GL_DEPTH_STENCIL,
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT16)
+  kDepthComponent16 = GL_DEPTH_COMPONENT16,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT24)
+  kDepthComponent24 = GL_DEPTH_COMPONENT24,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32)
+  kDepthComponent32 = GL_DEPTH_COMPONENT32,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32F)
+  kDepthComponent32F = GL_DEPTH_COMPONENT32F,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH24_STENCIL8)
+  kDepth24Stencil8 = GL_DEPTH24_STENCIL8,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH32F_STENCIL8)
+  kDepth32FStencil8 = GL_DEPTH32F_STENCIL8,
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RED)
   kRed = GL_RED,
 #endif
@@ -252,6 +270,36 @@ enum class PixelDataInternalFormat : GLenum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SIGNED_RG_RGTC2)
   kCompressedSignedRgRgtc2 = GL_COMPRESSED_SIGNED_RG_RGTC2,
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+  kCompressedRgbS3TcDxt1Ext = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+  kCompressedRgbaS3TcDxt1Ext = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+  kCompressedRgbaS3TcDxt3Ext = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+  kCompressedRgbaS3TcDxt5Ext = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT)
+  kCompressedSrgbS3TcDxt1Ext = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT)
+  kCompressedSrgbAlphaS3TcDxt1Ext = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT)
+  kCompressedSrgbAlphaS3TcDxt3Ext = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT)
+  kCompressedSrgbAlphaS3TcDxt5Ext = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+  kCompressedRgbaBptcUnorm = GL_COMPRESSED_RGBA_BPTC_UNORM,
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM)
+  kCompressedSrgbAlphaBptcUnorm = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+#endif
 };
 
 }  // namespace enums
@@ -16,19 +16,38 @@ namespace OGLWRAP_NAMESPACE_NAME {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glCheckFramebufferStatus)
 template<FramebufferType FBO_TYPE>
 FramebufferStatus FramebufferObject<FBO_TYPE>::status() const {
+#if OGLWRAP_USE_DSA
+  if (status_valid_) {
+    return status_;
+  }
+  GLenum status = gl(CheckNamedFramebufferStatus(framebuffer_,
+                                                 GLenum(FBO_TYPE)));
+  status_ = FramebufferStatus(status);
+  status_valid_ = true;
+  return status_;
+#else
+  // The query answers for the bound framebuffer, so the cache is only used,
+  // and only updated, when that's this one.
+  bool bound = IsBound(*this);
+  if (bound && status_valid_) {
+    return status_;
+  }
   OGLWRAP_CHECK_BINDING();
   GLenum status = gl(CheckFramebufferStatus(GLenum(FBO_TYPE)));
+  if (bound) {
+    status_ = FramebufferStatus(status);
+    status_valid_ = true;
+  }
   return FramebufferStatus(status);
+#endif
 }
 #endif  // glCheckFramebufferStatus
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glCheckFramebufferStatus)
 template<FramebufferType FBO_TYPE>
 void FramebufferObject<FBO_TYPE>::validate() const {
-  OGLWRAP_CHECK_BINDING();
   std::string error;
-  GLenum status = gl(CheckFramebufferStatus(GLenum(FBO_TYPE)));
-  switch (FramebufferStatus(status)) {
+  switch (status()) {
     case FramebufferStatus::kFramebufferComplete:
       return;
     case FramebufferStatus::kFramebufferIncompleteAttachment:
@@ -84,9 +103,15 @@ void FramebufferObject<FBO_TYPE>::validate() const {
 template<FramebufferType FBO_TYPE>
 void FramebufferObject<FBO_TYPE>::attachBuffer(
     FramebufferAttachment attachment, const Renderbuffer& render_buffer) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  gl(NamedFramebufferRenderbuffer(framebuffer_, GLenum(attachment),
+                                  GL_RENDERBUFFER, render_buffer.expose()));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferRenderbuffer(GLenum(FBO_TYPE), GLenum(attachment),
                              GL_RENDERBUFFER, render_buffer.expose()));
+#endif
 }
 #endif  // glFramebufferRenderbuffer
 
@@ -96,9 +121,15 @@ void FramebufferObject<FBO_TYPE>::attachTexture(
     FramebufferAttachment attachment,
     const Texture1D& texture,
     GLuint level) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  gl(NamedFramebufferTexture(framebuffer_, GLenum(attachment),
+                             texture.expose(), level));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferTexture1D(GLenum(FBO_TYPE), GLenum(attachment), GL_TEXTURE_1D,
                           texture.expose(), level));
+#endif
 }
 #endif  // glFramebufferTexture1D
 
@@ -109,9 +140,15 @@ void FramebufferObject<FBO_TYPE>::attachTexture(
     FramebufferAttachment attachment,
     const Texture2DBase<texture_t>& texture,
     GLint level) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  gl(NamedFramebufferTexture(framebuffer_, GLenum(attachment),
+                             texture.expose(), level));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferTexture2D(GLenum(FBO_TYPE), GLenum(attachment),
                           GLenum(texture_t), texture.expose(), level));
+#endif
 }
 #endif  // glFramebufferTexture2D
 
@@ -122,9 +159,17 @@ void FramebufferObject<FBO_TYPE>::attachTexture(
     TextureCubeTarget target,
     const TextureCube& texture,
     GLint level) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  // The faces of a cube map are its layers in the DSA functions.
+  gl(NamedFramebufferTextureLayer(
+      framebuffer_, GLenum(attachment), texture.expose(), level,
+      GLenum(target) - GL_TEXTURE_CUBE_MAP_POSITIVE_X));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferTexture2D(GLenum(FBO_TYPE), GLenum(attachment),
                           GLenum(target), texture.expose(), level));
+#endif
 }
 #endif  // glFramebufferTexture2D
 
@@ -133,9 +178,15 @@ template<FramebufferType FBO_TYPE>
 void FramebufferObject<FBO_TYPE>::attachTexture(
     FramebufferAttachment attachment, const Texture3D& texture,
     GLint level, GLint layer) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  gl(NamedFramebufferTextureLayer(framebuffer_, GLenum(attachment),
+                                  texture.expose(), level, layer));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferTexture3D(GLenum(FBO_TYPE), GLenum(attachment), GL_TEXTURE_3D,
                           texture.expose(), level, layer));
+#endif
 }
 #endif  // glFramebufferTexture3D
 
@@ -145,12 +196,138 @@ template <TextureType texture_t>
 void FramebufferObject<FBO_TYPE>::attachTextureLayer(
     FramebufferAttachment attachment, const TextureBase<texture_t>& texture,
     GLint level, GLint layer) {
+  status_valid_ = false;
+#if OGLWRAP_USE_DSA
+  gl(NamedFramebufferTextureLayer(framebuffer_, GLenum(attachment),
+                                  texture.expose(), level, layer));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(FramebufferTextureLayer(GLenum(FBO_TYPE), GLenum(attachment),
                              texture.expose(), level, layer));
+#endif
 }
 #endif  // glFramebufferTextureLayer
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfv)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearColor(GLint draw_buffer,
+                                             const glm::vec4& value) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferfv(framebuffer_, GL_COLOR, draw_buffer,
+                             glm::value_ptr(value)));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearColorBuffer(draw_buffer, value);
+#endif
+}
+
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearDepth(GLfloat depth) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferfv(framebuffer_, GL_DEPTH, 0, &depth));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearDepthBuffer(depth);
+#endif
+}
+#endif  // glClearBufferfv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferiv)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearColor(GLint draw_buffer,
+                                             const glm::ivec4& value) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferiv(framebuffer_, GL_COLOR, draw_buffer,
+                             glm::value_ptr(value)));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearColorBuffer(draw_buffer, value);
+#endif
+}
+
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearStencil(GLint stencil) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferiv(framebuffer_, GL_STENCIL, 0, &stencil));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearStencilBuffer(stencil);
+#endif
+}
+#endif  // glClearBufferiv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferuiv)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearColor(GLint draw_buffer,
+                                             const glm::uvec4& value) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferuiv(framebuffer_, GL_COLOR, draw_buffer,
+                              glm::value_ptr(value)));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearColorBuffer(draw_buffer, value);
+#endif
+}
+#endif  // glClearBufferuiv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfi)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::clearDepthStencil(GLfloat depth,
+                                                    GLint stencil) const {
+#if OGLWRAP_USE_DSA
+  gl(ClearNamedFramebufferfi(framebuffer_, GL_DEPTH_STENCIL, 0, depth,
+                             stencil));
+#else
+  OGLWRAP_CHECK_BINDING();
+  ClearDepthStencilBuffer(depth, stencil);
+#endif
+}
+#endif  // glClearBufferfi
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateFramebuffer)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::invalidate(
+    const std::vector<FramebufferAttachment>& attachments) const {
+#if OGLWRAP_USE_DSA
+  // FramebufferAttachment is stored as a GLenum.
+  gl(InvalidateNamedFramebufferData(
+      framebuffer_, GLsizei(attachments.size()),
+      reinterpret_cast<const GLenum*>(attachments.data())));
+#else
+  OGLWRAP_CHECK_BINDING();
+  InvalidateFramebuffer(FBO_TYPE, attachments);
+#endif
+}
+#endif  // glInvalidateFramebuffer
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateSubFramebuffer)
+template<FramebufferType FBO_TYPE>
+void FramebufferObject<FBO_TYPE>::invalidate(
+    const std::vector<FramebufferAttachment>& attachments,
+    GLint x, GLint y, GLsizei width, GLsizei height) const {
+#if OGLWRAP_USE_DSA
+  gl(InvalidateNamedFramebufferSubData(
+      framebuffer_, GLsizei(attachments.size()),
+      reinterpret_cast<const GLenum*>(attachments.data()),
+      x, y, width, height));
+#else
+  OGLWRAP_CHECK_BINDING();
+  InvalidateSubFramebuffer(FBO_TYPE, attachments, x, y, width, height);
+#endif
+}
+#endif  // glInvalidateSubFramebuffer
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBindFramebuffer) \
+    && defined(glCheckFramebufferStatus))
+template<FramebufferType FBO_TYPE>
+FramebufferObjectConfig<FBO_TYPE>::FramebufferObjectConfig(
+    const Setup& setup) {
+  Bind(framebuffer_);
+  setup(framebuffer_);
+  framebuffer_.validate();
+}
+#endif  // glBindFramebuffer && glCheckFramebufferStatus
+
 #endif  // glGenFramebuffers && glDeleteFramebuffers
 
 }  // namespace oglwrap
@@ -7,6 +7,9 @@
 #ifndef OGLWRAP_FRAMEBUFFER_H_
 #define OGLWRAP_FRAMEBUFFER_H_
 
+#include <vector>
+#include <functional>
+
 #include "./renderbuffer.h"
 #include "textures/texture_base.h"
 #include "textures/texture_1D.h"
@@ -18,6 +21,7 @@
 #include "enums/framebuffer_binding.h"
 #include "enums/framebuffer_status.h"
 #include "enums/framebuffer_attachment.h"
+#include "context/buffer_clearing.h"
 
 #include "./define_internal_macros.h"
 
@@ -43,13 +47,24 @@ class FramebufferObject {
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glCheckFramebufferStatus)
   /// Returns the status of a bound framebuffer.
-  /** @see glCheckFramebufferStatus */
+  /** The status is only queried after the attachments were changed, it is
+    * cached otherwise. Without DSA, the cache is only used while this
+    * framebuffer is bound, as the query answers for the bound one. Call
+    * invalidateStatus() if something changes it without the framebuffer
+    * knowing about it (for e.g. the storage of an attached texture is
+    * reallocated, or the draw buffers change).
+    * @see glCheckFramebufferStatus */
   FramebufferStatus status() const;
 #endif  // glCheckFramebufferStatus
 
+  /// Forgets the cached status, so the next status() call queries it again.
+  void invalidateStatus() { status_valid_ = false; }
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glCheckFramebufferStatus)
   /// Throws a logic error exception if the framebuffer isn't complete.
-  /** @see glCheckFramebufferStatus */
+  /** Uses the cached status, if the attachments didn't change since the last
+    * check.
+    * @see glCheckFramebufferStatus */
   void validate() const;
 #endif  // glCheckFramebufferStatus
 
@@ -119,17 +134,129 @@ class FramebufferObject {
                           GLint level, GLint layer);
 #endif  // glFramebufferTextureLayer
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfv)
+  /// Clears a color buffer of the framebuffer to a floating point value.
+  /** @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi).
+    * @param value - The value to clear to.
+    * @see glClearBufferfv, glClearNamedFramebufferfv */
+  void clearColor(GLint draw_buffer, const glm::vec4& value) const;
+
+  /// Clears the depth buffer of the framebuffer.
+  /** @param depth - The value to clear to.
+    * @see glClearBufferfv, glClearNamedFramebufferfv */
+  void clearDepth(GLfloat depth) const;
+#endif  // glClearBufferfv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferiv)
+  /// Clears a signed integer color buffer of the framebuffer.
+  /** @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi).
+    * @param value - The value to clear to.
+    * @see glClearBufferiv, glClearNamedFramebufferiv */
+  void clearColor(GLint draw_buffer, const glm::ivec4& value) const;
+
+  /// Clears the stencil buffer of the framebuffer.
+  /** @param stencil - The value to clear to.
+    * @see glClearBufferiv, glClearNamedFramebufferiv */
+  void clearStencil(GLint stencil) const;
+#endif  // glClearBufferiv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferuiv)
+  /// Clears an unsigned integer color buffer of the framebuffer.
+  /** @param draw_buffer - The index of the draw buffer (GL_DRAW_BUFFERi).
+    * @param value - The value to clear to.
+    * @see glClearBufferuiv, glClearNamedFramebufferuiv */
+  void clearColor(GLint draw_buffer, const glm::uvec4& value) const;
+#endif  // glClearBufferuiv
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glClearBufferfi)
+  /// Clears the depth and the stencil buffer of the framebuffer at once.
+  /** @param depth - The depth value to clear to.
+    * @param stencil - The stencil value to clear to.
+    * @see glClearBufferfi, glClearNamedFramebufferfi */
+  void clearDepthStencil(GLfloat depth, GLint stencil) const;
+#endif  // glClearBufferfi
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateFramebuffer)
+  /// Tells the driver, that the contents of some attachments aren't needed
+  /// anymore.
+  /** Call it at the end of a pass for the attachments, that aren't read
+    * later (like the depth buffer after the last pass, or a multisampled
+    * buffer after it is resolved), so tiled GPUs don't write them back.
+    * @param attachments - The attachments, whose contents become undefined.
+    * @see glInvalidateFramebuffer, glInvalidateNamedFramebufferData */
+  void invalidate(const std::vector<FramebufferAttachment>& attachments) const;
+#endif  // glInvalidateFramebuffer
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateSubFramebuffer)
+  /// Tells the driver, that the contents of a region of some attachments
+  /// aren't needed anymore.
+  /** @param attachments - The attachments, whose contents become undefined.
+    * @param x, y, width, height - The region to invalidate.
+    * @see glInvalidateSubFramebuffer, glInvalidateNamedFramebufferSubData */
+  void invalidate(const std::vector<FramebufferAttachment>& attachments,
+                  GLint x, GLint y, GLsizei width, GLsizei height) const;
+#endif  // glInvalidateSubFramebuffer
+
   /// Returns the handle for the framebuffer object.
   const glObject& expose() const { return framebuffer_; }
 
  private:
   globjects::Framebuffer framebuffer_;
+  mutable FramebufferStatus status_{};
+  mutable bool status_valid_ = false;
 };
 
 using Framebuffer     = FramebufferObject<FramebufferType::kFramebuffer>;
 using ReadFramebuffer = FramebufferObject<FramebufferType::kReadFramebuffer>;
 using DrawFramebuffer = FramebufferObject<FramebufferType::kDrawFramebuffer>;
 
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBindFramebuffer) \
+    && defined(glCheckFramebufferStatus))
+/// A framebuffer, whose attachments are set up, and validated only once, when
+/// it is created.
+/** The framebuffer can't be changed afterwards, so checking its completeness
+  * before a pass costs nothing. */
+template<FramebufferType FBO_TYPE>
+class FramebufferObjectConfig {
+ public:
+  /// The function, that attaches the images to the framebuffer.
+  using Setup = std::function<void(FramebufferObject<FBO_TYPE>&)>;
+
+  /// Creates the framebuffer, and validates it.
+  /** The framebuffer is bound while setup is called, and stays bound after
+    * the constructor returns. Throws a std::logic_error if the framebuffer
+    * isn't complete.
+    * @param setup - The function, that attaches the images.
+    * @see glCheckFramebufferStatus */
+  explicit FramebufferObjectConfig(const Setup& setup);
+
+  /// Moves a framebuffer config.
+  FramebufferObjectConfig(FramebufferObjectConfig&&) noexcept = default;
+
+  /// Moves a framebuffer config.
+  FramebufferObjectConfig& operator=(FramebufferObjectConfig&&) noexcept
+      = default;
+
+  /// Returns the validated framebuffer.
+  const FramebufferObject<FBO_TYPE>& framebuffer() const {
+    return framebuffer_;
+  }
+
+  /// Returns the handle for the framebuffer object.
+  const glObject& expose() const { return framebuffer_.expose(); }
+
+ private:
+  FramebufferObject<FBO_TYPE> framebuffer_;
+};
+
+using FramebufferConfig =
+    FramebufferObjectConfig<FramebufferType::kFramebuffer>;
+using ReadFramebufferConfig =
+    FramebufferObjectConfig<FramebufferType::kReadFramebuffer>;
+using DrawFramebufferConfig =
+    FramebufferObjectConfig<FramebufferType::kDrawFramebuffer>;
+#endif  // glBindFramebuffer && glCheckFramebufferStatus
+
 #endif  // glGenFramebuffers && glDeleteFramebuffers
 
 }  // namespace oglwrap
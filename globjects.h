@@ -114,7 +114,11 @@ namespace globjects {
     }
 
     Buffer() {
+#if OGLWRAP_USE_DSA
+      gl(CreateBuffers(1, &handle_));
+#else
       gl(GenBuffers(1, &handle_));
+#endif
       ownership_ = true;
     }
 
@@ -139,7 +143,11 @@ namespace globjects {
     }
 
     Renderbuffer() {
+#if OGLWRAP_USE_DSA
+      gl(CreateRenderbuffers(1, &handle_));
+#else
       gl(GenRenderbuffers(1, &handle_));
+#endif
       ownership_ = true;
     }
 
@@ -164,7 +172,11 @@ namespace globjects {
     }
 
     Framebuffer() {
+#if OGLWRAP_USE_DSA
+      gl(CreateFramebuffers(1, &handle_));
+#else
       gl(GenFramebuffers(1, &handle_));
+#endif
       ownership_ = true;
     }
 
@@ -189,7 +201,11 @@ namespace globjects {
     }
 
     TransformFeedback() {
+#if OGLWRAP_USE_DSA
+      gl(CreateTransformFeedbacks(1, &handle_));
+#else
       gl(GenTransformFeedbacks(1, &handle_));
+#endif
       ownership_ = true;
     }
 
@@ -214,7 +230,11 @@ namespace globjects {
     }
 
     VertexArray() {
+#if OGLWRAP_USE_DSA
+      gl(CreateVertexArrays(1, &handle_));
+#else
       gl(GenVertexArrays(1, &handle_));
+#endif
       ownership_ = true;
     }
 
@@ -229,6 +249,35 @@ namespace globjects {
   };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || \
+    (defined(glGenSamplers) && defined(glDeleteSamplers))
+  class Sampler : public glObject {
+   public:
+    explicit Sampler(GLuint handle) {
+      handle_ = handle;
+      ownership_ = false;
+    }
+
+    Sampler() {
+#if OGLWRAP_USE_DSA
+      gl(CreateSamplers(1, &handle_));
+#else
+      gl(GenSamplers(1, &handle_));
+#endif
+      ownership_ = true;
+    }
+
+    ~Sampler() {
+      if (ownership_) {
+        gl(DeleteSamplers(1, &handle_));
+      }
+    }
+
+    Sampler(Sampler&&) noexcept = default;
+    Sampler& operator=(Sampler&&) noexcept = default;
+  };
+#endif
+
 class Texture : public glObject {
  public:
   explicit Texture(GLuint handle) {
@@ -241,6 +290,20 @@ class Texture : public glObject {
     ownership_ = true;
   }
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glCreateTextures)
+  /// Creates a texture, that is bound to the given target on creation.
+  /** Unlike glGenTextures, the texture object is created immediately, so it
+    * can be modified through the direct state access functions without
+    * binding it first.
+    * @see glCreateTextures */
+  static Texture Create(GLenum target) {
+    Texture texture{0};
+    gl(CreateTextures(target, 1, &texture.handle_));
+    texture.ownership_ = true;
+    return texture;
+  }
+#endif
+
   ~Texture() {
     if (ownership_) {
       gl(DeleteTextures(1, &handle_));
@@ -0,0 +1,238 @@
+// Copyright (c) Tamas Csala
+
+/** @file mapped_file.h
+    @brief Implements read-only memory mapped files.
+*/
+
+#ifndef OGLWRAP_MAPPED_FILE_H_
+#define OGLWRAP_MAPPED_FILE_H_
+
+#include <string>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#include "./config.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// A file mapped into the address space of the process for reading.
+/** The pages of the file are only read from the disk when they are accessed,
+  * so uploading from a mapped file doesn't need an intermediate copy of the
+  * whole file in the memory. */
+class MappedFile {
+ public:
+  /// Creates an object, that doesn't map any file.
+  MappedFile() = default;
+
+  /// Maps a whole file.
+  /** @param path - The path to the file.
+    * @throw std::runtime_error if the file can't be opened or mapped. */
+  explicit MappedFile(const std::string& path) {
+    open(path);
+  }
+
+  /// Unmaps the file.
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// Moves a mapping.
+  MappedFile(MappedFile&& other) noexcept { swap(other); }
+
+  /// Moves a mapping.
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  /// Unmaps the previously mapped file (if any), and maps a new one.
+  /** @param path - The path to the file.
+    * @throw std::runtime_error if the file can't be opened or mapped. */
+  void open(const std::string& path);
+
+  /// Unmaps the file.
+  void close();
+
+  /// Tells the OS, that the file will be read sequentially.
+  /** This enables aggressive read-ahead, that makes streaming much faster. */
+  void adviseSequential() const;
+
+  /// Tells the OS, that a range of the file won't be read again.
+  /** The pages of the range are dropped from the working set, so streaming a
+    * file that is larger than the physical memory doesn't make the process
+    * use more and more memory.
+    * @param offset - The offset of the range in bytes.
+    * @param size - The size of the range in bytes. */
+  void release(size_t offset, size_t size) const;
+
+  /// Returns the contents of the file.
+  const unsigned char* data() const { return data_; }
+
+  /// Returns the size of the file in bytes.
+  size_t size() const { return size_; }
+
+  /// Returns true if a non-empty file is mapped.
+  bool isOpen() const { return data_ != nullptr; }
+
+  /// Swaps two mappings.
+  void swap(MappedFile& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  const unsigned char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+#ifdef _WIN32
+
+inline void MappedFile::open(const std::string& path) {
+  close();
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("File '" + path + "' couldn't be opened.");
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error("The size of '" + path + "' couldn't be read.");
+  }
+
+  if (file_size.QuadPart == 0) {
+    // Empty files can't be mapped, but they are valid.
+    CloseHandle(file);
+    size_ = 0;
+    return;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY,
+                                      0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) {
+    throw std::runtime_error("File '" + path + "' couldn't be mapped.");
+  }
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);  // The view keeps the mapping alive
+  if (!data) {
+    throw std::runtime_error("File '" + path + "' couldn't be mapped.");
+  }
+
+  data_ = static_cast<const unsigned char*>(data);
+  size_ = static_cast<size_t>(file_size.QuadPart);
+}
+
+inline void MappedFile::close() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+inline void MappedFile::adviseSequential() const {
+  // FILE_FLAG_SEQUENTIAL_SCAN is already specified on open.
+}
+
+inline void MappedFile::release(size_t offset, size_t size) const {
+  if (data_ && offset < size_) {
+    // Unlocking pages that aren't locked removes them from the working set.
+    VirtualUnlock(const_cast<unsigned char*>(data_) + offset,
+                  std::min(size, size_ - offset));
+  }
+}
+
+#else  // POSIX
+
+inline void MappedFile::open(const std::string& path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("File '" + path + "' couldn't be opened.");
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    ::close(fd);
+    throw std::runtime_error("The size of '" + path + "' couldn't be read.");
+  }
+
+  if (file_stat.st_size == 0) {
+    // Empty files can't be mapped, but they are valid.
+    ::close(fd);
+    size_ = 0;
+    return;
+  }
+
+  void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // The mapping keeps the file alive
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("File '" + path + "' couldn't be mapped.");
+  }
+
+  data_ = static_cast<const unsigned char*>(data);
+  size_ = static_cast<size_t>(file_stat.st_size);
+}
+
+inline void MappedFile::close() {
+  if (data_) {
+    munmap(const_cast<unsigned char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+inline void MappedFile::adviseSequential() const {
+  if (data_) {
+    madvise(const_cast<unsigned char*>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+inline void MappedFile::release(size_t offset, size_t size) const {
+  if (!data_ || offset >= size_) {
+    return;
+  }
+
+  // madvise only accepts page aligned addresses, so only the pages that are
+  // entirely inside the range are released.
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t end = offset + std::min(size, size_ - offset);
+  size_t begin = (offset + page_size - 1) / page_size * page_size;
+  if (end == size_) {
+    end = (end + page_size - 1) / page_size * page_size;
+  } else {
+    end = end / page_size * page_size;
+  }
+
+  if (begin < end) {
+    madvise(const_cast<unsigned char*>(data_) + begin, end - begin,
+            MADV_DONTNEED);
+  }
+}
+
+#endif  // _WIN32
+
+}  // namespace oglwrap
+
+#endif  // OGLWRAP_MAPPED_FILE_H_
@@ -0,0 +1,233 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_MULTISAMPLE_TARGET_INL_H_
+#define OGLWRAP_MULTISAMPLE_TARGET_INL_H_
+
+#include <algorithm>
+
+#include "./multisample_target.h"
+#include "context/binding.h"
+#include "context/pixel_ops.h"
+#include "context/buffer_clearing.h"
+#include "context/buffer_selection.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBlitFramebuffer) \
+    && defined(glRenderbufferStorageMultisample) && defined(glTexStorage2D) \
+    && defined(glDrawBuffers) && defined(glCheckFramebufferStatus))
+
+inline MultisampleTarget::MultisampleTarget(const MultisampleTargetDesc& desc)
+    : desc_(desc) {
+  for (PixelDataInternalFormat format : desc_.color_formats) {
+    colors_.emplace_back(new Renderbuffer());
+    Bind(*colors_.back());
+    colors_.back()->storageMultisample(desc_.samples, format,
+                                       desc_.width, desc_.height);
+
+    resolved_colors_.emplace_back(new Texture2D());
+    Texture2D& texture = *resolved_colors_.back();
+    Bind(texture);
+    texture.storage(1, format, desc_.width, desc_.height);
+    texture.minFilter(MinFilter::kLinear);
+    texture.magFilter(MagFilter::kLinear);
+    texture.wrapS(WrapMode::kClampToEdge);
+    texture.wrapT(WrapMode::kClampToEdge);
+  }
+
+  if (desc_.has_depth) {
+    depth_.reset(new Renderbuffer());
+    Bind(*depth_);
+    depth_->storageMultisample(desc_.samples, desc_.depth_format,
+                               desc_.width, desc_.height);
+
+    if (desc_.resolve_depth) {
+      resolved_depth_.reset(new Texture2D());
+      Bind(*resolved_depth_);
+      resolved_depth_->storage(1, desc_.depth_format, desc_.width,
+                               desc_.height);
+      resolved_depth_->minFilter(MinFilter::kNearest);
+      resolved_depth_->magFilter(MagFilter::kNearest);
+      resolved_depth_->wrapS(WrapMode::kClampToEdge);
+      resolved_depth_->wrapT(WrapMode::kClampToEdge);
+    }
+  }
+
+  msaa_.reset(new FramebufferConfig([this](Framebuffer& fbo) {
+    // By default, only the first color attachment is drawn to.
+    std::vector<ColorBuffer> draw_buffers;
+    for (size_t i = 0; i < colors_.size(); ++i) {
+      fbo.attachBuffer(FramebufferAttachment(GL_COLOR_ATTACHMENT0 + i),
+                       *colors_[i]);
+      draw_buffers.push_back(ColorBuffer(GL_COLOR_ATTACHMENT0 + i));
+    }
+    if (depth_) {
+      fbo.attachBuffer(depthAttachment(), *depth_);
+    }
+    if (draw_buffers.empty()) {
+      draw_buffers.push_back(ColorBuffer::kNone);
+    }
+    DrawBuffers(draw_buffers);
+  }));
+
+  resolve_.reset(new DrawFramebufferConfig([this](DrawFramebuffer& fbo) {
+    for (size_t i = 0; i < resolved_colors_.size(); ++i) {
+      fbo.attachTexture(FramebufferAttachment(GL_COLOR_ATTACHMENT0 + i),
+                        *resolved_colors_[i], 0);
+    }
+    if (resolved_depth_) {
+      fbo.attachTexture(depthAttachment(), *resolved_depth_, 0);
+    }
+    if (resolved_colors_.empty()) {
+      DrawBuffers({ColorBuffer::kNone});
+    }
+  }));
+}
+
+inline size_t MultisampleTarget::blitCount() const {
+  return std::max(colorCount(), resolved_depth_ ? size_t(1) : size_t(0));
+}
+
+inline void MultisampleTarget::resolve(bool invalidate) {
+  const Framebuffer& msaa = msaa_->framebuffer();
+  const DrawFramebuffer& resolve = resolve_->framebuffer();
+  Bind(msaa);  // as both the read and the draw framebuffer
+  Bind(resolve);
+
+  GLsizei w = desc_.width, h = desc_.height;
+  for (size_t i = 0; i < blitCount(); ++i) {
+    Bitfield<BufferSelectBit> mask;
+    if (i < colorCount()) {
+      // A blit reads a single color buffer, and writes every draw buffer.
+      ColorBuffer buffer = ColorBuffer(GL_COLOR_ATTACHMENT0 + i);
+      std::vector<ColorBuffer> draw_buffers(i + 1, ColorBuffer::kNone);
+      draw_buffers[i] = buffer;
+#if OGLWRAP_USE_DSA
+      gl(NamedFramebufferReadBuffer(msaa.expose(), GLenum(buffer)));
+      gl(NamedFramebufferDrawBuffers(
+          resolve.expose(), GLsizei(draw_buffers.size()),
+          reinterpret_cast<const GLenum*>(draw_buffers.data())));
+#else
+      ReadBuffer(buffer);
+      DrawBuffers(draw_buffers);
+#endif
+      mask |= BufferSelectBit::kColorBufferBit;
+    }
+    if (i == 0 && resolved_depth_) {
+      mask |= depthBits();
+    }
+    // The sizes match, so the filter only matters for the depth, that
+    // requires nearest.
+    BlitFramebuffer(0, 0, w, h, 0, 0, w, h, mask, BlitFilter::kNearest);
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateFramebuffer)
+  if (invalidate) {
+    std::vector<FramebufferAttachment> attachments;
+    for (size_t i = 0; i < colorCount(); ++i) {
+      attachments.push_back(FramebufferAttachment(GL_COLOR_ATTACHMENT0 + i));
+    }
+    if (depth_) {
+      attachments.push_back(depthAttachment());
+    }
+#if OGLWRAP_USE_DSA
+    msaa.invalidate(attachments);
+#else
+    InvalidateFramebuffer(FramebufferType::kReadFramebuffer, attachments);
+#endif
+  }
+#endif
+}
+
+inline FramebufferAttachment MultisampleTarget::depthAttachment() const {
+  GLenum format = GLenum(desc_.depth_format);
+  if (format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8 ||
+      format == GL_DEPTH_STENCIL) {
+    return FramebufferAttachment::kDepthStencilAttachment;
+  }
+  return FramebufferAttachment::kDepthAttachment;
+}
+
+inline Bitfield<BufferSelectBit> MultisampleTarget::depthBits() const {
+  Bitfield<BufferSelectBit> bits = BufferSelectBit::kDepthBufferBit;
+  if (depthAttachment() == FramebufferAttachment::kDepthStencilAttachment) {
+    bits |= BufferSelectBit::kStencilBufferBit;
+  }
+  return bits;
+}
+
+inline void MultisampleTargetPool::beginFrame() {
+  for (Entry& entry : entries_) {
+    entry.acquired = false;
+  }
+  acquired_count_ = 0;
+
+  ++frame_;
+  if (frame_ > max_unused_frames_) {
+    deleteUnused(frame_ - max_unused_frames_);
+  }
+}
+
+inline MultisampleTargetPool::Target MultisampleTargetPool::acquire(
+    const MultisampleTargetDesc& desc) {
+  Target target = entries_.size();
+  for (Target i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    if (!entry.acquired && entry.target && entry.target->desc() == desc) {
+      target = i;
+      break;
+    }
+  }
+
+  if (target == entries_.size()) {
+    if (!free_entries_.empty()) {
+      target = free_entries_.back();
+      free_entries_.pop_back();
+    } else {
+      entries_.emplace_back();
+    }
+    entries_[target].target.reset(new MultisampleTarget(desc));
+  }
+
+  Entry& entry = entries_[target];
+  entry.acquired = true;
+  entry.last_used = frame_;
+  ++acquired_count_;
+  return target;
+}
+
+inline void MultisampleTargetPool::release(Target target) {
+  Entry& entry = entries_[target];
+  if (entry.acquired) {
+    entry.acquired = false;
+    --acquired_count_;
+  }
+}
+
+inline void MultisampleTargetPool::resolve(const std::vector<Target>& targets,
+                                           bool invalidate) {
+  for (Target target : targets) {
+    entries_[target].target->resolve(invalidate);
+  }
+}
+
+inline void MultisampleTargetPool::deleteUnused(size_t min_frame) {
+  for (Target i = 0; i < entries_.size(); ++i) {
+    Entry& entry = entries_[i];
+    if (entry.target && !entry.acquired && entry.last_used < min_frame) {
+      entry.target.reset();
+      free_entries_.push_back(i);
+    }
+  }
+}
+
+#endif  // glBlitFramebuffer && glRenderbufferStorageMultisample &&
+        // glTexStorage2D && glDrawBuffers && glCheckFramebufferStatus
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_MULTISAMPLE_TARGET_INL_H_
@@ -0,0 +1,220 @@
+// Copyright (c) Tamas Csala
+
+/** @file multisample_target.h
+    @brief Implements multisampled render targets, that are resolved into
+           textures, and a pool of them.
+*/
+
+#ifndef OGLWRAP_MULTISAMPLE_TARGET_H_
+#define OGLWRAP_MULTISAMPLE_TARGET_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+#include "./config.h"
+#include "./bitfield.h"
+#include "./framebuffer.h"
+#include "enums/color_buffer.h"
+#include "enums/buffer_select_bit.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The description of a multisampled render target.
+struct MultisampleTargetDesc {
+  /// The size of the render target in pixels.
+  GLsizei width, height;
+
+  /// The number of samples.
+  GLsizei samples;
+
+  /// The sized internal formats of the color attachments.
+  std::vector<PixelDataInternalFormat> color_formats;
+
+  /// True if the render target has a depth (or depth-stencil) attachment.
+  bool has_depth;
+
+  /// The sized internal format of the depth attachment.
+  PixelDataInternalFormat depth_format;
+
+  /// True if the depth attachment is resolved too.
+  bool resolve_depth;
+
+  /// Creates a description.
+  MultisampleTargetDesc(GLsizei width, GLsizei height, GLsizei samples,
+                        const std::vector<PixelDataInternalFormat>&
+                            color_formats,
+                        bool has_depth = false,
+                        PixelDataInternalFormat depth_format =
+                            PixelDataInternalFormat::kDepthComponent24,
+                        bool resolve_depth = false)
+      : width(width), height(height), samples(samples)
+      , color_formats(color_formats), has_depth(has_depth)
+      , depth_format(depth_format), resolve_depth(resolve_depth) {}
+};
+
+inline bool operator==(const MultisampleTargetDesc& lhs,
+                       const MultisampleTargetDesc& rhs) {
+  return lhs.width == rhs.width && lhs.height == rhs.height &&
+         lhs.samples == rhs.samples && lhs.color_formats == rhs.color_formats &&
+         lhs.has_depth == rhs.has_depth &&
+         (!lhs.has_depth || (lhs.depth_format == rhs.depth_format &&
+                             lhs.resolve_depth == rhs.resolve_depth));
+}
+
+inline bool operator!=(const MultisampleTargetDesc& lhs,
+                       const MultisampleTargetDesc& rhs) {
+  return !(lhs == rhs);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glBlitFramebuffer) \
+    && defined(glRenderbufferStorageMultisample) && defined(glTexStorage2D) \
+    && defined(glDrawBuffers) && defined(glCheckFramebufferStatus))
+/// Multisampled renderbuffers paired with the textures they are resolved to.
+/** The scene is rendered into framebuffer(), which has every color
+  * attachment enabled as a draw buffer, and resolve() copies them into
+  * single sampled textures, that can be sampled afterwards. A blit only reads
+  * one color buffer, so the color attachments take one blit each (switching
+  * the read buffer and the draw buffer between them), and the depth buffer is
+  * resolved together with the first one. After the resolve, the multisampled
+  * storage is invalidated, so tiled GPUs don't write it back to the memory.
+  * Both framebuffers are validated only once, when they are created. */
+class MultisampleTarget {
+ public:
+  /// Allocates the renderbuffers and the textures.
+  /** Throws a std::logic_error if the framebuffers aren't complete.
+    * @param desc - The description of the render target.
+    * @see glRenderbufferStorageMultisample, glTexStorage2D */
+  explicit MultisampleTarget(const MultisampleTargetDesc& desc);
+
+  MultisampleTarget(const MultisampleTarget&) = delete;
+  MultisampleTarget& operator=(const MultisampleTarget&) = delete;
+
+  /// Returns the description of the render target.
+  const MultisampleTargetDesc& desc() const { return desc_; }
+
+  /// Returns the multisampled framebuffer, that should be rendered to.
+  const Framebuffer& framebuffer() const { return msaa_->framebuffer(); }
+
+  /// Returns the number of color attachments.
+  size_t colorCount() const { return resolved_colors_.size(); }
+
+  /// Returns the texture, that a color attachment is resolved to.
+  const Texture2D& resolvedColor(size_t index) const {
+    return *resolved_colors_[index];
+  }
+
+  /// Returns the texture, that the depth attachment is resolved to.
+  /** Only valid if the description had resolve_depth set. */
+  const Texture2D& resolvedDepth() const { return *resolved_depth_; }
+
+  /// Returns the number of blits resolve() makes.
+  size_t blitCount() const;
+
+  /// Resolves the multisampled attachments into the textures.
+  /** Leaves the multisampled framebuffer bound as the read framebuffer, and
+    * the resolve framebuffer as the draw framebuffer.
+    * @param invalidate - Invalidate the multisampled attachments after the
+    *                     resolve, because they aren't needed anymore.
+    * @see glBlitFramebuffer, glReadBuffer, glDrawBuffers,
+    *      glInvalidateFramebuffer */
+  void resolve(bool invalidate = true);
+
+ private:
+  MultisampleTargetDesc desc_;
+  std::vector<std::unique_ptr<Renderbuffer>> colors_;
+  std::unique_ptr<Renderbuffer> depth_;
+  std::vector<std::unique_ptr<Texture2D>> resolved_colors_;
+  std::unique_ptr<Texture2D> resolved_depth_;
+  std::unique_ptr<FramebufferConfig> msaa_;
+  std::unique_ptr<DrawFramebufferConfig> resolve_;
+
+  FramebufferAttachment depthAttachment() const;
+  Bitfield<BufferSelectBit> depthBits() const;
+};
+
+/// Hands out multisampled render targets, that are pooled by their
+/// description (size, sample count and formats).
+/** Works like RenderTargetPool: a released target is reused by a later
+  * acquire() with the same description, in the same frame or in the later
+  * ones, and the targets, that weren't used for a few frames are deleted. */
+class MultisampleTargetPool {
+ public:
+  /// The index of a render target in the pool.
+  using Target = size_t;
+
+  /// Creates an empty pool.
+  /** @param max_unused_frames - The number of frames a render target is kept
+    *                            without being used. */
+  explicit MultisampleTargetPool(size_t max_unused_frames = 2)
+      : max_unused_frames_(max_unused_frames) {}
+
+  MultisampleTargetPool(const MultisampleTargetPool&) = delete;
+  MultisampleTargetPool& operator=(const MultisampleTargetPool&) = delete;
+
+  /// Marks the beginning of a new frame.
+  /** Every render target acquired in the previous frame is released, and the
+    * ones, that weren't used in the last max_unused_frames frames are
+    * deleted. */
+  void beginFrame();
+
+  /// Acquires a render target, that isn't used by anything else.
+  /** @param desc - The description of the render target.
+    * @return The acquired render target, that is valid until it's released. */
+  Target acquire(const MultisampleTargetDesc& desc);
+
+  /// Releases a render target, so it can be acquired again.
+  void release(Target target);
+
+  /// Returns an acquired render target.
+  MultisampleTarget& target(Target target) {
+    return *entries_[target].target;
+  }
+
+  /// Returns an acquired render target.
+  const MultisampleTarget& target(Target target) const {
+    return *entries_[target].target;
+  }
+
+  /// Resolves several render targets.
+  /** @param targets - The render targets to resolve.
+    * @param invalidate - Invalidate the multisampled attachments after the
+    *                     resolve.
+    * @see MultisampleTarget::resolve */
+  void resolve(const std::vector<Target>& targets, bool invalidate = true);
+
+  /// Returns the number of render targets allocated by the pool.
+  size_t size() const { return entries_.size() - free_entries_.size(); }
+
+  /// Returns the number of acquired render targets.
+  size_t acquiredCount() const { return acquired_count_; }
+
+  /// Deletes every render target, that isn't acquired.
+  void clear() { deleteUnused(frame_ + 1); }
+
+ private:
+  struct Entry {
+    std::unique_ptr<MultisampleTarget> target;
+    bool acquired = false;
+    size_t last_used = 0;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<Target> free_entries_;
+  size_t max_unused_frames_;
+  size_t acquired_count_ = 0;
+  size_t frame_ = 1;
+
+  void deleteUnused(size_t min_frame);
+};
+#endif  // glBlitFramebuffer && glRenderbufferStorageMultisample &&
+        // glTexStorage2D && glDrawBuffers && glCheckFramebufferStatus
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./multisample_target-inl.h"
+
+#endif  // OGLWRAP_MULTISAMPLE_TARGET_H_
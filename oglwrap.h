@@ -35,6 +35,20 @@
   #include "./texture.h"
   #include "./framebuffer.h"
   #include "./transform_feedback.h"
+  #include "./shadow_buffer.h"
+  #include "./buffer_streaming.h"
+  #include "./asset_pack.h"
+  #include "./texture_units.h"
+  #include "./bindless_textures.h"
+  #include "textures/texture_atlas.h"
+  #include "textures/mipmap_generator.h"
+  #include "textures/block_compression.h"
+  #include "textures/streaming_texture.h"
+  #include "textures/bricked_volume.h"
+  #include "textures/video_texture.h"
+  #include "./render_target_pool.h"
+  #include "./render_graph.h"
+  #include "./multisample_target.h"
   #include "shapes/cube_shape.h"
   #include "shapes/sphere_shape.h"
   #include "shapes/rectangle_shape.h"
@@ -0,0 +1,373 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_RENDER_GRAPH_INL_H_
+#define OGLWRAP_RENDER_GRAPH_INL_H_
+
+#include <queue>
+#include <algorithm>
+#include <stdexcept>
+
+#include "./render_graph.h"
+#include "context/binding.h"
+#include "context/viewport_ops.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenFramebuffers) \
+    && defined(glFramebufferTexture2D) && defined(glFramebufferRenderbuffer) \
+    && defined(glTexStorage2D) && defined(glRenderbufferStorageMultisample))
+
+inline void RenderGraph::clear() {
+  resources_.clear();
+  passes_.clear();
+  order_.clear();
+  compiled_ = false;
+}
+
+inline RenderGraph::Resource RenderGraph::createRenderTarget(
+    const RenderTargetDesc& desc) {
+  ResourceNode node;
+  node.transient = true;
+  node.desc = desc;
+  resources_.push_back(node);
+  compiled_ = false;
+  return resources_.size() - 1;
+}
+
+inline RenderGraph::Resource RenderGraph::importResource(bool buffer,
+                                                         GLuint name) {
+  for (Resource i = 0; i < resources_.size(); ++i) {
+    const ResourceNode& node = resources_[i];
+    if (node.imported && node.imported_buffer == buffer &&
+        node.imported_name == name) {
+      return i;
+    }
+  }
+
+  ResourceNode node;
+  node.imported = true;
+  node.imported_buffer = buffer;
+  node.imported_name = name;
+  resources_.push_back(node);
+  compiled_ = false;
+  return resources_.size() - 1;
+}
+
+inline RenderGraph::Pass RenderGraph::addPass(const std::string& name,
+                                              Callback callback,
+                                              bool side_effects) {
+  PassNode node;
+  node.name = name;
+  node.callback = std::move(callback);
+  node.side_effects = side_effects;
+  passes_.push_back(std::move(node));
+  compiled_ = false;
+  return passes_.size() - 1;
+}
+
+inline void RenderGraph::read(Pass pass, Resource resource,
+                              ResourceAccess access) {
+  addUse(pass, resource, access, false);
+}
+
+inline void RenderGraph::write(Pass pass, Resource resource,
+                               ResourceAccess access) {
+  addUse(pass, resource, access, true);
+}
+
+inline void RenderGraph::attach(Pass pass, FramebufferAttachment attachment,
+                                Resource resource) {
+  GLenum point = GLenum(attachment);
+  bool depth_stencil = point == GL_DEPTH_ATTACHMENT ||
+                       point == GL_STENCIL_ATTACHMENT ||
+                       point == GL_DEPTH_STENCIL_ATTACHMENT;
+  addUse(pass, resource, depth_stencil ? ResourceAccess::kDepthStencilAttachment
+                                       : ResourceAccess::kColorAttachment,
+         true);
+  passes_[pass].attachments.push_back(std::make_pair(attachment, resource));
+}
+
+inline void RenderGraph::addUse(Pass pass, Resource resource,
+                                ResourceAccess access, bool write) {
+  passes_[pass].uses.push_back(Use{resource, access, write});
+
+  ResourceNode& node = resources_[resource];
+  std::vector<Pass>& writers = node.writers;
+  std::vector<Pass>& readers = node.readers;
+  bool is_writer = std::find(writers.begin(), writers.end(), pass) !=
+                   writers.end();
+  if (write && !is_writer) {
+    // The writers run in the order the passes were added.
+    writers.insert(std::upper_bound(writers.begin(), writers.end(), pass),
+                   pass);
+    readers.erase(std::remove(readers.begin(), readers.end(), pass),
+                  readers.end());
+  } else if (!write && !is_writer &&
+             std::find(readers.begin(), readers.end(), pass) == readers.end()) {
+    readers.push_back(pass);
+  }
+  compiled_ = false;
+}
+
+inline bool RenderGraph::accesses(Pass pass, Resource resource,
+                                  bool write) const {
+  for (const Use& use : passes_[pass].uses) {
+    if (use.resource == resource && use.write == write) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline size_t RenderGraph::liveWritersBegin(Resource resource,
+                                            size_t end) const {
+  // Everything before the last writer, that overwrites the resource is dead.
+  const std::vector<Pass>& writers = resources_[resource].writers;
+  for (size_t i = end; i > 0; --i) {
+    if (!accesses(writers[i-1], resource, false)) {
+      return i-1;
+    }
+  }
+  return 0;
+}
+
+inline void RenderGraph::compile() {
+  cull();
+  sort();
+  computeLifetimes();
+  compiled_ = true;
+}
+
+inline void RenderGraph::cull() {
+  std::vector<Pass> needed;
+  for (Pass i = 0; i < passes_.size(); ++i) {
+    passes_[i].culled = true;
+    if (passes_[i].side_effects) {
+      needed.push_back(i);
+    }
+  }
+  for (Resource i = 0; i < resources_.size(); ++i) {
+    const ResourceNode& node = resources_[i];
+    if (node.imported || node.output) {
+      size_t end = node.writers.size();
+      for (size_t j = liveWritersBegin(i, end); j < end; ++j) {
+        needed.push_back(node.writers[j]);
+      }
+    }
+  }
+
+  while (!needed.empty()) {
+    Pass pass = needed.back();
+    needed.pop_back();
+    if (!passes_[pass].culled) {
+      continue;
+    }
+    passes_[pass].culled = false;
+
+    // The pass needs the writers of the versions it reads.
+    for (const Use& use : passes_[pass].uses) {
+      if (use.write) {
+        continue;
+      }
+      const std::vector<Pass>& writers = resources_[use.resource].writers;
+      size_t end = std::find(writers.begin(), writers.end(), pass) -
+                   writers.begin();
+      for (size_t j = liveWritersBegin(use.resource, end); j < end; ++j) {
+        needed.push_back(writers[j]);
+      }
+    }
+  }
+}
+
+inline void RenderGraph::sort() {
+  std::vector<std::vector<Pass>> dependents(passes_.size());
+  std::vector<size_t> dependency_count(passes_.size(), 0);
+  auto add_edge = [&](Pass from, Pass to) {
+    dependents[from].push_back(to);
+    ++dependency_count[to];
+  };
+
+  for (const ResourceNode& node : resources_) {
+    Pass last_writer = passes_.size();
+    for (Pass writer : node.writers) {
+      if (passes_[writer].culled) {
+        continue;
+      }
+      if (last_writer != passes_.size()) {
+        add_edge(last_writer, writer);
+      }
+      last_writer = writer;
+    }
+    if (last_writer == passes_.size()) {
+      continue;
+    }
+    for (Pass reader : node.readers) {
+      if (!passes_[reader].culled) {
+        add_edge(last_writer, reader);
+      }
+    }
+  }
+
+  // Out of the passes, that can run, the one added first goes first.
+  std::priority_queue<Pass, std::vector<Pass>, std::greater<Pass>> ready;
+  size_t surviving = 0;
+  for (Pass i = 0; i < passes_.size(); ++i) {
+    if (!passes_[i].culled) {
+      ++surviving;
+      if (dependency_count[i] == 0) {
+        ready.push(i);
+      }
+    }
+  }
+
+  order_.clear();
+  while (!ready.empty()) {
+    Pass pass = ready.top();
+    ready.pop();
+    order_.push_back(pass);
+    for (Pass dependent : dependents[pass]) {
+      if (--dependency_count[dependent] == 0) {
+        ready.push(dependent);
+      }
+    }
+  }
+
+  if (order_.size() != surviving) {
+    throw std::logic_error("The passes of the render graph depend on each "
+                           "other in a cycle.");
+  }
+}
+
+inline void RenderGraph::computeLifetimes() {
+  for (ResourceNode& node : resources_) {
+    node.used = false;
+  }
+  for (size_t position = 0; position < order_.size(); ++position) {
+    for (const Use& use : passes_[order_[position]].uses) {
+      ResourceNode& node = resources_[use.resource];
+      if (!node.used) {
+        node.used = true;
+        node.first_use = position;
+      }
+      node.last_use = position;
+    }
+  }
+}
+
+inline void RenderGraph::execute() {
+  if (!compiled_) {
+    compile();
+  }
+
+  for (ResourceNode& node : resources_) {
+    node.last_incoherent_write = -1;
+  }
+  barrier_count_ = 0;
+
+  // The position of the last barrier, that included a bit.
+  int barrier_positions[32];
+  std::fill(barrier_positions, barrier_positions + 32, -1);
+
+  for (size_t position = 0; position < order_.size(); ++position) {
+    const PassNode& pass = passes_[order_[position]];
+
+    for (const Use& use : pass.uses) {
+      ResourceNode& node = resources_[use.resource];
+      if (node.transient && !node.acquired) {
+        node.target = pool_.acquire(node.desc);
+        node.acquired = true;
+      }
+    }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glMemoryBarrier)
+    GLbitfield bits = 0;
+    for (const Use& use : pass.uses) {
+      const ResourceNode& node = resources_[use.resource];
+      if (node.last_incoherent_write < 0) {
+        continue;
+      }
+      GLbitfield bit = GLbitfield(GetMemoryBarrierBit(use.access));
+      for (int i = 0; i < 32; ++i) {
+        if ((bit & (1u << i)) &&
+            barrier_positions[i] <= node.last_incoherent_write) {
+          bits |= bit;
+        }
+      }
+    }
+    if (bits) {
+      MemoryBarrier(bits);
+      ++barrier_count_;
+      for (int i = 0; i < 32; ++i) {
+        if (bits & (1u << i)) {
+          barrier_positions[i] = int(position);
+        }
+      }
+    }
+#endif
+
+    const Framebuffer* framebuffer = nullptr;
+    if (!pass.attachments.empty()) {
+      std::vector<RenderTargetPool::Attachment> attachments;
+      for (const auto& attachment : pass.attachments) {
+        attachments.push_back(RenderTargetPool::Attachment{
+            attachment.first, resources_[attachment.second].target});
+      }
+      framebuffer = &pool_.framebuffer(attachments);
+      const RenderTargetDesc& desc = resources_[pass.attachments[0].second].desc;
+      Viewport(desc.width, desc.height);
+    }
+
+    if (pass.callback) {
+      pass.callback(*this);
+    }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glInvalidateFramebuffer)
+    // Nothing reads the attachments, that die with this pass, so tiled GPUs
+    // shouldn't write them back.
+    std::vector<FramebufferAttachment> dead_attachments;
+    for (const auto& attachment : pass.attachments) {
+      const ResourceNode& node = resources_[attachment.second];
+      if (!node.output && node.last_use == position) {
+        dead_attachments.push_back(attachment.first);
+      }
+    }
+    if (!dead_attachments.empty()) {
+      Bind(*framebuffer);
+      framebuffer->invalidate(dead_attachments);
+    }
+#endif
+
+    for (const Use& use : pass.uses) {
+      ResourceNode& node = resources_[use.resource];
+      if (use.write && IsIncoherentAccess(use.access)) {
+        node.last_incoherent_write = int(position);
+      }
+      // The outputs are read after the graph, so a later pass mustn't get
+      // their render targets.
+      if (node.transient && node.acquired && !node.output &&
+          node.last_use == position) {
+        pool_.release(node.target);
+        node.acquired = false;
+      }
+    }
+  }
+
+  for (ResourceNode& node : resources_) {
+    if (node.transient && node.acquired) {
+      pool_.release(node.target);
+      node.acquired = false;
+    }
+  }
+}
+
+#endif  // glGenFramebuffers && glFramebufferTexture2D &&
+        // glFramebufferRenderbuffer && glTexStorage2D &&
+        // glRenderbufferStorageMultisample
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_RENDER_GRAPH_INL_H_
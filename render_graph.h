@@ -0,0 +1,309 @@
+// Copyright (c) Tamas Csala
+
+/** @file render_graph.h
+    @brief Implements a render graph, that orders the passes of a frame,
+           culls the unused ones, and inserts the memory barriers between them.
+*/
+
+#ifndef OGLWRAP_RENDER_GRAPH_H_
+#define OGLWRAP_RENDER_GRAPH_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+
+#include "./config.h"
+#include "./bitfield.h"
+#include "./buffer.h"
+#include "./render_target_pool.h"
+#include "context/synchronization.h"
+#include "enums/memory_barrier_bit.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The ways a pass can access a resource of a render graph.
+enum class ResourceAccess {
+  /// Texture fetches in shaders.
+  kSampled,
+  /// Image loads and stores in shaders.
+  kImage,
+  /// A color attachment of the framebuffer.
+  kColorAttachment,
+  /// The depth or stencil attachment of the framebuffer.
+  kDepthStencilAttachment,
+  /// Texture uploads, copies and readbacks (glTexSubImage, glGetTexImage).
+  kTextureUpdate,
+  /// Vertex attributes.
+  kVertexBuffer,
+  /// Indices of the draw calls.
+  kIndexBuffer,
+  /// Parameters of the indirect draw or dispatch calls.
+  kIndirectBuffer,
+  /// Uniform blocks.
+  kUniformBuffer,
+  /// Pixel transfers through a pixel pack or unpack buffer.
+  kPixelBuffer,
+  /// Shader storage blocks.
+  kShaderStorage,
+  /// Atomic counters.
+  kAtomicCounter,
+  /// Transform feedback.
+  kTransformFeedback,
+  /// Buffer uploads, copies, readbacks and mappings.
+  kBufferUpdate
+};
+
+/// Returns true if the writes of an access aren't automatically visible to
+/// the later commands, so they need a memory barrier.
+/** These are image stores, shader storage block writes and atomic counters. */
+inline bool IsIncoherentAccess(ResourceAccess access) {
+  return access == ResourceAccess::kImage ||
+         access == ResourceAccess::kShaderStorage ||
+         access == ResourceAccess::kAtomicCounter;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glMemoryBarrier)
+/// Returns the barrier bit, that makes the incoherent writes of the earlier
+/// commands visible to an access.
+/** @see glMemoryBarrier */
+inline MemoryBarrierBit GetMemoryBarrierBit(ResourceAccess access) {
+  switch (access) {
+    case ResourceAccess::kSampled:
+      return MemoryBarrierBit::kTextureFetchBarrierBit;
+    case ResourceAccess::kImage:
+      return MemoryBarrierBit::kShaderImageAccessBarrierBit;
+    case ResourceAccess::kColorAttachment:
+    case ResourceAccess::kDepthStencilAttachment:
+      return MemoryBarrierBit::kFramebufferBarrierBit;
+    case ResourceAccess::kTextureUpdate:
+      return MemoryBarrierBit::kTextureUpdateBarrierBit;
+    case ResourceAccess::kVertexBuffer:
+      return MemoryBarrierBit::kVertexAttribArrayBarrierBit;
+    case ResourceAccess::kIndexBuffer:
+      return MemoryBarrierBit::kElementArrayBarrierBit;
+    case ResourceAccess::kIndirectBuffer:
+      return MemoryBarrierBit::kCommandBarrierBit;
+    case ResourceAccess::kUniformBuffer:
+      return MemoryBarrierBit::kUniformBarrierBit;
+    case ResourceAccess::kPixelBuffer:
+      return MemoryBarrierBit::kPixelBufferBarrierBit;
+    case ResourceAccess::kShaderStorage:
+      return MemoryBarrierBit::kShaderStorageBarrierBit;
+    case ResourceAccess::kAtomicCounter:
+      return MemoryBarrierBit::kAtomicCounterBarrierBit;
+    case ResourceAccess::kTransformFeedback:
+      return MemoryBarrierBit::kTransformFeedbackBarrierBit;
+    default:
+      return MemoryBarrierBit::kBufferUpdateBarrierBit;
+  }
+}
+#endif  // glMemoryBarrier
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenFramebuffers) \
+    && defined(glFramebufferTexture2D) && defined(glFramebufferRenderbuffer) \
+    && defined(glTexStorage2D) && defined(glRenderbufferStorageMultisample))
+/// Orders, culls and executes the passes of a frame.
+/** The passes declare the resources they read and write, instead of being
+  * called in a hand written order:
+  *  - A pass, that reads a resource runs after every pass, that writes it.
+  *  - The writers of a resource run in the order they were added. A writer,
+  *    that doesn't read the resource, overwrites it, so the earlier writers
+  *    are only kept if a writer after them reads the resource too (for e.g. a
+  *    pass, that blends on top of it, or depth tests against it).
+  *  - Passes, whose results aren't read by anything, are culled. The results
+  *    are the imported resources, the resources marked as outputs, and the
+  *    passes, that have side effects.
+  *
+  * Transient render targets are acquired from a RenderTargetPool right before
+  * their first pass, and are released after their last one, so the render
+  * targets of the passes, whose lifetimes don't overlap, are shared. The
+  * outputs are only released when execute() returns, so no pass of the graph
+  * overwrites them. If a pass
+  * has attachments, the graph binds a framebuffer with them, and sets the
+  * viewport to their size before the pass is executed. The attachments, that
+  * aren't read after the pass, and aren't outputs, are invalidated after it.
+  *
+  * Image stores, shader storage writes and atomic counters aren't coherent,
+  * so the graph calls glMemoryBarrier before the passes, that access their
+  * results, with only the bits the accesses need. A barrier is global, so a
+  * bit isn't issued again if it has been already issued since the write.
+  * Other writes (rendering, transform feedback and copies) are synchronized
+  * by the driver, and don't get a barrier.
+  *
+  * The graph is meant to be rebuilt every frame: clear() it, add the passes
+  * and call execute(). */
+class RenderGraph {
+ public:
+  /// The index of a resource in the graph.
+  using Resource = size_t;
+
+  /// The index of a pass in the graph.
+  using Pass = size_t;
+
+  /// The function, that records the commands of a pass.
+  using Callback = std::function<void(const RenderGraph&)>;
+
+  /// Creates an empty graph.
+  /** @param pool - The pool of the transient render targets. It must outlive
+    *               the graph. */
+  explicit RenderGraph(RenderTargetPool& pool) : pool_(pool) {}
+
+  RenderGraph(const RenderGraph&) = delete;
+  RenderGraph& operator=(const RenderGraph&) = delete;
+
+  /// Removes every pass and resource.
+  void clear();
+
+  /// Creates a transient render target.
+  /** It is only allocated if a pass, that uses it isn't culled.
+    * @param desc - The description of the render target. */
+  Resource createRenderTarget(const RenderTargetDesc& desc);
+
+  template <TextureType TEXTURE_TYPE>
+  /// Imports a texture, that lives outside of the graph.
+  /** The passes, that write it are never culled. Importing the same texture
+    * twice returns the same resource. */
+  Resource importTexture(const TextureBase<TEXTURE_TYPE>& texture) {
+    return importResource(false, texture.expose());
+  }
+
+  template <BufferType BUFFER_TYPE>
+  /// Imports a buffer, that lives outside of the graph.
+  /** The passes, that write it are never culled. Importing the same buffer
+    * twice returns the same resource. */
+  Resource importBuffer(const BufferObject<BUFFER_TYPE>& buffer) {
+    return importResource(true, buffer.expose());
+  }
+
+  /// Marks a resource as a result of the frame, so its writers aren't culled.
+  void markOutput(Resource resource) { resources_[resource].output = true; }
+
+  /// Adds a pass.
+  /** @param name - The name of the pass, for debugging.
+    * @param callback - The function, that records the commands of the pass.
+    * @param side_effects - If true, the pass is never culled. */
+  Pass addPass(const std::string& name, Callback callback,
+               bool side_effects = false);
+
+  /// Declares, that a pass reads a resource.
+  /** @param pass - The pass, that reads the resource.
+    * @param resource - The resource to read.
+    * @param access - The way the resource is read. */
+  void read(Pass pass, Resource resource, ResourceAccess access);
+
+  /// Declares, that a pass writes a resource.
+  /** @param pass - The pass, that writes the resource.
+    * @param resource - The resource to write.
+    * @param access - The way the resource is written. */
+  void write(Pass pass, Resource resource, ResourceAccess access);
+
+  /// Attaches a transient render target to the framebuffer of a pass.
+  /** The pass writes the render target as a color, or a depth / stencil
+    * attachment, depending on the attachment point.
+    * @param pass - The pass, that renders to the render target.
+    * @param attachment - The attachment point of the render target.
+    * @param resource - A transient render target. */
+  void attach(Pass pass, FramebufferAttachment attachment, Resource resource);
+
+  /// Orders the passes, and culls the unused ones.
+  /** It is called by execute() if it wasn't called since the last change.
+    * Throws a std::logic_error if the passes depend on each other in a
+    * cycle. */
+  void compile();
+
+  /// Executes the passes, that aren't culled.
+  /** @see glMemoryBarrier */
+  void execute();
+
+  /// Returns the description of a transient render target.
+  const RenderTargetDesc& desc(Resource resource) const {
+    return resources_[resource].desc;
+  }
+
+  /// Returns the texture of a transient, single sampled render target.
+  /** It's only valid while the passes, that use it, are executed. */
+  const Texture2D& texture(Resource resource) const {
+    return pool_.texture(resources_[resource].target);
+  }
+
+  /// Returns the renderbuffer of a transient, multisampled render target.
+  /** It's only valid while the passes, that use it, are executed. */
+  const Renderbuffer& renderbuffer(Resource resource) const {
+    return pool_.renderbuffer(resources_[resource].target);
+  }
+
+  /// Returns the name of a pass.
+  const std::string& name(Pass pass) const { return passes_[pass].name; }
+
+  /// Returns the number of passes.
+  size_t passCount() const { return passes_.size(); }
+
+  /// Returns true if a pass was culled by the last compile().
+  bool isCulled(Pass pass) const { return passes_[pass].culled; }
+
+  /// Returns the passes, that aren't culled, in the order of execution.
+  const std::vector<Pass>& order() const { return order_; }
+
+  /// Returns the number of glMemoryBarrier calls made by the last execute().
+  size_t barrierCount() const { return barrier_count_; }
+
+ private:
+  struct ResourceNode {
+    bool transient = false;
+    RenderTargetDesc desc{0, 0, PixelDataInternalFormat::kRgba8};
+    bool imported = false;
+    bool imported_buffer = false;
+    GLuint imported_name = 0;
+    bool output = false;
+    std::vector<Pass> writers;  // In the order they were added
+    std::vector<Pass> readers;  // Only the ones, that don't write it
+
+    RenderTargetPool::Target target = 0;
+    size_t first_use = 0, last_use = 0;
+    bool used = false, acquired = false;
+    int last_incoherent_write = -1;
+  };
+
+  struct Use {
+    Resource resource;
+    ResourceAccess access;
+    bool write;
+  };
+
+  struct PassNode {
+    std::string name;
+    Callback callback;
+    bool side_effects = false;
+    std::vector<Use> uses;
+    std::vector<std::pair<FramebufferAttachment, Resource>> attachments;
+    bool culled = false;
+  };
+
+  RenderTargetPool& pool_;
+  std::vector<ResourceNode> resources_;
+  std::vector<PassNode> passes_;
+  std::vector<Pass> order_;
+  bool compiled_ = false;
+  size_t barrier_count_ = 0;
+
+  Resource importResource(bool buffer, GLuint name);
+  void addUse(Pass pass, Resource resource, ResourceAccess access, bool write);
+  bool accesses(Pass pass, Resource resource, bool write) const;
+  size_t liveWritersBegin(Resource resource, size_t end) const;
+  void cull();
+  void sort();
+  void computeLifetimes();
+};
+#endif  // glGenFramebuffers && glFramebufferTexture2D &&
+        // glFramebufferRenderbuffer && glTexStorage2D &&
+        // glRenderbufferStorageMultisample
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./render_graph-inl.h"
+
+#endif  // OGLWRAP_RENDER_GRAPH_H_
@@ -0,0 +1,187 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_RENDER_TARGET_POOL_INL_H_
+#define OGLWRAP_RENDER_TARGET_POOL_INL_H_
+
+#include <algorithm>
+
+#include "./render_target_pool.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenFramebuffers) \
+    && defined(glFramebufferTexture2D) && defined(glFramebufferRenderbuffer) \
+    && defined(glTexStorage2D) && defined(glRenderbufferStorageMultisample))
+
+inline void RenderTargetPool::beginFrame() {
+  for (Entry& entry : entries_) {
+    entry.acquired = false;
+  }
+  acquired_count_ = 0;
+
+  ++frame_;
+  if (frame_ > max_unused_frames_) {
+    deleteUnused(frame_ - max_unused_frames_);
+  }
+}
+
+inline RenderTargetPool::Target RenderTargetPool::acquire(
+    const RenderTargetDesc& desc) {
+  Target target = entries_.size();
+  for (Target i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    if (!entry.acquired && (entry.texture || entry.renderbuffer) &&
+        entry.desc == desc) {
+      target = i;
+      break;
+    }
+  }
+
+  if (target == entries_.size()) {
+    if (!free_entries_.empty()) {
+      target = free_entries_.back();
+      free_entries_.pop_back();
+    } else {
+      entries_.emplace_back();
+    }
+    entries_[target].desc = desc;
+    allocate(entries_[target]);
+  }
+
+  Entry& entry = entries_[target];
+  entry.acquired = true;
+  entry.last_used = frame_;
+  ++acquired_count_;
+  return target;
+}
+
+inline void RenderTargetPool::release(Target target) {
+  Entry& entry = entries_[target];
+  if (entry.acquired) {
+    entry.acquired = false;
+    --acquired_count_;
+  }
+}
+
+inline const Framebuffer& RenderTargetPool::framebuffer(
+    const std::vector<Attachment>& attachments) {
+  for (CachedFramebuffer& cached : framebuffers_) {
+    if (cached.attachments.size() != attachments.size()) {
+      continue;
+    }
+    bool same = std::all_of(attachments.begin(), attachments.end(),
+        [&cached](const Attachment& attachment) {
+          for (const Attachment& other : cached.attachments) {
+            if (other.attachment == attachment.attachment &&
+                other.target == attachment.target) {
+              return true;
+            }
+          }
+          return false;
+        });
+    if (same) {
+      cached.last_used = frame_;
+      Bind(*cached.framebuffer);
+      return *cached.framebuffer;
+    }
+  }
+
+  CachedFramebuffer cached;
+  cached.attachments = attachments;
+  cached.framebuffer.reset(new Framebuffer());
+  cached.last_used = frame_;
+
+  Framebuffer& fbo = *cached.framebuffer;
+  Bind(fbo);
+  for (const Attachment& attachment : attachments) {
+    const Entry& entry = entries_[attachment.target];
+    if (entry.texture) {
+      fbo.attachTexture(attachment.attachment, *entry.texture, 0);
+    } else {
+      fbo.attachBuffer(attachment.attachment, *entry.renderbuffer);
+    }
+  }
+  fbo.validate();
+
+  framebuffers_.push_back(std::move(cached));
+  return *framebuffers_.back().framebuffer;
+}
+
+inline void RenderTargetPool::clear() {
+  // Only the framebuffers of the deleted render targets are dropped, the ones
+  // of the acquired render targets might still be in use.
+  for (Target i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    if ((entry.texture || entry.renderbuffer) && !entry.acquired) {
+      deleteEntry(i);
+    }
+  }
+}
+
+inline void RenderTargetPool::allocate(Entry& entry) {
+  const RenderTargetDesc& desc = entry.desc;
+  if (desc.samples == 0) {
+    entry.texture.reset(new Texture2D());
+    Bind(*entry.texture);
+    entry.texture->storage(1, desc.internal_format, desc.width, desc.height);
+    entry.texture->minFilter(MinFilter::kLinear);
+    entry.texture->magFilter(MagFilter::kLinear);
+    entry.texture->wrapS(WrapMode::kClampToEdge);
+    entry.texture->wrapT(WrapMode::kClampToEdge);
+  } else {
+    entry.renderbuffer.reset(new Renderbuffer());
+    Bind(*entry.renderbuffer);
+    entry.renderbuffer->storageMultisample(desc.samples, desc.internal_format,
+                                           desc.width, desc.height);
+  }
+}
+
+inline void RenderTargetPool::deleteEntry(Target target) {
+  Entry& entry = entries_[target];
+  entry.texture.reset();
+  entry.renderbuffer.reset();
+  free_entries_.push_back(target);
+
+  // The framebuffers, that reference the render target are useless now.
+  framebuffers_.erase(
+      std::remove_if(framebuffers_.begin(), framebuffers_.end(),
+                     [target](const CachedFramebuffer& cached) {
+                       for (const Attachment& attachment : cached.attachments) {
+                         if (attachment.target == target) {
+                           return true;
+                         }
+                       }
+                       return false;
+                     }),
+      framebuffers_.end());
+}
+
+inline void RenderTargetPool::deleteUnused(size_t min_frame) {
+  for (Target i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    if ((entry.texture || entry.renderbuffer) && !entry.acquired &&
+        entry.last_used < min_frame) {
+      deleteEntry(i);
+    }
+  }
+
+  framebuffers_.erase(
+      std::remove_if(framebuffers_.begin(), framebuffers_.end(),
+                     [min_frame](const CachedFramebuffer& cached) {
+                       return cached.last_used < min_frame;
+                     }),
+      framebuffers_.end());
+}
+
+#endif  // glGenFramebuffers && glFramebufferTexture2D &&
+        // glFramebufferRenderbuffer && glTexStorage2D &&
+        // glRenderbufferStorageMultisample
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_RENDER_TARGET_POOL_INL_H_
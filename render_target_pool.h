@@ -0,0 +1,190 @@
+// Copyright (c) Tamas Csala
+
+/** @file render_target_pool.h
+    @brief Implements a pool of transient render targets, that are shared by
+           the passes of a frame.
+*/
+
+#ifndef OGLWRAP_RENDER_TARGET_POOL_H_
+#define OGLWRAP_RENDER_TARGET_POOL_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+#include "./config.h"
+#include "./framebuffer.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The description of a render target.
+struct RenderTargetDesc {
+  /// The size of the render target in pixels.
+  GLsizei width, height;
+
+  /// The sized internal format of the render target.
+  PixelDataInternalFormat internal_format;
+
+  /// The number of samples, zero for a single sampled render target.
+  GLsizei samples;
+
+  /// Creates a description.
+  RenderTargetDesc(GLsizei width, GLsizei height,
+                   PixelDataInternalFormat internal_format, GLsizei samples = 0)
+      : width(width), height(height), internal_format(internal_format)
+      , samples(samples) {}
+};
+
+inline bool operator==(const RenderTargetDesc& lhs,
+                       const RenderTargetDesc& rhs) {
+  return lhs.width == rhs.width && lhs.height == rhs.height &&
+         lhs.internal_format == rhs.internal_format &&
+         lhs.samples == rhs.samples;
+}
+
+inline bool operator!=(const RenderTargetDesc& lhs,
+                       const RenderTargetDesc& rhs) {
+  return !(lhs == rhs);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGenFramebuffers) \
+    && defined(glFramebufferTexture2D) && defined(glFramebufferRenderbuffer) \
+    && defined(glTexStorage2D) && defined(glRenderbufferStorageMultisample))
+/// Hands out render targets and framebuffers to the passes of a frame.
+/** A pass acquires its render targets by their description, and releases them
+  * when the last pass, that reads them, is recorded. A released render target
+  * is handed out again to a later pass of the same frame, that asks for the
+  * same description, so passes, whose lifetimes don't overlap, share the same
+  * memory. The commands are executed in order, so the later pass can't
+  * overwrite the contents before the earlier ones are done with it. The
+  * render targets are kept between the frames, so a steady state frame
+  * doesn't allocate anything, and the ones, that weren't used for a few
+  * frames (for e.g. the old size after a resize) are deleted.
+  *
+  * Single sampled render targets are Texture2Ds, so they can be sampled by the
+  * later passes, the multisampled ones are Renderbuffers, which are meant to
+  * be resolved with BlitFramebuffer. The framebuffers are cached by their
+  * attachments, and are validated only once, when they are created. The
+  * objects are bound by the functions, that create them. */
+class RenderTargetPool {
+ public:
+  /// The index of a render target in the pool.
+  using Target = size_t;
+
+  /// A render target attached to an attachment point of a framebuffer.
+  struct Attachment {
+    FramebufferAttachment attachment;
+    Target target;
+  };
+
+  /// Creates an empty pool.
+  /** @param max_unused_frames - The number of frames a render target or a
+    *                            framebuffer is kept without being used. */
+  explicit RenderTargetPool(size_t max_unused_frames = 2)
+      : max_unused_frames_(max_unused_frames) {}
+
+  RenderTargetPool(const RenderTargetPool&) = delete;
+  RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+  /// Marks the beginning of a new frame.
+  /** Every render target acquired in the previous frame is released, and the
+    * render targets and framebuffers, that weren't used in the last
+    * max_unused_frames frames are deleted. */
+  void beginFrame();
+
+  /// Acquires a render target, that isn't used by an other pass.
+  /** A released render target with the same description is reused if there's
+    * one, otherwise a new one is allocated. The contents of the render target
+    * are undefined.
+    * @param desc - The description of the render target.
+    * @return The acquired render target, that is valid until it is released.
+    * @see glTexStorage2D, glRenderbufferStorageMultisample */
+  Target acquire(const RenderTargetDesc& desc);
+
+  /// Releases a render target, so a later pass can reuse its memory.
+  /** @param target - The render target to release. Its contents shouldn't be
+    *                 read by the passes recorded after this call. */
+  void release(Target target);
+
+  /// Returns the description of a render target.
+  const RenderTargetDesc& desc(Target target) const {
+    return entries_[target].desc;
+  }
+
+  /// Returns true if a render target is a texture (it is single sampled).
+  bool isTexture(Target target) const {
+    return entries_[target].texture != nullptr;
+  }
+
+  /// Returns the texture of a single sampled render target.
+  const Texture2D& texture(Target target) const {
+    return *entries_[target].texture;
+  }
+
+  /// Returns the renderbuffer of a multisampled render target.
+  const Renderbuffer& renderbuffer(Target target) const {
+    return *entries_[target].renderbuffer;
+  }
+
+  /// Returns a framebuffer, that has the given render targets attached.
+  /** The framebuffer is created and validated the first time an attachment
+    * set is asked for, and it is reused afterwards. It is bound to
+    * GL_FRAMEBUFFER when it's returned.
+    * @param attachments - The acquired render targets and their attachment
+    *                      points.
+    * @see glFramebufferTexture2D, glFramebufferRenderbuffer */
+  const Framebuffer& framebuffer(const std::vector<Attachment>& attachments);
+
+  /// Returns the number of render targets allocated by the pool.
+  size_t size() const { return entries_.size() - free_entries_.size(); }
+
+  /// Returns the number of acquired render targets.
+  size_t acquiredCount() const { return acquired_count_; }
+
+  /// Returns the number of framebuffers cached by the pool.
+  size_t framebufferCount() const { return framebuffers_.size(); }
+
+  /// Deletes every render target, that isn't acquired, and the framebuffers
+  /// they are attached to.
+  /** The framebuffers of the acquired render targets are kept, so the
+    * references returned by framebuffer() for them stay valid. */
+  void clear();
+
+ private:
+  struct Entry {
+    RenderTargetDesc desc{0, 0, PixelDataInternalFormat::kRgba8};
+    std::unique_ptr<Texture2D> texture;
+    std::unique_ptr<Renderbuffer> renderbuffer;
+    bool acquired = false;
+    size_t last_used = 0;
+  };
+
+  struct CachedFramebuffer {
+    std::vector<Attachment> attachments;
+    std::unique_ptr<Framebuffer> framebuffer;
+    size_t last_used = 0;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<Target> free_entries_;
+  std::vector<CachedFramebuffer> framebuffers_;
+  size_t max_unused_frames_;
+  size_t acquired_count_ = 0;
+  size_t frame_ = 1;
+
+  void allocate(Entry& entry);
+  void deleteEntry(Target target);
+  void deleteUnused(size_t min_frame);
+};
+#endif  // glGenFramebuffers && glFramebufferTexture2D &&
+        // glFramebufferRenderbuffer && glTexStorage2D &&
+        // glRenderbufferStorageMultisample
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./render_target_pool-inl.h"
+
+#endif  // OGLWRAP_RENDER_TARGET_POOL_H_
@@ -16,9 +16,14 @@ namespace OGLWRAP_NAMESPACE_NAME {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glRenderbufferStorage)
 inline void Renderbuffer::storage(PixelDataInternalFormat internal_format,
                                   GLsizei width, GLsizei height) {
+#if OGLWRAP_USE_DSA
+  gl(NamedRenderbufferStorage(
+      renderbuffer_, GLenum(internal_format), width, height));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(RenderbufferStorage(
       GL_RENDERBUFFER, GLenum(internal_format), width, height));
+#endif
 }
 #endif  // glRenderbufferStorage
 
@@ -26,9 +31,14 @@ inline void Renderbuffer::storage(PixelDataInternalFormat internal_format,
 inline void Renderbuffer::storageMultisample(
     GLsizei samples, PixelDataInternalFormat internal_format,
     GLsizei width, GLsizei height) {
+#if OGLWRAP_USE_DSA
+  gl(NamedRenderbufferStorageMultisample(
+      renderbuffer_, samples, GLenum(internal_format), width, height));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(RenderbufferStorageMultisample(
       GL_RENDERBUFFER, samples, GLenum(internal_format), width, height));
+#endif
 }
 #endif  // glRenderbufferStorageMultisample
 
@@ -0,0 +1,251 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_SAMPLER_INL_H_
+#define OGLWRAP_SAMPLER_INL_H_
+
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+#include "./sampler.h"
+#include "context/extensions.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Returns the bits of a float.
+inline uint32_t OGLWRAP_FloatBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline bool SamplerDesc::operator==(const SamplerDesc& other) const {
+  bool same_border_color = true;
+  for (int i = 0; i < 4; ++i) {
+    same_border_color = same_border_color &&
+        OGLWRAP_FloatBits(border_color[i]) ==
+        OGLWRAP_FloatBits(other.border_color[i]);
+  }
+  return min_filter == other.min_filter &&
+         mag_filter == other.mag_filter &&
+         wrap_s == other.wrap_s &&
+         wrap_t == other.wrap_t &&
+         wrap_r == other.wrap_r &&
+         compare_mode == other.compare_mode &&
+         compare_func == other.compare_func &&
+         OGLWRAP_FloatBits(max_anisotropy) ==
+             OGLWRAP_FloatBits(other.max_anisotropy) &&
+         OGLWRAP_FloatBits(min_lod) == OGLWRAP_FloatBits(other.min_lod) &&
+         OGLWRAP_FloatBits(max_lod) == OGLWRAP_FloatBits(other.max_lod) &&
+         OGLWRAP_FloatBits(lod_bias) == OGLWRAP_FloatBits(other.lod_bias) &&
+         same_border_color;
+}
+
+inline size_t SamplerDescHash::operator()(const SamplerDesc& desc) const {
+  size_t seed = 0;
+  auto combine = [&seed](size_t hash) {
+    seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  std::hash<GLenum> enum_hash;
+  combine(enum_hash(GLenum(desc.min_filter)));
+  combine(enum_hash(GLenum(desc.mag_filter)));
+  combine(enum_hash(GLenum(desc.wrap_s)));
+  combine(enum_hash(GLenum(desc.wrap_t)));
+  combine(enum_hash(GLenum(desc.wrap_r)));
+  combine(enum_hash(GLenum(desc.compare_mode)));
+  combine(enum_hash(GLenum(desc.compare_func)));
+
+  // The floats are hashed bitwise, just like operator== compares them.
+  std::hash<uint32_t> float_hash;
+  combine(float_hash(OGLWRAP_FloatBits(desc.max_anisotropy)));
+  combine(float_hash(OGLWRAP_FloatBits(desc.min_lod)));
+  combine(float_hash(OGLWRAP_FloatBits(desc.max_lod)));
+  combine(float_hash(OGLWRAP_FloatBits(desc.lod_bias)));
+  for (int i = 0; i < 4; ++i) {
+    combine(float_hash(OGLWRAP_FloatBits(desc.border_color[i])));
+  }
+  return seed;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || \
+    (defined(glGenSamplers) && defined(glDeleteSamplers) && \
+     defined(glSamplerParameteri) && defined(glSamplerParameterf))
+
+inline void Sampler::set(const SamplerDesc& desc) {
+  minFilter(desc.min_filter);
+  magFilter(desc.mag_filter);
+  wrapS(desc.wrap_s);
+  wrapT(desc.wrap_t);
+  wrapP(desc.wrap_r);
+  compareMode(desc.compare_mode);
+  compareFunc(desc.compare_func);
+  minLod(desc.min_lod);
+  maxLod(desc.max_lod);
+  lodBias(desc.lod_bias);
+  borderColor(desc.border_color);
+
+  // Setting the anisotropy without the extension is a GL error. With it, the
+  // value is set even if it's one, so a reused sampler gets reset.
+  if (IsExtensionSupported("GL_EXT_texture_filter_anisotropic") ||
+      IsExtensionSupported("GL_ARB_texture_filter_anisotropic")) {
+    anisotropy(desc.max_anisotropy);
+  }
+}
+
+inline void Sampler::minFilter(MinFilter filtermode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_MIN_FILTER, GLenum(filtermode)));
+}
+
+inline void Sampler::magFilter(MagFilter filtermode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_MAG_FILTER, GLenum(filtermode)));
+}
+
+inline void Sampler::wrapS(WrapMode wrap_mode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_WRAP_S, GLenum(wrap_mode)));
+}
+
+inline void Sampler::wrapT(WrapMode wrap_mode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_WRAP_T, GLenum(wrap_mode)));
+}
+
+inline void Sampler::wrapP(WrapMode wrap_mode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_WRAP_R, GLenum(wrap_mode)));
+}
+
+inline void Sampler::borderColor(glm::vec4 color) {
+  gl(SamplerParameterfv(sampler_, GL_TEXTURE_BORDER_COLOR,
+                        glm::value_ptr(color)));
+}
+
+inline void Sampler::compareMode(CompareMode mode) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_COMPARE_MODE, GLenum(mode)));
+}
+
+inline void Sampler::compareFunc(CompareFunc func) {
+  gl(SamplerParameteri(sampler_, GL_TEXTURE_COMPARE_FUNC, GLenum(func)));
+}
+
+inline void Sampler::minLod(float value) {
+  gl(SamplerParameterf(sampler_, GL_TEXTURE_MIN_LOD, value));
+}
+
+inline void Sampler::maxLod(float value) {
+  gl(SamplerParameterf(sampler_, GL_TEXTURE_MAX_LOD, value));
+}
+
+inline void Sampler::lodBias(float value) {
+  gl(SamplerParameterf(sampler_, GL_TEXTURE_LOD_BIAS, value));
+}
+
+inline void Sampler::anisotropy(float value) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_MAX_ANISOTROPY_EXT)
+  gl(SamplerParameterf(sampler_, GL_TEXTURE_MAX_ANISOTROPY_EXT, value));
+#endif
+}
+
+inline void Sampler::maxAnisotropy() {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_MAX_ANISOTROPY_EXT)
+  GLfloat maxAniso = 0.0f;
+  gl(GetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso));
+  anisotropy(maxAniso);
+#endif
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBindSampler)
+
+inline SamplerCache::Entry& SamplerCache::entry(const SamplerDesc& desc) {
+  auto iter = samplers_.find(desc);
+  if (iter == samplers_.end()) {
+    iter = samplers_.emplace(desc, Entry{desc}).first;
+  }
+  return iter->second;
+}
+
+inline const Sampler& SamplerCache::get(const SamplerDesc& desc) {
+  Entry& result = entry(desc);
+  result.returned = true;
+  return result.sampler;
+}
+
+inline SamplerDesc SamplerCache::applyQuality(SamplerDesc desc) const {
+  desc.max_anisotropy = std::min(desc.max_anisotropy,
+                                 quality_.max_anisotropy);
+  desc.lod_bias += quality_.lod_bias;
+  return desc;
+}
+
+inline void SamplerCache::bindToUnit(GLuint tex_unit) {
+  Unit& unit = units_[tex_unit];
+  const Sampler* sampler = &entry(applyQuality(unit.desc)).sampler;
+  if (sampler != unit.sampler) {
+    gl(BindSampler(tex_unit, sampler->expose()));
+    unit.sampler = sampler;
+  }
+}
+
+inline void SamplerCache::bind(const SamplerDesc& desc, GLuint tex_unit) {
+  if (tex_unit >= units_.size()) {
+    units_.resize(tex_unit + 1);
+  }
+  units_[tex_unit].bound = true;
+  units_[tex_unit].desc = desc;
+  bindToUnit(tex_unit);
+}
+
+inline void SamplerCache::unbind(GLuint tex_unit) {
+  if (tex_unit < units_.size() && units_[tex_unit].bound) {
+    gl(BindSampler(tex_unit, 0));
+    units_[tex_unit] = Unit{};
+  }
+}
+
+inline void SamplerCache::quality(const Quality& quality) {
+  quality_ = quality;
+  for (GLuint tex_unit = 0; tex_unit < units_.size(); ++tex_unit) {
+    if (units_[tex_unit].bound) {
+      bindToUnit(tex_unit);
+    }
+  }
+
+  // The samplers with the old quality settings applied aren't needed anymore.
+  deleteUnused(true);
+}
+
+inline void SamplerCache::deleteUnused() {
+  deleteUnused(false);
+}
+
+inline void SamplerCache::deleteUnused(bool keep_returned) {
+  for (auto iter = samplers_.begin(); iter != samplers_.end();) {
+    const Entry& entry = iter->second;
+    bool bound = std::any_of(units_.begin(), units_.end(),
+        [&entry](const Unit& unit) { return unit.sampler == &entry.sampler; });
+    if (bound || (keep_returned && entry.returned)) {
+      ++iter;
+    } else {
+      iter = samplers_.erase(iter);
+    }
+  }
+}
+
+inline void SamplerCache::clear() {
+  for (GLuint tex_unit = 0; tex_unit < units_.size(); ++tex_unit) {
+    unbind(tex_unit);
+  }
+  units_.clear();
+  samplers_.clear();
+}
+
+#endif  // glBindSampler
+
+#endif  // glGenSamplers && glDeleteSamplers && glSamplerParameter*
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_SAMPLER_INL_H_
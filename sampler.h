@@ -0,0 +1,258 @@
+// Copyright (c) Tamas Csala
+
+/** @file sampler.h
+    @brief Implements sampler objects, and a cache that shares them between
+           identical sampler descriptions.
+*/
+
+#ifndef OGLWRAP_SAMPLER_H_
+#define OGLWRAP_SAMPLER_H_
+
+#include <vector>
+#include <cstddef>
+#include <unordered_map>
+
+#include "./config.h"
+#include "./globjects.h"
+
+#include "enums/wrap_mode.h"
+#include "enums/min_filter.h"
+#include "enums/mag_filter.h"
+#include "enums/compare_mode.h"
+#include "enums/compare_func.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Describes every state of a sampler object.
+/** The default values are the initial values of a sampler object. */
+struct SamplerDesc {
+  MinFilter min_filter = MinFilter::kNearestMipmapLinear;
+  MagFilter mag_filter = MagFilter::kLinear;
+  WrapMode wrap_s = WrapMode::kRepeat;
+  WrapMode wrap_t = WrapMode::kRepeat;
+  WrapMode wrap_r = WrapMode::kRepeat;
+  CompareMode compare_mode = CompareMode::kNone;
+  CompareFunc compare_func = CompareFunc::kLequal;
+  /// Values greater than one are only applied if anisotropic filtering is
+  /// supported.
+  float max_anisotropy = 1.0f;
+  float min_lod = -1000.0f;
+  float max_lod = 1000.0f;
+  float lod_bias = 0.0f;
+  glm::vec4 border_color = glm::vec4(0.0f);
+
+  /// The floats are compared bitwise, so a description with a NaN in it
+  /// equals to itself, and finds its sampler in a SamplerCache.
+  bool operator==(const SamplerDesc& other) const;
+  bool operator!=(const SamplerDesc& other) const { return !(*this == other); }
+};
+
+/// Hashes a SamplerDesc, so it can be used as the key of unordered containers.
+struct SamplerDescHash {
+  size_t operator()(const SamplerDesc& desc) const;
+};
+
+#if OGLWRAP_DEFINE_EVERYTHING || \
+    (defined(glGenSamplers) && defined(glDeleteSamplers) && \
+     defined(glSamplerParameteri) && defined(glSamplerParameterf))
+/// An object, that stores the sampling parameters separately from a texture.
+/** A sampler bound to a texture unit overrides the sampling parameters of the
+  * texture bound to the same unit. Unlike the parameters of a texture, the
+  * parameters of a sampler can be changed without binding it.
+  * @see glGenSamplers, glDeleteSamplers */
+class Sampler {
+ public:
+  /// Creates a new sampler with the initial sampling parameters.
+  Sampler() = default;
+
+  /// Creates a new sampler with the given sampling parameters.
+  explicit Sampler(const SamplerDesc& desc) { set(desc); }
+
+  /// Moves a sampler
+  Sampler(Sampler&&) noexcept = default;
+
+  /// Moves a sampler
+  Sampler& operator=(Sampler&&) noexcept = default;
+
+  /// Wrappes an existing OpenGL sampler into an oglwrap Sampler
+  explicit Sampler(GLuint handle) : sampler_{handle} {}
+
+  /// Sets every sampling parameter of the sampler.
+  /** The anisotropy is skipped if anisotropic filtering isn't supported.
+    * @param desc - The desired sampling parameters.
+    * @see glSamplerParameteri, glSamplerParameterf, glSamplerParameterfv */
+  void set(const SamplerDesc& desc);
+
+  /// Sets the minification filter.
+  /** @param filtermode - The desired minification filter mode.
+    * @see glSamplerParameteri, GL_TEXTURE_MIN_FILTER */
+  void minFilter(MinFilter filtermode);
+
+  /// Sets the magnification filter.
+  /** @param filtermode - The desired magnification filter mode.
+    * @see glSamplerParameteri, GL_TEXTURE_MAG_FILTER */
+  void magFilter(MagFilter filtermode);
+
+  /// Sets the wrap mode of the 's' (first) texture coordinate.
+  /** @param wrap_mode - The desired wrapping mode.
+    * @see glSamplerParameteri, GL_TEXTURE_WRAP_S */
+  void wrapS(WrapMode wrap_mode);
+
+  /// Sets the wrap mode of the 't' (second) texture coordinate.
+  /** @param wrap_mode - The desired wrapping mode.
+    * @see glSamplerParameteri, GL_TEXTURE_WRAP_T */
+  void wrapT(WrapMode wrap_mode);
+
+  /// Sets the wrap mode of the 'p' (third) texture coordinate.
+  /** @param wrap_mode - The desired wrapping mode.
+    * @see glSamplerParameteri, GL_TEXTURE_WRAP_R */
+  void wrapP(WrapMode wrap_mode);
+
+  /// Sets the border color.
+  /** @param color - Specifies the value, the border color should be set to.
+    * @see glSamplerParameterfv, GL_TEXTURE_BORDER_COLOR */
+  void borderColor(glm::vec4 color);
+
+  /// Sets the compare mode.
+  /** @param mode - The desired compare mode.
+    * @see glSamplerParameteri, GL_TEXTURE_COMPARE_MODE */
+  void compareMode(CompareMode mode);
+
+  /// Sets the compare function.
+  /** @param func - The desired compare function.
+    * @see glSamplerParameteri, GL_TEXTURE_COMPARE_FUNC */
+  void compareFunc(CompareFunc func);
+
+  /// Sets the minimum level-of-detail.
+  /** @see glSamplerParameterf, GL_TEXTURE_MIN_LOD */
+  void minLod(float value);
+
+  /// Sets the maximum level-of-detail.
+  /** @see glSamplerParameterf, GL_TEXTURE_MAX_LOD */
+  void maxLod(float value);
+
+  /// Sets the level-of-detail bias.
+  /** @see glSamplerParameterf, GL_TEXTURE_LOD_BIAS */
+  void lodBias(float value);
+
+  /// Sets the anisotropy extension to a desired value.
+  /** It doesn't do anything if anisotropy is not supported
+    * @param value - The desired anisotropy value.
+    * @see glSamplerParameterf, GL_TEXTURE_MAX_ANISOTROPY_EXT */
+  void anisotropy(float value);
+
+  /// Sets the anisotropy extension to the maximum value possible on this hardware.
+  /** It doesn't do anything if anisotropy is not supported
+    * @see glGetFloatv, glSamplerParameterf, GL_TEXTURE_MAX_ANISOTROPY_EXT */
+  void maxAnisotropy();
+
+  /// Returns the handle for this object.
+  const glObject& expose() const { return sampler_; }
+
+ private:
+  globjects::Sampler sampler_;
+};
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBindSampler)
+/// Creates one sampler object for every distinct SamplerDesc, and binds them.
+/** Textures, that are sampled the same way share a single sampler, so the
+  * sampling parameters don't have to be set on every texture. The cache also
+  * remembers the sampler bound to each texture unit, and doesn't rebind it if
+  * it is already bound.
+  *
+  * Global quality settings (like the anisotropy limit) are applied on top of
+  * the descriptions when the samplers are bound, so changing them only
+  * rebinds the texture units in use, instead of touching every texture. */
+class SamplerCache {
+ public:
+  /// Quality settings, that are applied to every sampler of the cache.
+  struct Quality {
+    /// The anisotropy of each sampler is clamped to this value.
+    float max_anisotropy = 16.0f;
+    /// Added to the level-of-detail bias of each sampler.
+    float lod_bias = 0.0f;
+  };
+
+  SamplerCache() = default;
+  SamplerCache(const SamplerCache&) = delete;
+  SamplerCache& operator=(const SamplerCache&) = delete;
+
+  /// Returns the sampler for a description, creating it if it doesn't exist.
+  /** The global quality settings are not applied to the returned sampler.
+    * The reference stays valid until deleteUnused() or clear() is called, or
+    * the cache is destroyed. */
+  const Sampler& get(const SamplerDesc& desc);
+
+  /// Binds the sampler for a description to a texture unit.
+  /** The global quality settings are applied to the description.
+    * @param desc - The description of the sampler.
+    * @param tex_unit - The texture unit to bind the sampler to.
+    * @see glBindSampler */
+  void bind(const SamplerDesc& desc, GLuint tex_unit);
+
+  /// Unbinds the sampler from a texture unit, if the cache has bound any.
+  /** @param tex_unit - The texture unit.
+    * @see glBindSampler */
+  void unbind(GLuint tex_unit);
+
+  /// Returns the current quality settings.
+  const Quality& quality() const { return quality_; }
+
+  /// Changes the quality settings, and rebinds the texture units in use.
+  /** The samplers, that were created for the previous quality settings, and
+    * aren't bound anymore are deleted.
+    * @param quality - The new quality settings.
+    * @see glBindSampler */
+  void quality(const Quality& quality);
+
+  /// Returns the number of distinct samplers alive.
+  size_t size() const { return samplers_.size(); }
+
+  /// Deletes every sampler, that isn't bound to a texture unit.
+  /** This includes the samplers returned by get(), the references to them
+    * become invalid. */
+  void deleteUnused();
+
+  /// Deletes every sampler, and forgets the bindings.
+  /** The samplers bound by the cache are unbound first. */
+  void clear();
+
+ private:
+  struct Unit {
+    bool bound = false;
+    SamplerDesc desc;  // The description requested, without the quality
+    const Sampler* sampler = nullptr;
+  };
+
+  struct Entry {
+    Sampler sampler;
+    bool returned = false;  // True if get() has returned it
+
+    explicit Entry(const SamplerDesc& desc) : sampler(desc) {}
+  };
+
+  std::unordered_map<SamplerDesc, Entry, SamplerDescHash> samplers_;
+  std::vector<Unit> units_;
+  Quality quality_;
+
+  Entry& entry(const SamplerDesc& desc);
+  void deleteUnused(bool keep_returned);
+  SamplerDesc applyQuality(SamplerDesc desc) const;
+  void bindToUnit(GLuint tex_unit);
+};
+#endif  // glBindSampler
+
+#endif  // glGenSamplers && glDeleteSamplers && glSamplerParameter*
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./sampler-inl.h"
+
+#endif  // OGLWRAP_SAMPLER_H_
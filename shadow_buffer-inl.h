@@ -0,0 +1,136 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_SHADOW_BUFFER_INL_H_
+#define OGLWRAP_SHADOW_BUFFER_INL_H_
+
+#include <algorithm>
+#include <cstring>
+
+#include "./shadow_buffer.h"
+#include "debug/bind_checking.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline void DirtyRanges::add(size_t begin, size_t end) {
+  if (begin >= end) {
+    return;
+  }
+
+  // The first range that ends close enough to begin to be merged with it.
+  auto first = std::lower_bound(ranges_.begin(), ranges_.end(), begin,
+      [this](const Range& range, size_t value) {
+        return range.end + gap_threshold_ < value;
+      });
+
+  auto last = first;
+  while (last != ranges_.end() && last->begin <= end + gap_threshold_) {
+    begin = std::min(begin, last->begin);
+    end = std::max(end, last->end);
+    ++last;
+  }
+
+  first = ranges_.erase(first, last);
+  ranges_.insert(first, Range{begin, end});
+}
+
+inline size_t DirtyRanges::byteCount() const {
+  size_t count = 0;
+  for (const Range& range : ranges_) {
+    count += range.size();
+  }
+  return count;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING \
+      || (defined(glGenBuffers) && defined(glDeleteBuffers))
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+template<BufferType BUFFER_TYPE>
+void ShadowBuffer<BUFFER_TYPE>::data(GLsizei size, const void* data,
+                                     BufferUsage usage) {
+  if (data) {
+    const GLubyte* bytes = static_cast<const GLubyte*>(data);
+    shadow_.assign(bytes, bytes + size);
+  } else {
+    shadow_.assign(size, 0);
+  }
+  dirty_ranges_.clear();
+
+  BufferObject<BUFFER_TYPE>::data(size, shadow_.data(), usage);
+}
+#endif  // glBufferData
+
+template<BufferType BUFFER_TYPE>
+template<typename GLtype>
+void ShadowBuffer<BUFFER_TYPE>::subData(GLintptr offset, GLsizei size,
+                                        const GLtype* data) {
+#if OGLWRAP_DEBUG
+  if (offset < 0 || size < 0 || size_t(offset + size) > shadow_.size()) {
+    OGLWRAP_PRINT_ERROR("Shadow buffer overflow",
+      "ShadowBuffer::subData was called with a range that doesn't fit into "
+      "the shadow copy. Did you forget to call data() first?");
+    return;
+  }
+#endif
+
+  std::memcpy(shadow_.data() + offset, data, size);
+  dirty_ranges_.add(offset, offset + size);
+}
+
+template<BufferType BUFFER_TYPE>
+void ShadowBuffer<BUFFER_TYPE>::markDirty(GLintptr offset, GLsizei size) {
+  dirty_ranges_.add(offset, std::min<size_t>(offset + size, shadow_.size()));
+}
+
+template<BufferType BUFFER_TYPE>
+void ShadowBuffer<BUFFER_TYPE>::flush(FlushMode mode) {
+  if (dirty_ranges_.empty()) {
+    return;
+  }
+
+  OGLWRAP_CHECK_BINDING();
+  const std::vector<DirtyRanges::Range>& ranges = dirty_ranges_.ranges();
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glMapBufferRange) \
+     && defined(glFlushMappedBufferRange) && defined(glUnmapBuffer))
+  if (mode == kMappedWrite && ranges.size() > 1) {
+    size_t span_begin = ranges.front().begin;
+    size_t span_end = ranges.back().end;
+    Bitfield<BufferMapAccessFlags> access =
+        {BufferMapAccessFlags::kMapWriteBit,
+         BufferMapAccessFlags::kMapFlushExplicitBit};
+
+    void* mapped_data = gl(MapBufferRange(GLenum(BUFFER_TYPE), span_begin,
+                                          span_end - span_begin, access));
+    if (mapped_data) {
+      GLubyte* mapped = static_cast<GLubyte*>(mapped_data);
+      for (const DirtyRanges::Range& range : ranges) {
+        std::memcpy(mapped + (range.begin - span_begin),
+                    shadow_.data() + range.begin, range.size());
+        gl(FlushMappedBufferRange(GLenum(BUFFER_TYPE),
+                                  range.begin - span_begin, range.size()));
+      }
+      gl(UnmapBuffer(GLenum(BUFFER_TYPE)));
+      dirty_ranges_.clear();
+      return;
+    }
+    // If the mapping failed, fall back to glBufferSubData
+  }
+#endif
+
+  for (const DirtyRanges::Range& range : ranges) {
+    gl(BufferSubData(GLenum(BUFFER_TYPE), range.begin, range.size(),
+                     shadow_.data() + range.begin));
+  }
+  dirty_ranges_.clear();
+}
+
+#endif  // glGenBuffers && glDeleteBuffers
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_SHADOW_BUFFER_INL_H_
@@ -0,0 +1,222 @@
+// Copyright (c) Tamas Csala
+
+/** @file shadow_buffer.h
+    @brief Implements buffers with a CPU side shadow copy, that upload only
+           the modified ranges of their data.
+*/
+
+#ifndef OGLWRAP_SHADOW_BUFFER_H_
+#define OGLWRAP_SHADOW_BUFFER_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "./config.h"
+#include "./buffer.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Keeps a sorted list of disjoint, modified byte ranges.
+/** Ranges that overlap, touch, or are closer to each other than the gap
+  * threshold are merged on insertion. */
+class DirtyRanges {
+ public:
+  /// A half-open [begin, end) byte range.
+  struct Range {
+    size_t begin;
+    size_t end;
+
+    size_t size() const { return end - begin; }
+  };
+
+  /// Creates an empty range list.
+  /** @param gap_threshold - Ranges that are at most this many bytes apart
+    *                        are merged into one. */
+  explicit DirtyRanges(size_t gap_threshold = 0)
+      : gap_threshold_(gap_threshold) {}
+
+  /// Marks the [begin, end) range as modified.
+  void add(size_t begin, size_t end);
+
+  /// Sets the gap threshold. Only affects the ranges added after this call.
+  void gapThreshold(size_t gap_threshold) { gap_threshold_ = gap_threshold; }
+
+  /// Returns the gap threshold.
+  size_t gapThreshold() const { return gap_threshold_; }
+
+  /// Forgets all the ranges.
+  void clear() { ranges_.clear(); }
+
+  /// Returns true if no range is marked modified.
+  bool empty() const { return ranges_.empty(); }
+
+  /// Returns the merged ranges in increasing order.
+  const std::vector<Range>& ranges() const { return ranges_; }
+
+  /// Returns the sum of the sizes of the ranges.
+  size_t byteCount() const;
+
+ private:
+  std::vector<Range> ranges_;
+  size_t gap_threshold_;
+};
+
+#if OGLWRAP_DEFINE_EVERYTHING \
+      || (defined(glGenBuffers) && defined(glDeleteBuffers))
+template<BufferType BUFFER_TYPE>
+/// A buffer object, that has a CPU side copy of its data store.
+/** Modifications through subData() only update the shadow copy, and record the
+  * modified range. The recorded ranges are coalesced, and uploaded together in
+  * flush(), with the fewest possible glBufferSubData calls, or with a single
+  * mapping of the buffer.
+  * The data store should only be modified through this class, otherwise the
+  * shadow copy gets out of sync. */
+class ShadowBuffer : public BufferObject<BUFFER_TYPE> {
+ public:
+  /// Specifies how flush() uploads the modified ranges.
+  enum FlushMode {
+    /// One glBufferSubData call per (merged) range.
+    kSubData,
+    /// A single glMapBufferRange call, spanning every modified range.
+    kMappedWrite
+  };
+
+  /// Creates a new buffer
+  /** @param gap_threshold - Modified ranges that are at most this many bytes
+    *                        apart are uploaded together. */
+  explicit ShadowBuffer(size_t gap_threshold = 0)
+      : dirty_ranges_(gap_threshold) {}
+
+  /// Moves a shadow buffer.
+  ShadowBuffer(ShadowBuffer&&) = default;
+
+  /// Moves a shadow buffer.
+  ShadowBuffer& operator=(ShadowBuffer&&) = default;
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBufferData)
+  /// Creates and initializes both the shadow copy and the data store.
+  /** Discards the not yet flushed modifications.
+    * @param size    Specifies the size in bytes of the buffer object's new data
+    *                store.
+    * @param data    Specifies a pointer to data that will be copied into the
+    *                data store for initialization, or NULL if the data store
+    *                should be zero initialized.
+    * @param usage   Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void data(GLsizei size, const void* data,
+            BufferUsage usage = BufferUsage::kDynamicDraw);
+
+  template<typename GLtype>
+  /// Creates and initializes both the shadow copy and the data store.
+  /** Discards the not yet flushed modifications.
+    * @param data - Specifies a vector of data to upload.
+    * @param usage - Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void data(const std::vector<GLtype>& data,
+            BufferUsage usage = BufferUsage::kDynamicDraw) {
+    this->data(data.size() * sizeof(GLtype), data.data(), usage);
+  }
+
+  template<typename ContiguousRange,
+           typename = OGLWRAP_RangeElement<ContiguousRange>>
+  /// Creates and initializes both the shadow copy and the data store.
+  /** Discards the not yet flushed modifications.
+    * @param range - Specifies a contiguous range of trivially copyable
+    *                elements to upload.
+    * @param usage - Specifies the expected usage pattern of the data store.
+    * @see glBufferData */
+  void data(const ContiguousRange& range,
+            BufferUsage usage = BufferUsage::kDynamicDraw) {
+    using Element = OGLWRAP_RangeElement<ContiguousRange>;
+    static_assert(std::is_trivially_copyable<Element>::value,
+                  "Only trivially copyable types can be uploaded to a buffer");
+
+    this->data(OGLWRAP_RangeSize(range) * sizeof(Element),
+               OGLWRAP_RangeData(range), usage);
+  }
+#endif  // glBufferData
+
+  template<typename GLtype>
+  /// Updates a subset of the shadow copy, and marks it as modified.
+  /** Doesn't call any OpenGL function, the data is uploaded in flush().
+    * @param offset  Specifies the offset into the buffer object's data store
+    *                where data replacement will begin, measured in bytes.
+    * @param size    Specifies the size in bytes of the data store region being
+    *                replaced.
+    * @param data    Specifies a pointer to the new data that will be copied
+    *                into the shadow copy. */
+  void subData(GLintptr offset, GLsizei size, const GLtype* data);
+
+  template<typename GLtype>
+  /// Updates a subset of the shadow copy, and marks it as modified.
+  /** Doesn't call any OpenGL function, the data is uploaded in flush().
+    * @param offset  Specifies the offset into the buffer object's data store
+    *                where data replacement will begin, measured in bytes.
+    * @param data    Specifies a vector containing the new data that will be
+    *                copied into the shadow copy. */
+  void subData(GLintptr offset, const std::vector<GLtype>& data) {
+    subData(offset, data.size() * sizeof(GLtype), data.data());
+  }
+
+  template<typename ContiguousRange,
+           typename = OGLWRAP_RangeElement<ContiguousRange>>
+  /// Updates a subset of the shadow copy, and marks it as modified.
+  /** Doesn't call any OpenGL function, the data is uploaded in flush().
+    * @param offset  Specifies the offset into the buffer object's data store
+    *                where data replacement will begin, measured in bytes.
+    * @param range   Specifies a contiguous range of trivially copyable
+    *                elements, that will be copied into the shadow copy. */
+  void subData(GLintptr offset, const ContiguousRange& range) {
+    using Element = OGLWRAP_RangeElement<ContiguousRange>;
+    static_assert(std::is_trivially_copyable<Element>::value,
+                  "Only trivially copyable types can be uploaded to a buffer");
+
+    subData(offset, OGLWRAP_RangeSize(range) * sizeof(Element),
+            OGLWRAP_RangeData(range));
+  }
+
+  /// Marks a range as modified.
+  /** Use it after writing directly to the memory returned by shadow().
+    * @param offset  The offset of the modified range in bytes.
+    * @param size    The size of the modified range in bytes. */
+  void markDirty(GLintptr offset, GLsizei size);
+
+  /// Uploads every modified range to the data store.
+  /** @param mode - Specifies how the upload should be done.
+    * @see glBufferSubData, glMapBufferRange, glFlushMappedBufferRange */
+  void flush(FlushMode mode = kSubData);
+
+  /// Returns the shadow copy.
+  GLubyte* shadow() { return shadow_.data(); }
+
+  /// Returns the shadow copy.
+  const GLubyte* shadow() const { return shadow_.data(); }
+
+  /// Returns the size of the shadow copy in bytes.
+  size_t shadowSize() const { return shadow_.size(); }
+
+  /// Sets the maximum distance in bytes between two ranges that are merged.
+  /** Uploading a few unmodified bytes is usually much cheaper than an
+    * additional driver call. */
+  void gapThreshold(size_t gap_threshold) {
+    dirty_ranges_.gapThreshold(gap_threshold);
+  }
+
+  /// Returns the ranges modified since the last flush().
+  const DirtyRanges& dirtyRanges() const { return dirty_ranges_; }
+
+ private:
+  std::vector<GLubyte> shadow_;
+  DirtyRanges dirty_ranges_;
+};
+#endif  // glGenBuffers && glDeleteBuffers
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./shadow_buffer-inl.h"
+
+#endif  // OGLWRAP_SHADOW_BUFFER_H_
@@ -225,6 +225,12 @@ struct ClipDistanceEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR)
+struct ColorEnum {
+  operator FramebufferAttachment() const { return FramebufferAttachment(GL_COLOR); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR_ATTACHMENT0)
 struct ColorAttachment0Enum {
   operator ColorBuffer() const { return ColorBuffer(GL_COLOR_ATTACHMENT0); }
@@ -391,6 +397,36 @@ struct CompressedRgbaEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+struct CompressedRgbaBptcUnormEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RGBA_BPTC_UNORM); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+struct CompressedRgbaS3TcDxt1ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+struct CompressedRgbaS3TcDxt3ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+struct CompressedRgbaS3TcDxt5ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+struct CompressedRgbS3TcDxt1ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RGB_S3TC_DXT1_EXT); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RG_RGTC2)
 struct CompressedRgRgtc2Enum {
   operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_RG_RGTC2); }
@@ -421,6 +457,36 @@ struct CompressedSrgbAlphaEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM)
+struct CompressedSrgbAlphaBptcUnormEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT)
+struct CompressedSrgbAlphaS3TcDxt1ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT)
+struct CompressedSrgbAlphaS3TcDxt3ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT)
+struct CompressedSrgbAlphaS3TcDxt5ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT)
+struct CompressedSrgbS3TcDxt1ExtEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPUTE_SHADER)
 struct ComputeShaderEnum {
   operator ShaderType() const { return ShaderType(GL_COMPUTE_SHADER); }
@@ -499,6 +565,24 @@ struct DecrWrapEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH)
+struct DepthEnum {
+  operator FramebufferAttachment() const { return FramebufferAttachment(GL_DEPTH); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH24_STENCIL8)
+struct Depth24Stencil8Enum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH24_STENCIL8); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH32F_STENCIL8)
+struct Depth32FStencil8Enum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH32F_STENCIL8); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_ATTACHMENT)
 struct DepthAttachmentEnum {
   operator FramebufferAttachment() const { return FramebufferAttachment(GL_DEPTH_ATTACHMENT); }
@@ -524,6 +608,30 @@ struct DepthComponentEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT16)
+struct DepthComponent16Enum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH_COMPONENT16); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT24)
+struct DepthComponent24Enum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH_COMPONENT24); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32)
+struct DepthComponent32Enum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH_COMPONENT32); }
+};
+#endif
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32F)
+struct DepthComponent32FEnum {
+  operator PixelDataInternalFormat() const { return PixelDataInternalFormat(GL_DEPTH_COMPONENT32F); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL)
 struct DepthStencilEnum {
   operator PixelDataFormat() const { return PixelDataFormat(GL_DEPTH_STENCIL); }
@@ -1983,6 +2091,12 @@ struct StaticReadEnum {
 };
 #endif
 
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL)
+struct StencilEnum {
+  operator FramebufferAttachment() const { return FramebufferAttachment(GL_STENCIL); }
+};
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL_ATTACHMENT)
 struct StencilAttachmentEnum {
   operator FramebufferAttachment() const { return FramebufferAttachment(GL_STENCIL_ATTACHMENT); }
@@ -2527,6 +2641,9 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_CLIP_DISTANCE)
   static smart_enums::ClipDistanceEnum kClipDistance;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR)
+  static smart_enums::ColorEnum kColor;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR_ATTACHMENT0)
   static smart_enums::ColorAttachment0Enum kColorAttachment0;
 #endif
@@ -2602,6 +2719,21 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA)
   static smart_enums::CompressedRgbaEnum kCompressedRgba;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+  static smart_enums::CompressedRgbaBptcUnormEnum kCompressedRgbaBptcUnorm;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+  static smart_enums::CompressedRgbaS3TcDxt1ExtEnum kCompressedRgbaS3TcDxt1Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+  static smart_enums::CompressedRgbaS3TcDxt3ExtEnum kCompressedRgbaS3TcDxt3Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+  static smart_enums::CompressedRgbaS3TcDxt5ExtEnum kCompressedRgbaS3TcDxt5Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+  static smart_enums::CompressedRgbS3TcDxt1ExtEnum kCompressedRgbS3TcDxt1Ext;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RG_RGTC2)
   static smart_enums::CompressedRgRgtc2Enum kCompressedRgRgtc2;
 #endif
@@ -2617,6 +2749,21 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA)
   static smart_enums::CompressedSrgbAlphaEnum kCompressedSrgbAlpha;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM)
+  static smart_enums::CompressedSrgbAlphaBptcUnormEnum kCompressedSrgbAlphaBptcUnorm;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT)
+  static smart_enums::CompressedSrgbAlphaS3TcDxt1ExtEnum kCompressedSrgbAlphaS3TcDxt1Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT)
+  static smart_enums::CompressedSrgbAlphaS3TcDxt3ExtEnum kCompressedSrgbAlphaS3TcDxt3Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT)
+  static smart_enums::CompressedSrgbAlphaS3TcDxt5ExtEnum kCompressedSrgbAlphaS3TcDxt5Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT)
+  static smart_enums::CompressedSrgbS3TcDxt1ExtEnum kCompressedSrgbS3TcDxt1Ext;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPUTE_SHADER)
   static smart_enums::ComputeShaderEnum kComputeShader;
 #endif
@@ -2656,6 +2803,15 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DECR_WRAP)
   static smart_enums::DecrWrapEnum kDecrWrap;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH)
+  static smart_enums::DepthEnum kDepth;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH24_STENCIL8)
+  static smart_enums::Depth24Stencil8Enum kDepth24Stencil8;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH32F_STENCIL8)
+  static smart_enums::Depth32FStencil8Enum kDepth32FStencil8;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_ATTACHMENT)
   static smart_enums::DepthAttachmentEnum kDepthAttachment;
 #endif
@@ -2668,6 +2824,18 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT)
   static smart_enums::DepthComponentEnum kDepthComponent;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT16)
+  static smart_enums::DepthComponent16Enum kDepthComponent16;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT24)
+  static smart_enums::DepthComponent24Enum kDepthComponent24;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32)
+  static smart_enums::DepthComponent32Enum kDepthComponent32;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32F)
+  static smart_enums::DepthComponent32FEnum kDepthComponent32F;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL)
   static smart_enums::DepthStencilEnum kDepthStencil;
 #endif
@@ -3385,6 +3553,9 @@ struct ZeroEnum {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STATIC_READ)
   static smart_enums::StaticReadEnum kStaticRead;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL)
+  static smart_enums::StencilEnum kStencil;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL_ATTACHMENT)
   static smart_enums::StencilAttachmentEnum kStencilAttachment;
 #endif
@@ -3688,6 +3859,9 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_CLIP_DISTANCE)
   (void) kClipDistance;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR)
+  (void) kColor;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COLOR_ATTACHMENT0)
   (void) kColorAttachment0;
 #endif
@@ -3763,6 +3937,21 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA)
   (void) kCompressedRgba;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+  (void) kCompressedRgbaBptcUnorm;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+  (void) kCompressedRgbaS3TcDxt1Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+  (void) kCompressedRgbaS3TcDxt3Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+  (void) kCompressedRgbaS3TcDxt5Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+  (void) kCompressedRgbS3TcDxt1Ext;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_RG_RGTC2)
   (void) kCompressedRgRgtc2;
 #endif
@@ -3778,6 +3967,21 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA)
   (void) kCompressedSrgbAlpha;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM)
+  (void) kCompressedSrgbAlphaBptcUnorm;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT)
+  (void) kCompressedSrgbAlphaS3TcDxt1Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT)
+  (void) kCompressedSrgbAlphaS3TcDxt3Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT)
+  (void) kCompressedSrgbAlphaS3TcDxt5Ext;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT)
+  (void) kCompressedSrgbS3TcDxt1Ext;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_COMPUTE_SHADER)
   (void) kComputeShader;
 #endif
@@ -3817,6 +4021,15 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DECR_WRAP)
   (void) kDecrWrap;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH)
+  (void) kDepth;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH24_STENCIL8)
+  (void) kDepth24Stencil8;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH32F_STENCIL8)
+  (void) kDepth32FStencil8;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_ATTACHMENT)
   (void) kDepthAttachment;
 #endif
@@ -3829,6 +4042,18 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT)
   (void) kDepthComponent;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT16)
+  (void) kDepthComponent16;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT24)
+  (void) kDepthComponent24;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32)
+  (void) kDepthComponent32;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_COMPONENT32F)
+  (void) kDepthComponent32F;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL)
   (void) kDepthStencil;
 #endif
@@ -4546,6 +4771,9 @@ template<typename T> static void _OGLWRAP_SUPPRESS_UNUSED() {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STATIC_READ)
   (void) kStaticRead;
 #endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL)
+  (void) kStencil;
+#endif
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_STENCIL_ATTACHMENT)
   (void) kStencilAttachment;
 #endif
@@ -0,0 +1,120 @@
+// Copyright (c) Tamas Csala
+
+/** @file sync.h
+    @brief Implements a wrapper around OpenGL fence sync objects.
+*/
+
+#ifndef OGLWRAP_SYNC_H_
+#define OGLWRAP_SYNC_H_
+
+#include <utility>
+
+#include "./config.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync))
+/// A fence, that becomes signaled when the commands issued before it finish.
+/** @see glFenceSync, glDeleteSync
+  * @version OpenGL 3.2 */
+class Sync {
+ public:
+  /// Inserts a new fence into the command stream.
+  /** @see glFenceSync */
+  Sync() {
+    sync_ = gl(FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  }
+
+  /// Deletes the fence.
+  /** @see glDeleteSync */
+  ~Sync() {
+    if (sync_) {
+      gl(DeleteSync(sync_));
+    }
+  }
+
+  Sync(const Sync&) = delete;
+  Sync& operator=(const Sync&) = delete;
+
+  /// Moves a fence.
+  Sync(Sync&& other) noexcept : sync_(other.sync_) {
+    other.sync_ = nullptr;
+  }
+
+  /// Moves a fence.
+  Sync& operator=(Sync&& other) noexcept {
+    std::swap(sync_, other.sync_);
+    return *this;
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glGetSynciv)
+  /// Returns true if the commands before the fence have finished.
+  /** Never blocks, but doesn't flush the command stream either, so if nothing
+    * else flushes it, the fence might never become signaled.
+    * @see glGetSynciv, GL_SYNC_STATUS */
+  bool signaled() const {
+    GLint status = GL_UNSIGNALED;
+    gl(GetSynciv(sync_, GL_SYNC_STATUS, 1, nullptr, &status));
+    return status == GL_SIGNALED;
+  }
+#endif  // glGetSynciv
+
+  /// Waits on the client side until the fence becomes signaled.
+  /** @param timeout  The maximum time to wait in nanoseconds. Zero only polls
+    *                 the state of the fence.
+    * @param flush    Specifies if the command stream should be flushed, so
+    *                 that the fence surely becomes signaled eventually.
+    * @return GL_ALREADY_SIGNALED, GL_CONDITION_SATISFIED, GL_TIMEOUT_EXPIRED
+    *         or GL_WAIT_FAILED. A failed wait fails again if it's retried.
+    * @see glClientWaitSync */
+  GLenum clientWaitStatus(GLuint64 timeout, bool flush = true) const {
+    GLenum result = gl(ClientWaitSync(
+        sync_, flush ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout));
+#if OGLWRAP_DEBUG
+    if (result == GL_WAIT_FAILED) {
+      OGLWRAP_PRINT_ERROR("Fence wait failed",
+        "glClientWaitSync returned GL_WAIT_FAILED. Is the sync object valid?");
+    }
+#endif
+    return result;
+  }
+
+  /// Waits on the client side until the fence becomes signaled.
+  /** @param timeout  The maximum time to wait in nanoseconds. Zero only polls
+    *                 the state of the fence.
+    * @param flush    Specifies if the command stream should be flushed, so
+    *                 that the fence surely becomes signaled eventually.
+    * @return True if the fence is signaled. False if the timeout expired, or
+    *         the wait failed (see clientWaitStatus() to tell them apart).
+    * @see glClientWaitSync */
+  bool clientWait(GLuint64 timeout, bool flush = true) const {
+    GLenum result = clientWaitStatus(timeout, flush);
+    return result == GL_ALREADY_SIGNALED ||
+           result == GL_CONDITION_SATISFIED;
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glWaitSync)
+  /// Makes the server wait for the fence before executing further commands.
+  /** Doesn't block the client.
+    * @see glWaitSync */
+  void serverWait() const {
+    gl(WaitSync(sync_, 0, GL_TIMEOUT_IGNORED));
+  }
+#endif  // glWaitSync
+
+  /// Returns the C handle for the fence.
+  GLsync expose() const { return sync_; }
+
+ private:
+  GLsync sync_;
+};
+#endif  // glFenceSync && glDeleteSync && glClientWaitSync
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_SYNC_H_
@@ -0,0 +1,295 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURE_UNITS_INL_H_
+#define OGLWRAP_TEXTURE_UNITS_INL_H_
+
+#include <algorithm>
+
+#include "./texture_units.h"
+#include "context/extensions.h"
+#include "debug/bind_checking.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline bool IsSamplerType(GLenum uniform_type) {
+  switch (uniform_type) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SAMPLER_2D_SHADOW)
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SAMPLER_2D_ARRAY)
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SAMPLER_BUFFER)
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SAMPLER_2D_MULTISAMPLE)
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_SAMPLER_CUBE_MAP_ARRAY)
+    case GL_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+    case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetProgramiv) \
+    && defined(glGetActiveUniform) && defined(glGetUniformLocation) \
+    && defined(glUniform1iv))
+inline TextureUnitAllocator::TextureUnitAllocator(const Program& program,
+                                                  GLuint first_unit)
+    : first_unit_(first_unit) {
+  OGLWRAP_CHECK_BINDING_EXPLICIT(program);
+
+  GLint uniform_count = 0, max_length = 0;
+  gl(GetProgramiv(program.expose(), GL_ACTIVE_UNIFORMS, &uniform_count));
+  gl(GetProgramiv(program.expose(), GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+  std::vector<GLchar> name_buffer(max_length + 1);
+
+  GLuint next_unit = first_unit;
+  for (GLint i = 0; i < uniform_count; ++i) {
+    GLint size = 0;
+    GLenum type = 0;
+    GLsizei length = 0;
+    gl(GetActiveUniform(program.expose(), i, name_buffer.size(), &length,
+                        &size, &type, name_buffer.data()));
+    if (!IsSamplerType(type)) {
+      continue;
+    }
+
+    std::string name(name_buffer.data(), length);
+    GLint location = gl(GetUniformLocation(program.expose(), name.c_str()));
+    if (location == -1) {
+      continue;
+    }
+
+    std::vector<GLint> units(size);
+    for (GLint j = 0; j < size; ++j) {
+      units[j] = next_unit + j;
+    }
+    gl(Uniform1iv(location, size, units.data()));
+
+    // Arrays are reported by the name of their first element.
+    const char kArraySuffix[] = "[0]";
+    size_t suffix_length = sizeof(kArraySuffix) - 1;
+    if (name.size() > suffix_length &&
+        name.compare(name.size() - suffix_length, suffix_length,
+                     kArraySuffix) == 0) {
+      name.resize(name.size() - suffix_length);
+    }
+    units_[name] = next_unit;
+    next_unit += size;
+  }
+  unit_count_ = next_unit - first_unit;
+}
+
+inline GLint TextureUnitAllocator::unit(const std::string& name) const {
+  auto iter = units_.find(name);
+  return iter == units_.end() ? -1 : GLint(iter->second);
+}
+#endif
+
+inline TextureBindingCache::TextureBindingCache() {
+  GLint unit_count = 0;
+  gl(GetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &unit_count));
+  units_.resize(unit_count);
+  multi_bind_ = DetectMultiBind();
+}
+
+inline bool TextureBindingCache::DetectMultiBind() {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBindTextures)
+  GLint major = 0, minor = 0;
+  gl(GetIntegerv(GL_MAJOR_VERSION, &major));
+  gl(GetIntegerv(GL_MINOR_VERSION, &minor));
+  if (major > 4 || (major == 4 && minor >= 4)) {
+    return true;
+  }
+
+  return IsExtensionSupported("GL_ARB_multi_bind");
+#else
+  return false;
+#endif
+}
+
+inline bool TextureBindingCache::validUnit(GLuint tex_unit) const {
+  if (tex_unit < units_.size()) {
+    return true;
+  }
+#if OGLWRAP_DEBUG
+  OGLWRAP_PRINT_ERROR("Invalid texture unit",
+    "TextureBindingCache was used with texture unit " +
+    std::to_string(tex_unit) + ", but the context only has " +
+    std::to_string(units_.size()) + " units.");
+#endif
+  return false;
+}
+
+inline void TextureBindingCache::activate(GLuint tex_unit) {
+  if (!active_unit_known_ || GLuint(active_unit_) != tex_unit) {
+    gl(ActiveTexture(GL_TEXTURE0 + tex_unit));
+    active_unit_ = tex_unit;
+    active_unit_known_ = true;
+  }
+}
+
+inline void TextureBindingCache::bindTexture(GLuint tex_unit, GLuint texture,
+                                             GLenum target) {
+  Unit& unit = units_[tex_unit];
+  if (unit.matches(texture, target)) {
+    return;
+  }
+  activate(tex_unit);
+  gl(BindTexture(target, texture));
+  unit.texture = texture;
+  unit.target = target;
+  unit.known = true;
+}
+
+template <TextureType TEXTURE_TYPE>
+void TextureBindingCache::bind(const TextureBase<TEXTURE_TYPE>& tex,
+                               GLuint tex_unit) {
+  if (validUnit(tex_unit)) {
+    bindTexture(tex_unit, tex.expose(), GLenum(TEXTURE_TYPE));
+  }
+}
+
+inline void TextureBindingCache::unbind(GLuint tex_unit) {
+  if (!validUnit(tex_unit)) {
+    return;
+  }
+  Unit& unit = units_[tex_unit];
+  if (unit.known && unit.texture == 0) {
+    return;
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBindTextures)
+  if (multi_bind_) {
+    // Unbinds the textures from every target of the unit.
+    gl(BindTextures(tex_unit, 1, nullptr));
+    unit = Unit{};
+    return;
+  }
+#endif
+
+  if (unit.target != 0) {
+    activate(tex_unit);
+    gl(BindTexture(unit.target, 0));
+    unit = Unit{};
+  }
+}
+
+inline void TextureBindingCache::stageTexture(GLuint tex_unit, GLuint texture,
+                                              GLenum target) {
+  for (StagedBinding& binding : staged_) {
+    if (binding.unit == tex_unit) {
+      binding.texture = texture;
+      binding.target = target;
+      return;
+    }
+  }
+  staged_.push_back(StagedBinding{tex_unit, texture, target});
+}
+
+template <TextureType TEXTURE_TYPE>
+void TextureBindingCache::stage(const TextureBase<TEXTURE_TYPE>& tex,
+                                GLuint tex_unit) {
+  if (validUnit(tex_unit)) {
+    stageTexture(tex_unit, tex.expose(), GLenum(TEXTURE_TYPE));
+  }
+}
+
+inline void TextureBindingCache::flush() {
+  // Drop the bindings that are already in place.
+  staged_.erase(std::remove_if(staged_.begin(), staged_.end(),
+    [this](const StagedBinding& binding) {
+      return units_[binding.unit].matches(binding.texture, binding.target);
+    }), staged_.end());
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glBindTextures)
+  if (multi_bind_) {
+    std::sort(staged_.begin(), staged_.end(),
+              [](const StagedBinding& a, const StagedBinding& b) {
+                return a.unit < b.unit;
+              });
+
+    // Every run of consecutive units is bound with a single call, the units
+    // outside the runs are left untouched.
+    std::vector<GLuint> textures;
+    size_t run_begin = 0;
+    for (size_t i = 0; i < staged_.size(); ++i) {
+      textures.push_back(staged_[i].texture);
+      Unit& unit = units_[staged_[i].unit];
+      unit.texture = staged_[i].texture;
+      unit.target = staged_[i].target;
+      unit.known = true;
+
+      bool run_ends = i + 1 == staged_.size() ||
+                      staged_[i + 1].unit != staged_[i].unit + 1;
+      if (run_ends) {
+        gl(BindTextures(staged_[run_begin].unit, textures.size(),
+                        textures.data()));
+        textures.clear();
+        run_begin = i + 1;
+      }
+    }
+    staged_.clear();
+    return;
+  }
+#endif
+
+  for (const StagedBinding& binding : staged_) {
+    bindTexture(binding.unit, binding.texture, binding.target);
+  }
+  staged_.clear();
+}
+
+inline void TextureBindingCache::invalidate() {
+  for (Unit& unit : units_) {
+    unit.known = false;
+  }
+  active_unit_known_ = false;
+}
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURE_UNITS_INL_H_
@@ -0,0 +1,149 @@
+// Copyright (c) Tamas Csala
+
+/** @file texture_units.h
+    @brief Implements texture unit assignment for programs, and a cache of the
+           textures bound to the texture units of a context.
+*/
+
+#ifndef OGLWRAP_TEXTURE_UNITS_H_
+#define OGLWRAP_TEXTURE_UNITS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "./config.h"
+#include "./program.h"
+#include "textures/texture_base.h"
+#include "context/binding.h"
+
+#include "./define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Returns true if a uniform of the given type is a sampler.
+/** @param uniform_type - A type returned by glGetActiveUniform. */
+bool IsSamplerType(GLenum uniform_type);
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glGetProgramiv) \
+    && defined(glGetActiveUniform) && defined(glGetUniformLocation) \
+    && defined(glUniform1iv))
+/// Assigns a texture unit to every sampler uniform of a program.
+/** The samplers are found through the reflection of the program, and each one
+  * gets its own unit (arrays of samplers get consecutive units), so textures
+  * don't have to be assigned to units by hand. */
+class TextureUnitAllocator {
+ public:
+  /// Assigns the units, and sets the sampler uniforms to them.
+  /** The program must be linked, and should be in use.
+    * @param program - The program whose samplers get the units.
+    * @param first_unit - The first texture unit to assign.
+    * @see glGetActiveUniform, glUniform1iv */
+  explicit TextureUnitAllocator(const Program& program, GLuint first_unit = 0);
+
+  /// Returns the unit assigned to a sampler, or -1 if there is no such sampler.
+  /** @param name - The name of the sampler uniform. For arrays of samplers,
+    *               the unit of the first element is returned. */
+  GLint unit(const std::string& name) const;
+
+  /// Returns the first unit assigned.
+  GLuint firstUnit() const { return first_unit_; }
+
+  /// Returns the number of units assigned.
+  GLuint unitCount() const { return unit_count_; }
+
+ private:
+  std::map<std::string, GLuint> units_;
+  GLuint first_unit_;
+  GLuint unit_count_ = 0;
+};
+#endif
+
+/// A shadow copy of the textures bound to the texture units of a context.
+/** Binding a texture, that is already bound to a unit doesn't call any GL
+  * function, and glActiveTexture is only called if the active unit changes.
+  * Staged bindings are sent with as few glBindTextures calls (ARB_multi_bind)
+  * as possible, if it is supported.
+  *
+  * The cache only works if the textures are bound through it. Call
+  * invalidate() after the texture bindings are changed in any other way.
+  * Only one texture per unit is tracked. */
+class TextureBindingCache {
+ public:
+  /// Creates a cache for the current context.
+  /** The context is expected to have no textures bound yet.
+    * @see GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, GL_ARB_multi_bind */
+  TextureBindingCache();
+
+  template <TextureType TEXTURE_TYPE>
+  /// Binds a texture to a unit if it isn't already bound there.
+  /** @param tex - The texture to bind.
+    * @param tex_unit - The texture unit to bind to.
+    * @see glActiveTexture, glBindTexture */
+  void bind(const TextureBase<TEXTURE_TYPE>& tex, GLuint tex_unit);
+
+  /// Unbinds the texture from a unit.
+  /** @param tex_unit - The texture unit.
+    * @see glActiveTexture, glBindTexture */
+  void unbind(GLuint tex_unit);
+
+  template <TextureType TEXTURE_TYPE>
+  /// Stages a texture to be bound to a unit by the next flush().
+  /** glBindTextures only accepts textures, that were bound at least once
+    * before (or were created with OGLWRAP_USE_DSA).
+    * @param tex - The texture to bind.
+    * @param tex_unit - The texture unit to bind to. */
+  void stage(const TextureBase<TEXTURE_TYPE>& tex, GLuint tex_unit);
+
+  /// Binds the staged textures, that aren't already bound.
+  /** Consecutive units are bound with one glBindTextures call if
+    * ARB_multi_bind is supported.
+    * @see glBindTextures, glActiveTexture, glBindTexture */
+  void flush();
+
+  /// Forgets the shadowed bindings, so every unit is rebound on the next use.
+  void invalidate();
+
+  /// Returns the number of texture units of the context.
+  GLuint unitCount() const { return units_.size(); }
+
+  /// Returns true if glBindTextures is used for flushing the staged bindings.
+  bool hasMultiBind() const { return multi_bind_; }
+
+ private:
+  struct Unit {
+    GLuint texture = 0;
+    GLenum target = 0;
+    bool known = true;  // false if the binding might have changed outside
+
+    bool matches(GLuint other_texture, GLenum other_target) const {
+      return known && texture == other_texture && target == other_target;
+    }
+  };
+
+  struct StagedBinding {
+    GLuint unit;
+    GLuint texture;
+    GLenum target;
+  };
+
+  std::vector<Unit> units_;
+  std::vector<StagedBinding> staged_;
+  GLint active_unit_ = 0;
+  bool active_unit_known_ = true;
+  bool multi_bind_ = false;
+
+  bool validUnit(GLuint tex_unit) const;
+  void activate(GLuint tex_unit);
+  void bindTexture(GLuint tex_unit, GLuint texture, GLenum target);
+  void stageTexture(GLuint tex_unit, GLuint texture, GLenum target);
+
+  static bool DetectMultiBind();
+};
+
+}  // namespace oglwrap
+
+#include "./undefine_internal_macros.h"
+#include "./texture_units-inl.h"
+
+#endif  // OGLWRAP_TEXTURE_UNITS_H_
@@ -0,0 +1,697 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_BLOCK_COMPRESSION_INL_H_
+#define OGLWRAP_TEXTURES_BLOCK_COMPRESSION_INL_H_
+
+#include <cmath>
+#include <thread>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+#include "./block_compression.h"
+#include "./mipmap_generator.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline GLsizei GetBlockSize(BlockFormat format) {
+  return format == BlockFormat::kBc1 || format == BlockFormat::kBc4 ? 8 : 16;
+}
+
+inline size_t GetCompressedSize(BlockFormat format, GLsizei width,
+                                GLsizei height) {
+  return size_t((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+inline PixelDataInternalFormat GetCompressedInternalFormat(BlockFormat format,
+                                                           bool srgb) {
+  using InternalFormat = PixelDataInternalFormat;
+  switch (format) {
+    case BlockFormat::kBc1:
+      return srgb ? InternalFormat::kCompressedSrgbS3TcDxt1Ext
+                  : InternalFormat::kCompressedRgbS3TcDxt1Ext;
+    case BlockFormat::kBc3:
+      return srgb ? InternalFormat::kCompressedSrgbAlphaS3TcDxt5Ext
+                  : InternalFormat::kCompressedRgbaS3TcDxt5Ext;
+    case BlockFormat::kBc4:
+      return InternalFormat::kCompressedRedRgtc1;
+    case BlockFormat::kBc5:
+      return InternalFormat::kCompressedRgRgtc2;
+    case BlockFormat::kBc7:
+      return srgb ? InternalFormat::kCompressedSrgbAlphaBptcUnorm
+                  : InternalFormat::kCompressedRgbaBptcUnorm;
+  }
+  return InternalFormat::kCompressedRgba;
+}
+#endif
+
+/// Copies the RGBA texels of a 4x4 block, repeating the edges of the image.
+inline void OGLWRAP_FetchBlock(const GLubyte* rgba, GLsizei width,
+                               GLsizei height, GLsizei block_x,
+                               GLsizei block_y, GLubyte* block) {
+  for (GLsizei y = 0; y < 4; ++y) {
+    GLsizei src_y = std::min(block_y*4 + y, height - 1);
+    for (GLsizei x = 0; x < 4; ++x) {
+      GLsizei src_x = std::min(block_x*4 + x, width - 1);
+      std::memcpy(block + (y*4 + x)*4,
+                  rgba + (size_t(src_y) * width + src_x) * 4, 4);
+    }
+  }
+}
+
+/// Finds the closest color of a palette to every texel of a block.
+/** Four texels are compared to a color at once, with SSE2 or NEON where they
+  * are available. The squared errors are integers below 2^24, so they are
+  * exact as floats, and the result matches a scalar search (on ties, the
+  * lower index wins).
+  * @param block - The RGBA texels of the block.
+  * @param first_channel - The first channel to compare.
+  * @param channels - The number of channels to compare.
+  * @param palette - The colors, each with channels values.
+  * @param palette_size - The number of colors.
+  * @param indices - Returns the index of the closest color for every texel.
+  * @return The squared error of the block. */
+inline int OGLWRAP_ChooseIndices(const GLubyte* block, int first_channel,
+                                 int channels, const float* palette,
+                                 int palette_size, int* indices) {
+  // The channels are separated, so a vector holds the same channel of four
+  // texels.
+  alignas(16) float planes[4][16];
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < channels; ++c) {
+      planes[c][i] = block[i*4 + first_channel + c];
+    }
+  }
+
+  int error = 0;
+  for (int i = 0; i < 16; i += 4) {
+    OGLWRAP_Float4 texels[4];
+    for (int c = 0; c < channels; ++c) {
+      texels[c] = OGLWRAP_Float4::Load(planes[c] + i);
+    }
+
+    OGLWRAP_Float4 best = OGLWRAP_Float4::Splat(0.0f);
+    OGLWRAP_Float4 best_error = OGLWRAP_Float4::Splat(1e30f);
+    for (int k = 0; k < palette_size; ++k) {
+      OGLWRAP_Float4 texel_error = OGLWRAP_Float4::Splat(0.0f);
+      for (int c = 0; c < channels; ++c) {
+        OGLWRAP_Float4 diff =
+            texels[c] - OGLWRAP_Float4::Splat(palette[k*channels + c]);
+        texel_error = texel_error + diff * diff;
+      }
+      best = OGLWRAP_Float4::SelectLess(texel_error, best_error,
+                                        OGLWRAP_Float4::Splat(float(k)), best);
+      best_error = OGLWRAP_Float4::Min(texel_error, best_error);
+    }
+
+    float best_values[4], error_values[4];
+    best.store(best_values);
+    best_error.store(error_values);
+    for (int j = 0; j < 4; ++j) {
+      indices[i + j] = int(best_values[j]);
+      error += int(error_values[j]);
+    }
+  }
+  return error;
+}
+
+/// Finds the line, that fits the texels of a block the best.
+/** @param block - The RGBA texels of the block.
+  * @param channels - The number of channels to consider.
+  * @param min, max - Return the ends of the segment of the line, that the
+  *                   texels project to. */
+inline void OGLWRAP_FitLine(const GLubyte* block, int channels,
+                            float* min, float* max) {
+  float mean[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < channels; ++c) {
+      mean[c] += block[i*4 + c] / 16.0f;
+    }
+  }
+
+  float covariance[4][4] = {};
+  for (int i = 0; i < 16; ++i) {
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        covariance[a][b] +=
+            (block[i*4 + a] - mean[a]) * (block[i*4 + b] - mean[b]);
+      }
+    }
+  }
+
+  // The principal axis is found with power iteration, starting from the
+  // channel with the largest variance.
+  int start = 0;
+  for (int c = 1; c < channels; ++c) {
+    if (covariance[c][c] > covariance[start][start]) {
+      start = c;
+    }
+  }
+  float axis[4] = {};
+  for (int c = 0; c < channels; ++c) {
+    axis[c] = covariance[start][c];
+  }
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    float next[4] = {}, largest = 0.0f;
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        next[a] += covariance[a][b] * axis[b];
+      }
+      largest = std::max(largest, std::abs(next[a]));
+    }
+    if (largest == 0.0f) {
+      break;
+    }
+    for (int c = 0; c < channels; ++c) {
+      axis[c] = next[c] / largest;
+    }
+  }
+
+  float length_sqr = 0.0f;
+  for (int c = 0; c < channels; ++c) {
+    length_sqr += axis[c] * axis[c];
+  }
+  if (length_sqr == 0.0f) {  // every texel is the same
+    for (int c = 0; c < channels; ++c) {
+      min[c] = max[c] = mean[c];
+    }
+    return;
+  }
+
+  float min_t = 0.0f, max_t = 0.0f;
+  for (int i = 0; i < 16; ++i) {
+    float t = 0.0f;
+    for (int c = 0; c < channels; ++c) {
+      t += (block[i*4 + c] - mean[c]) * axis[c];
+    }
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+  }
+  for (int c = 0; c < channels; ++c) {
+    min[c] = std::min(std::max(mean[c] + axis[c] * min_t / length_sqr, 0.0f),
+                      255.0f);
+    max[c] = std::min(std::max(mean[c] + axis[c] * max_t / length_sqr, 0.0f),
+                      255.0f);
+  }
+}
+
+/// Computes the endpoints, whose interpolation fits the texels the best in
+/// the least squares sense.
+/** @param block - The RGBA texels of the block.
+  * @param weights - The weight of the second endpoint for every texel.
+  * @param channels - The number of channels to fit.
+  * @param first, second - Return the endpoints.
+  * @return False if every texel uses the same weight. */
+inline bool OGLWRAP_FitEndpoints(const GLubyte* block, const float* weights,
+                                 int channels, float* first, float* second) {
+  float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+  float ax[4] = {}, bx[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    float a = 1.0f - weights[i], b = weights[i];
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int c = 0; c < channels; ++c) {
+      ax[c] += a * block[i*4 + c];
+      bx[c] += b * block[i*4 + c];
+    }
+  }
+
+  float determinant = aa * bb - ab * ab;
+  if (std::abs(determinant) < 1e-6f) {
+    return false;
+  }
+  for (int c = 0; c < channels; ++c) {
+    first[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) / determinant,
+                                 0.0f), 255.0f);
+    second[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) / determinant,
+                                  0.0f), 255.0f);
+  }
+  return true;
+}
+
+/// Quantizes a color to RGB565.
+inline GLushort OGLWRAP_PackRgb565(const float* color) {
+  GLuint r = GLuint(color[0] * 31.0f / 255.0f + 0.5f);
+  GLuint g = GLuint(color[1] * 63.0f / 255.0f + 0.5f);
+  GLuint b = GLuint(color[2] * 31.0f / 255.0f + 0.5f);
+  return GLushort((r << 11) | (g << 5) | b);
+}
+
+/// Expands an RGB565 color to 8 bits per channel, as the GPU does.
+inline void OGLWRAP_UnpackRgb565(GLushort packed, int* color) {
+  int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+}
+
+/// Chooses the indices of a four color BC1 block.
+/** @return The squared error of the block. */
+inline int OGLWRAP_ChooseBc1Indices(const GLubyte* block, GLushort color0,
+                                    GLushort color1, GLuint* indices) {
+  int endpoints[2][3];
+  OGLWRAP_UnpackRgb565(color0, endpoints[0]);
+  OGLWRAP_UnpackRgb565(color1, endpoints[1]);
+  float palette[4][3];
+  for (int c = 0; c < 3; ++c) {
+    palette[0][c] = endpoints[0][c];
+    palette[1][c] = endpoints[1][c];
+    palette[2][c] = (2*endpoints[0][c] + endpoints[1][c]) / 3;
+    palette[3][c] = (endpoints[0][c] + 2*endpoints[1][c]) / 3;
+  }
+
+  int texel_indices[16];
+  int error = OGLWRAP_ChooseIndices(block, 0, 3, palette[0], 4,
+                                    texel_indices);
+  *indices = 0;
+  for (int i = 0; i < 16; ++i) {
+    *indices |= GLuint(texel_indices[i]) << (2*i);
+  }
+  return error;
+}
+
+/// Compresses the RGB channels of a block to BC1, always using four colors.
+inline void OGLWRAP_EncodeBc1(const GLubyte* block, GLubyte* out) {
+  float min[4], max[4];
+  OGLWRAP_FitLine(block, 3, min, max);
+  GLushort color0 = OGLWRAP_PackRgb565(max);
+  GLushort color1 = OGLWRAP_PackRgb565(min);
+  if (color0 < color1) {
+    std::swap(color0, color1);
+  }
+
+  // If the endpoints are the same, every index is 0.
+  GLuint indices = 0;
+  if (color0 != color1) {
+    int error = OGLWRAP_ChooseBc1Indices(block, color0, color1, &indices);
+
+    // Refit the endpoints to the chosen indices once.
+    static const float kWeights[4] = {0.0f, 1.0f, 1/3.0f, 2/3.0f};
+    float weights[16];
+    for (int i = 0; i < 16; ++i) {
+      weights[i] = kWeights[(indices >> (2*i)) & 3];
+    }
+    float first[4], second[4];
+    if (OGLWRAP_FitEndpoints(block, weights, 3, first, second)) {
+      GLushort refit0 = OGLWRAP_PackRgb565(first);
+      GLushort refit1 = OGLWRAP_PackRgb565(second);
+      if (refit0 < refit1) {
+        std::swap(refit0, refit1);
+      }
+      GLuint refit_indices;
+      if (refit0 != refit1 && OGLWRAP_ChooseBc1Indices(
+            block, refit0, refit1, &refit_indices) < error) {
+        color0 = refit0;
+        color1 = refit1;
+        indices = refit_indices;
+      }
+    }
+  }
+
+  out[0] = color0 & 0xFF;
+  out[1] = color0 >> 8;
+  out[2] = color1 & 0xFF;
+  out[3] = color1 >> 8;
+  for (int i = 0; i < 4; ++i) {
+    out[4 + i] = (indices >> (8*i)) & 0xFF;
+  }
+}
+
+/// Compresses a channel of a block to BC4, using eight values.
+inline void OGLWRAP_EncodeBc4(const GLubyte* block, int channel,
+                              GLubyte* out) {
+  int min = 255, max = 0;
+  for (int i = 0; i < 16; ++i) {
+    min = std::min<int>(min, block[i*4 + channel]);
+    max = std::max<int>(max, block[i*4 + channel]);
+  }
+
+  uint64_t indices = 0;
+  if (min != max) {
+    float palette[8] = {float(max), float(min)};
+    for (int k = 2; k < 8; ++k) {
+      palette[k] = ((8 - k) * max + (k - 1) * min + 3) / 7;
+    }
+    int texel_indices[16];
+    OGLWRAP_ChooseIndices(block, channel, 1, palette, 8, texel_indices);
+    for (int i = 0; i < 16; ++i) {
+      indices |= uint64_t(texel_indices[i]) << (3*i);
+    }
+  }
+
+  out[0] = GLubyte(max);
+  out[1] = GLubyte(min);
+  for (int i = 0; i < 6; ++i) {
+    out[2 + i] = (indices >> (8*i)) & 0xFF;
+  }
+}
+
+/// The interpolation weights of the four bit indices of BC7.
+static const int kOGLWRAP_Bc7Weights[16] = {
+  0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+
+/// Quantizes an endpoint to the 7 bits per channel and the shared p-bit of
+/// BC7 mode 6.
+/** @param value - The RGBA endpoint.
+  * @param quantized - Returns the 7 bit channels.
+  * @param pbit - Returns the p-bit.
+  * @param expanded - Returns the endpoint, as the GPU decodes it. */
+inline void OGLWRAP_QuantizeBc7Endpoint(const float* value, int* quantized,
+                                        int* pbit, int* expanded) {
+  float best_error = 1e30f;
+  for (int p = 0; p < 2; ++p) {
+    int candidate[4];
+    float error = 0.0f;
+    for (int c = 0; c < 4; ++c) {
+      candidate[c] = std::min(std::max(int((value[c] - p) / 2 + 0.5f), 0), 127);
+      float diff = value[c] - (candidate[c]*2 + p);
+      error += diff * diff;
+    }
+    if (error < best_error) {
+      best_error = error;
+      *pbit = p;
+      for (int c = 0; c < 4; ++c) {
+        quantized[c] = candidate[c];
+        expanded[c] = candidate[c]*2 + p;
+      }
+    }
+  }
+}
+
+/// Chooses the indices of a BC7 mode 6 block.
+/** @return The squared error of the block. */
+inline int OGLWRAP_ChooseBc7Indices(const GLubyte* block, const int* first,
+                                    const int* second, int* indices) {
+  float palette[16][4];
+  for (int k = 0; k < 16; ++k) {
+    int weight = kOGLWRAP_Bc7Weights[k];
+    for (int c = 0; c < 4; ++c) {
+      palette[k][c] = ((64 - weight) * first[c] + weight * second[c] + 32) >> 6;
+    }
+  }
+  return OGLWRAP_ChooseIndices(block, 0, 4, palette[0], 16, indices);
+}
+
+/// Writes bit fields to a zero initialized block, starting at the LSB.
+class OGLWRAP_BitWriter {
+ public:
+  explicit OGLWRAP_BitWriter(GLubyte* out) : out_(out) {}
+
+  void write(GLuint value, int bits) {
+    for (int i = 0; i < bits; ++i, ++position_) {
+      if ((value >> i) & 1) {
+        out_[position_ / 8] |= GLubyte(1 << (position_ % 8));
+      }
+    }
+  }
+
+ private:
+  GLubyte* out_;
+  int position_ = 0;
+};
+
+/// Compresses a block to BC7 mode 6 (one subset with RGBA endpoints).
+inline void OGLWRAP_EncodeBc7(const GLubyte* block, GLubyte* out) {
+  float endpoints[2][4];
+  OGLWRAP_FitLine(block, 4, endpoints[0], endpoints[1]);
+
+  int quantized[2][4], pbits[2], expanded[2][4], indices[16];
+  for (int e = 0; e < 2; ++e) {
+    OGLWRAP_QuantizeBc7Endpoint(endpoints[e], quantized[e], &pbits[e],
+                                expanded[e]);
+  }
+  int error = OGLWRAP_ChooseBc7Indices(block, expanded[0], expanded[1],
+                                       indices);
+
+  // Refit the endpoints to the chosen indices once.
+  float weights[16];
+  for (int i = 0; i < 16; ++i) {
+    weights[i] = kOGLWRAP_Bc7Weights[indices[i]] / 64.0f;
+  }
+  float refit[2][4];
+  if (error > 0 && OGLWRAP_FitEndpoints(block, weights, 4, refit[0],
+                                        refit[1])) {
+    int refit_quantized[2][4], refit_pbits[2], refit_expanded[2][4];
+    int refit_indices[16];
+    for (int e = 0; e < 2; ++e) {
+      OGLWRAP_QuantizeBc7Endpoint(refit[e], refit_quantized[e],
+                                  &refit_pbits[e], refit_expanded[e]);
+    }
+    if (OGLWRAP_ChooseBc7Indices(block, refit_expanded[0], refit_expanded[1],
+                                 refit_indices) < error) {
+      std::memcpy(quantized, refit_quantized, sizeof(quantized));
+      std::memcpy(pbits, refit_pbits, sizeof(pbits));
+      std::memcpy(indices, refit_indices, sizeof(indices));
+    }
+  }
+
+  // The most significant bit of the first index is implicitly zero.
+  if (indices[0] & 8) {
+    std::swap(quantized[0], quantized[1]);
+    std::swap(pbits[0], pbits[1]);
+    for (int i = 0; i < 16; ++i) {
+      indices[i] = 15 - indices[i];
+    }
+  }
+
+  std::memset(out, 0, 16);
+  OGLWRAP_BitWriter writer(out);
+  writer.write(1 << 6, 7);  // mode 6
+  for (int c = 0; c < 4; ++c) {
+    writer.write(quantized[0][c], 7);
+    writer.write(quantized[1][c], 7);
+  }
+  writer.write(pbits[0], 1);
+  writer.write(pbits[1], 1);
+  writer.write(indices[0], 3);
+  for (int i = 1; i < 16; ++i) {
+    writer.write(indices[i], 4);
+  }
+}
+
+/// Compresses a range of block rows of an image.
+inline void OGLWRAP_CompressBlockRows(BlockFormat format, const GLubyte* rgba,
+                                      GLsizei width, GLsizei height,
+                                      GLsizei first_row, GLsizei last_row,
+                                      GLubyte* out) {
+  GLsizei blocks_x = (width + 3) / 4;
+  GLsizei block_size = GetBlockSize(format);
+  GLubyte block[64];
+  for (GLsizei y = first_row; y < last_row; ++y) {
+    for (GLsizei x = 0; x < blocks_x; ++x) {
+      OGLWRAP_FetchBlock(rgba, width, height, x, y, block);
+      GLubyte* dst = out + (size_t(y) * blocks_x + x) * block_size;
+      switch (format) {
+        case BlockFormat::kBc1:
+          OGLWRAP_EncodeBc1(block, dst);
+          break;
+        case BlockFormat::kBc3:
+          OGLWRAP_EncodeBc4(block, 3, dst);
+          OGLWRAP_EncodeBc1(block, dst + 8);
+          break;
+        case BlockFormat::kBc4:
+          OGLWRAP_EncodeBc4(block, 0, dst);
+          break;
+        case BlockFormat::kBc5:
+          OGLWRAP_EncodeBc4(block, 0, dst);
+          OGLWRAP_EncodeBc4(block, 1, dst + 8);
+          break;
+        case BlockFormat::kBc7:
+          OGLWRAP_EncodeBc7(block, dst);
+          break;
+      }
+    }
+  }
+}
+
+inline std::vector<GLubyte> CompressImage(BlockFormat format,
+                                          const GLubyte* rgba, GLsizei width,
+                                          GLsizei height, unsigned threads) {
+  std::vector<GLubyte> result(GetCompressedSize(format, width, height));
+  GLsizei rows = (height + 3) / 4;
+  if (threads == 0) {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  threads = std::min<unsigned>(threads, rows);
+
+  if (threads <= 1) {
+    OGLWRAP_CompressBlockRows(format, rgba, width, height, 0, rows,
+                              result.data());
+  } else {
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+      workers.emplace_back(OGLWRAP_CompressBlockRows, format, rgba, width,
+                           height, GLsizei(rows * i / threads),
+                           GLsizei(rows * (i + 1) / threads), result.data());
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+  return result;
+}
+
+inline CompressedImage::CompressedImage(BlockFormat format,
+                                        const GLubyte* rgba, GLsizei width,
+                                        GLsizei height, bool srgb,
+                                        bool mipmaps, unsigned threads)
+    : format_(format), srgb_(srgb) {
+  if (!mipmaps) {
+    levels_.push_back(CompressImage(format, rgba, width, height, threads));
+    widths_.push_back(width);
+    heights_.push_back(height);
+    return;
+  }
+
+  MipmapOptions options;
+  options.srgb = srgb;
+  MipmapChain chain(rgba, width, height, 4, options);
+  for (GLsizei level = 0; level < chain.levelCount(); ++level) {
+    levels_.push_back(CompressImage(format, chain.data(level),
+                                    chain.width(level), chain.height(level),
+                                    threads));
+    widths_.push_back(chain.width(level));
+    heights_.push_back(chain.height(level));
+  }
+}
+
+/// Returns true if a value read from a file is a valid BlockFormat.
+inline bool OGLWRAP_IsBlockFormat(uint32_t value) {
+  return value == 1 || value == 3 || value == 4 || value == 5 || value == 7;
+}
+
+/// Returns the size and the modification time of a file, or zeros.
+inline void OGLWRAP_GetFileStamp(const std::string& path, uint64_t* size,
+                                 int64_t* time) {
+  struct stat info;
+  if (path.empty() || stat(path.c_str(), &info) != 0) {
+    *size = 0;
+    *time = 0;
+  } else {
+    *size = info.st_size;
+    *time = info.st_mtime;
+  }
+}
+
+inline bool CompressedImage::save(const std::string& path,
+                                  const std::string& source) const {
+  std::ofstream file(path.c_str(), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  CompressedImageHeader header;
+  std::memcpy(header.magic, kCompressedImageMagic, sizeof(header.magic));
+  header.version = kCompressedImageVersion;
+  header.format = uint32_t(format_);
+  header.srgb = srgb_;
+  header.width = widths_.empty() ? 0 : widths_[0];
+  header.height = heights_.empty() ? 0 : heights_[0];
+  header.level_count = levels_.size();
+  header.reserved = 0;
+  OGLWRAP_GetFileStamp(source, &header.source_size, &header.source_time);
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const std::vector<GLubyte>& level : levels_) {
+    file.write(reinterpret_cast<const char*>(level.data()), level.size());
+  }
+  return bool(file);
+}
+
+inline bool CompressedImage::load(const std::string& path,
+                                  const std::string& source) {
+  std::ifstream file(path.c_str(), std::ios::binary);
+  CompressedImageHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+
+  uint64_t source_size;
+  int64_t source_time;
+  OGLWRAP_GetFileStamp(source, &source_size, &source_time);
+  BlockFormat format = BlockFormat(header.format);
+  if (std::memcmp(header.magic, kCompressedImageMagic,
+                  sizeof(header.magic)) != 0 ||
+      header.version != kCompressedImageVersion ||
+      !OGLWRAP_IsBlockFormat(header.format) || header.level_count > 32 ||
+      header.source_size != source_size || header.source_time != source_time) {
+    return false;
+  }
+
+  std::vector<std::vector<GLubyte>> levels;
+  std::vector<GLsizei> widths, heights;
+  GLsizei width = header.width, height = header.height;
+  for (uint32_t i = 0; i < header.level_count; ++i) {
+    levels.emplace_back(GetCompressedSize(format, width, height));
+    if (!file.read(reinterpret_cast<char*>(levels.back().data()),
+                   levels.back().size())) {
+      return false;
+    }
+    widths.push_back(width);
+    heights.push_back(height);
+    width = std::max<GLsizei>(width / 2, 1);
+    height = std::max<GLsizei>(height / 2, 1);
+  }
+
+  format_ = format;
+  srgb_ = header.srgb != 0;
+  levels_.swap(levels);
+  widths_.swap(widths);
+  heights_.swap(heights);
+  return true;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glCompressedTexImage2D) \
+    && defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+template<Texture2DType texture_t>
+void CompressedImage::upload(Texture2DBase<texture_t>& texture) const {
+  for (GLsizei level = 0; level < levelCount(); ++level) {
+    texture.uploadCompressedMipmap(level, internalFormat(), widths_[level],
+                                   heights_[level], size(level),
+                                   data(level));
+  }
+  // A single level image leaves the texture's own maximum level alone.
+  if (levelCount() > 1) {
+    texture.maxLevel(levelCount() - 1);
+  }
+}
+#endif
+
+template<typename DecodeFunc>
+CompressedImage LoadCompressedImage(const std::string& source,
+                                    BlockFormat format, DecodeFunc decode,
+                                    bool srgb, bool mipmaps) {
+  std::string cache = source + ".bc" + std::to_string(int(format));
+  CompressedImage image;
+  if (image.load(cache, source) && image.format() == format &&
+      image.srgb() == srgb && image.levelCount() > 0 &&
+      image.levelCount() == (mipmaps ? GetMipmapLevelCount(
+          image.width(0), image.height(0)) : 1)) {
+    return image;
+  }
+
+  std::vector<GLubyte> rgba;
+  GLsizei width = 0, height = 0;
+  if (!decode(&rgba, &width, &height) || width <= 0 || height <= 0) {
+    return CompressedImage();
+  }
+  image = CompressedImage(format, rgba.data(), width, height, srgb, mipmaps);
+  image.save(cache, source);
+  return image;
+}
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_BLOCK_COMPRESSION_INL_H_
@@ -0,0 +1,200 @@
+// Copyright (c) Tamas Csala
+
+/** @file block_compression.h
+    @brief Implements compressing textures to BC formats on the CPU.
+*/
+
+#ifndef OGLWRAP_TEXTURES_BLOCK_COMPRESSION_H_
+#define OGLWRAP_TEXTURES_BLOCK_COMPRESSION_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../config.h"
+#include "./texture_2D.h"
+#include "./mipmap_generator.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The block compressed formats the CPU encoder can produce.
+enum class BlockFormat {
+  /// RGB with 4 bits per texel (S3TC DXT1).
+  kBc1 = 1,
+  /// RGBA with 8 bits per texel (S3TC DXT5).
+  kBc3 = 3,
+  /// A single channel with 4 bits per texel (RGTC1).
+  kBc4 = 4,
+  /// Two channels with 8 bits per texel (RGTC2). Good for normal maps.
+  kBc5 = 5,
+  /// RGBA with 8 bits per texel and much higher quality than BC3 (BPTC).
+  kBc7 = 7
+};
+
+/// Returns the size of a 4x4 block in bytes.
+GLsizei GetBlockSize(BlockFormat format);
+
+/// Returns the size of an image compressed to a block format in bytes.
+size_t GetCompressedSize(BlockFormat format, GLsizei width, GLsizei height);
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+/// Returns the internal format, that matches a block format.
+/** @param format - The block format.
+  * @param srgb - Return the sRGB variant (only exists for BC1, BC3 and BC7). */
+PixelDataInternalFormat GetCompressedInternalFormat(BlockFormat format,
+                                                    bool srgb = false);
+#endif
+
+/// Compresses an image to a block format.
+/** Images, whose size isn't a multiple of four are padded by repeating their
+  * edge texels. BC4 compresses the red channel, BC5 the red and green ones.
+  * @param format - The block format.
+  * @param rgba - The pixels of the image, as tightly packed RGBA bytes.
+  * @param width, height - The size of the image.
+  * @param threads - The number of threads to compress on. 0 means one
+  *                  thread per hardware thread. */
+std::vector<GLubyte> CompressImage(BlockFormat format, const GLubyte* rgba,
+                                   GLsizei width, GLsizei height,
+                                   unsigned threads = 0);
+
+/// The first four bytes of every compressed image cache file.
+static const char kCompressedImageMagic[4] = {'O', 'G', 'B', 'C'};
+
+/// The version of the cache file format, that this header can read and write.
+static const uint32_t kCompressedImageVersion = 1;
+
+/// The header at the beginning of a compressed image cache file.
+/** It's followed by the blocks of every level, starting with the base level.
+  * The integers are stored in the native byte order, so a cache file is only
+  * meant to be read on the machine, that wrote it. A file written with the
+  * other byte order fails the version check, and is recreated. */
+struct CompressedImageHeader {
+  char magic[4];
+  uint32_t version;
+  /// A BlockFormat value.
+  uint32_t format;
+  uint32_t srgb;
+  uint32_t width;
+  uint32_t height;
+  uint32_t level_count;
+  uint32_t reserved;
+  /// The size of the source file, or zero if it isn't known.
+  uint64_t source_size;
+  /// The modification time of the source file, or zero if it isn't known.
+  int64_t source_time;
+};
+static_assert(sizeof(CompressedImageHeader) == 48,
+              "CompressedImageHeader must not contain padding");
+
+/// A block compressed image with its mipmaps, that can be cached in a file.
+/** The compression doesn't use OpenGL, so it can run on worker threads. */
+class CompressedImage {
+ public:
+  /// Creates an empty image.
+  CompressedImage() = default;
+
+  /// Compresses an image.
+  /** @param format - The block format.
+    * @param rgba - The pixels of the image, as tightly packed RGBA bytes.
+    * @param width, height - The size of the image.
+    * @param srgb - Is the image sRGB encoded.
+    * @param mipmaps - Generate and compress every mipmap level.
+    * @param threads - The number of threads to compress on. 0 means one
+    *                  thread per hardware thread. */
+  CompressedImage(BlockFormat format, const GLubyte* rgba, GLsizei width,
+                  GLsizei height, bool srgb, bool mipmaps = true,
+                  unsigned threads = 0);
+
+  /// Returns the block format.
+  BlockFormat format() const { return format_; }
+
+  /// Returns true if the image is sRGB encoded.
+  bool srgb() const { return srgb_; }
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+  /// Returns the internal format, the image can be uploaded with.
+  PixelDataInternalFormat internalFormat() const {
+    return GetCompressedInternalFormat(format_, srgb_);
+  }
+#endif
+
+  /// Returns the number of levels, including the base level.
+  GLsizei levelCount() const { return levels_.size(); }
+
+  /// Returns the width of a level.
+  GLsizei width(GLsizei level) const { return widths_[level]; }
+
+  /// Returns the height of a level.
+  GLsizei height(GLsizei level) const { return heights_[level]; }
+
+  /// Returns the blocks of a level.
+  const GLubyte* data(GLsizei level) const { return levels_[level].data(); }
+
+  /// Returns the size of a level in bytes.
+  GLsizei size(GLsizei level) const { return levels_[level].size(); }
+
+  /// Writes the image to a cache file.
+  /** @param path - The path of the cache file.
+    * @param source - The file the image was loaded from. Its size and
+    *                 modification time are stored, so load() can tell if the
+    *                 cache is stale. Can be empty.
+    * @return False if the file can't be written. */
+  bool save(const std::string& path, const std::string& source = "") const;
+
+  /// Reads the image from a cache file.
+  /** @param path - The path of the cache file.
+    * @param source - The file the image was loaded from, as it was passed to
+    *                 save().
+    * @return False if the file doesn't exist, is invalid or is stale. */
+  bool load(const std::string& path, const std::string& source = "");
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glCompressedTexImage2D) \
+    && defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+  template<Texture2DType texture_t>
+  /// Uploads every level to a texture, and sets its maximum level if the
+  /// image has mipmaps.
+  /** The texture should be bound.
+    * @param texture - The texture to upload to.
+    * @see glCompressedTexImage2D */
+  void upload(Texture2DBase<texture_t>& texture) const;
+#endif
+
+ private:
+  BlockFormat format_ = BlockFormat::kBc1;
+  bool srgb_ = false;
+  std::vector<std::vector<GLubyte>> levels_;
+  std::vector<GLsizei> widths_, heights_;
+};
+
+/// Loads a compressed image from a cache file next to the source image, or
+/// compresses it and creates the cache.
+/** The cache file is the source path with a ".bc<n>" extension appended (like
+  * "grass.png.bc7"). It's recreated if the source file changed.
+  * @param source - The path of the source image.
+  * @param format - The block format.
+  * @param decode - A function like bool(std::vector<GLubyte>* rgba,
+  *                 GLsizei* width, GLsizei* height), that decodes the source
+  *                 image to tightly packed RGBA bytes. It's only called if the
+  *                 cache is missing or stale.
+  * @param srgb - Is the image sRGB encoded.
+  * @param mipmaps - Generate and compress every mipmap level.
+  * @return The compressed image. Empty if the decoding failed. */
+template<typename DecodeFunc>
+CompressedImage LoadCompressedImage(const std::string& source,
+                                    BlockFormat format, DecodeFunc decode,
+                                    bool srgb, bool mipmaps = true);
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./block_compression-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_BLOCK_COMPRESSION_H_
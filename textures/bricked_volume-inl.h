@@ -0,0 +1,410 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_BRICKED_VOLUME_INL_H_
+#define OGLWRAP_TEXTURES_BRICKED_VOLUME_INL_H_
+
+#include <cmath>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "./bricked_volume.h"
+#include "./pixel_size.h"
+#include "../context/binding.h"
+#include "../context/pixel_ops.h"
+#include "../context/extensions.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Copies a box of a volume into a tightly packed buffer, repeating the edge
+/// voxels of the volume where the box is outside of it.
+/** @param volume - The voxels, x fastest, then y, then z.
+  * @param size - The size of the volume.
+  * @param begin - The position of the box inside the border.
+  * @param border - The number of voxels before begin along every axis.
+  * @param width, height, depth - The size of the box including the border.
+  * @param pixel_size - The size of a voxel in bytes. */
+inline std::vector<unsigned char> OGLWRAP_GatherClamped(
+    const unsigned char* volume, const GLsizei* size, const GLint* begin,
+    GLsizei border, GLsizei width, GLsizei height, GLsizei depth,
+    GLsizei pixel_size) {
+  std::vector<unsigned char> box(size_t(width) * height * depth * pixel_size);
+  auto clamp = [](GLint value, GLsizei size) {
+    return std::min(std::max(value, 0), size - 1);
+  };
+  // The voxels inside the volume are copied as one run per row.
+  GLint x_min = begin[0] - border;
+  GLint run_begin = std::max(x_min, 0);
+  GLint run_end = std::min(x_min + width, size[0]);
+  unsigned char* dst = box.data();
+  for (GLsizei z = 0; z < depth; ++z) {
+    GLint src_z = clamp(begin[2] - border + z, size[2]);
+    for (GLsizei y = 0; y < height; ++y) {
+      GLint src_y = clamp(begin[1] - border + y, size[1]);
+      const unsigned char* src_row =
+          volume + (size_t(src_z) * size[1] + src_y) * size[0] * pixel_size;
+      for (GLint x = x_min; x < run_begin; ++x) {
+        std::memcpy(dst, src_row, pixel_size);
+        dst += pixel_size;
+      }
+      if (run_begin < run_end) {
+        size_t run_size = size_t(run_end - run_begin) * pixel_size;
+        std::memcpy(dst, src_row + size_t(run_begin) * pixel_size, run_size);
+        dst += run_size;
+      }
+      for (GLint x = std::max(run_end, x_min); x < x_min + width; ++x) {
+        std::memcpy(dst, src_row + size_t(size[0] - 1) * pixel_size,
+                    pixel_size);
+        dst += pixel_size;
+      }
+    }
+  }
+  return box;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(GL_TEXTURE_3D) \
+    && defined(glTexStorage3D) && defined(glTexSubImage3D))
+
+inline BrickedVolume::BrickedVolume(MappedFile file, size_t offset,
+                                    GLsizei width, GLsizei height,
+                                    GLsizei depth,
+                                    PixelDataInternalFormat internal_format,
+                                    PixelDataFormat format, PixelDataType type,
+                                    size_t max_resident_bricks,
+                                    GLsizei brick_size, bool allow_sparse)
+    : file_(std::move(file)), offset_(offset), size_{width, height, depth}
+    , format_(format), type_(type)
+    , brick_size_{brick_size, brick_size, brick_size}
+    , max_resident_(max_resident_bricks) {
+  if (brick_size <= 0) {
+    throw std::invalid_argument("The brick size must be positive.");
+  }
+  size_t volume_size = size_t(width) * height * depth *
+                       GetPixelSize(format, type);
+  if (offset > file_.size() || file_.size() - offset < volume_size) {
+    throw std::runtime_error("The file is smaller than the volume.");
+  }
+
+  sparse_ = allow_sparse && initSparse(internal_format, brick_size);
+  if (!sparse_) {
+    initCache(internal_format);
+  }
+
+  for (int axis = 0; axis < 3; ++axis) {
+    brick_count_[axis] =
+        (size_[axis] + brick_size_[axis] - 1) / brick_size_[axis];
+  }
+  size_t brick_count = size_t(brick_count_[0]) * brick_count_[1] *
+                       brick_count_[2];
+  bricks_.resize(brick_count);
+  page_table_data_.resize(brick_count * 4);
+
+  Bind(page_table_);
+  page_table_.storage(1, PixelDataInternalFormat::kRgba16Ui, brick_count_[0],
+                      brick_count_[1], brick_count_[2]);
+  page_table_.minFilter(MinFilter::kNearest);
+  page_table_.magFilter(MagFilter::kNearest);
+  uploadPageTable();
+}
+
+inline bool BrickedVolume::initSparse(PixelDataInternalFormat internal_format,
+                                      GLsizei brick_size) {
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexPageCommitmentARB) \
+    && defined(glGetInternalformativ))
+  if (!IsExtensionSupported("GL_ARB_sparse_texture")) {
+    return false;
+  }
+
+  GLint page_size_count = 0;
+  gl(GetInternalformativ(GL_TEXTURE_3D, GLenum(internal_format),
+                         GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &page_size_count));
+  if (page_size_count == 0) {
+    return false;
+  }
+
+  // The committed regions, and the size of the texture must be multiples of
+  // the page size. The texture is rounded up to whole bricks, so the last
+  // bricks can be committed whole too.
+  const GLenum page_size_names[3] = {GL_VIRTUAL_PAGE_SIZE_X_ARB,
+                                     GL_VIRTUAL_PAGE_SIZE_Y_ARB,
+                                     GL_VIRTUAL_PAGE_SIZE_Z_ARB};
+  GLsizei storage_size[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    GLint page_size = 1;
+    gl(GetInternalformativ(GL_TEXTURE_3D, GLenum(internal_format),
+                           page_size_names[axis], 1, &page_size));
+    page_size = std::max(page_size, 1);
+    brick_size_[axis] = (brick_size + page_size - 1) / page_size * page_size;
+    storage_size[axis] = (size_[axis] + brick_size_[axis] - 1) /
+                         brick_size_[axis] * brick_size_[axis];
+  }
+
+  GLint max_size = 0;
+  gl(GetIntegerv(GL_MAX_SPARSE_3D_TEXTURE_SIZE_ARB, &max_size));
+  if (std::max({storage_size[0], storage_size[1], storage_size[2]}) >
+      max_size) {
+    std::fill_n(brick_size_, 3, brick_size);
+    return false;
+  }
+
+  Bind(texture_);
+  gl(TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_SPARSE_ARB, GL_TRUE));
+  gl(TexParameteri(GL_TEXTURE_3D, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0));
+  texture_.storage(1, internal_format, storage_size[0], storage_size[1],
+                   storage_size[2]);
+
+  // The allocation can still fail. That leaves the texture mutable, which is
+  // checked instead of glGetError, because the debug error checking already
+  // consumes the error. The sparse flag can't be cleared from the texture
+  // object, so the brick cache gets a new one.
+  GLint immutable = GL_FALSE;
+  gl(GetTexParameteriv(GL_TEXTURE_3D, GL_TEXTURE_IMMUTABLE_FORMAT,
+                       &immutable));
+  if (!immutable) {
+    texture_ = Texture3D();
+    std::fill_n(brick_size_, 3, brick_size);
+    return false;
+  }
+  texture_.wrapS(WrapMode::kClampToEdge);
+  texture_.wrapT(WrapMode::kClampToEdge);
+  texture_.wrapP(WrapMode::kClampToEdge);
+  return true;
+#else
+  (void)internal_format;
+  (void)brick_size;
+  return false;
+#endif
+}
+
+inline void BrickedVolume::initCache(PixelDataInternalFormat internal_format) {
+  border_ = 1;
+
+  GLint max_size = 0;
+  gl(GetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &max_size));
+  GLsizei max_slots[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    max_slots[axis] = std::max<GLsizei>(max_size / slotSize(axis), 1);
+  }
+
+  // A roughly cubic cache, with just enough layers of slots for the budget.
+  size_t wanted = std::max<size_t>(max_resident_, 1);
+  GLsizei side = GLsizei(std::ceil(std::cbrt(double(wanted))));
+  slot_count_[0] = std::min(side, max_slots[0]);
+  slot_count_[1] = std::min(side, max_slots[1]);
+  size_t layer = size_t(slot_count_[0]) * slot_count_[1];
+  slot_count_[2] = std::min(GLsizei((wanted + layer - 1) / layer),
+                            max_slots[2]);
+  size_t slot_count = layer * slot_count_[2];
+  max_resident_ = std::min(max_resident_, slot_count);
+
+  for (size_t slot = slot_count; slot > 0; --slot) {
+    free_slots_.push_back(GLint(slot - 1));
+  }
+
+  Bind(texture_);
+  texture_.storage(1, internal_format, slot_count_[0] * slotSize(0),
+                   slot_count_[1] * slotSize(1), slot_count_[2] * slotSize(2));
+  texture_.wrapS(WrapMode::kClampToEdge);
+  texture_.wrapT(WrapMode::kClampToEdge);
+  texture_.wrapP(WrapMode::kClampToEdge);
+}
+
+inline void BrickedVolume::request(GLint x, GLint y, GLint z) {
+  size_t index = brickIndex(x, y, z);
+  Brick& brick = bricks_[index];
+  brick.last_used = frame_;
+  if (brick.slot >= 0) {
+    lru_.splice(lru_.end(), lru_, brick.lru_position);
+  } else if (!brick.pending) {
+    brick.pending = true;
+    pending_.push_back(index);
+  }
+}
+
+inline void BrickedVolume::requestVoxels(GLint x_min, GLint y_min, GLint z_min,
+                                         GLint x_max, GLint y_max,
+                                         GLint z_max) {
+  GLint min[3] = {x_min, y_min, z_min}, max[3] = {x_max, y_max, z_max};
+  GLint first[3], last[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    min[axis] = std::max(min[axis], 0);
+    max[axis] = std::min(max[axis], size_[axis]);
+    if (min[axis] >= max[axis]) {
+      return;
+    }
+    first[axis] = min[axis] / brick_size_[axis];
+    last[axis] = (max[axis] - 1) / brick_size_[axis];
+  }
+
+  for (GLint z = first[2]; z <= last[2]; ++z) {
+    for (GLint y = first[1]; y <= last[1]; ++y) {
+      for (GLint x = first[0]; x <= last[0]; ++x) {
+        request(x, y, z);
+      }
+    }
+  }
+}
+
+inline size_t BrickedVolume::update(size_t max_bricks) {
+  size_t paged_in = 0;
+  for (size_t index : pending_) {
+    Brick& brick = bricks_[index];
+    brick.pending = false;
+    if (paged_in == max_bricks || brick.slot >= 0 || max_resident_ == 0) {
+      continue;
+    }
+    if (lru_.size() >= max_resident_) {
+      // Every brick after this one was requested in the current frame too.
+      size_t victim = lru_.front();
+      if (bricks_[victim].last_used == frame_) {
+        continue;
+      }
+      pageOut(victim);
+    }
+    pageIn(index);
+    ++paged_in;
+  }
+  pending_.clear();
+
+  if (page_table_dirty_) {
+    uploadPageTable();
+  }
+  return paged_in;
+}
+
+inline void BrickedVolume::getBrickBox(size_t index, GLint* begin,
+                                       GLint* end) const {
+  GLint brick[3] = {
+    GLint(index % brick_count_[0]),
+    GLint(index / brick_count_[0] % brick_count_[1]),
+    GLint(index / (size_t(brick_count_[0]) * brick_count_[1]))
+  };
+  for (int axis = 0; axis < 3; ++axis) {
+    begin[axis] = brick[axis] * brick_size_[axis];
+    end[axis] = std::min(begin[axis] + brick_size_[axis], size_[axis]);
+  }
+}
+
+inline void BrickedVolume::pageIn(size_t index) {
+  GLint begin[3], end[3];
+  getBrickBox(index, begin, end);
+
+  Brick& brick = bricks_[index];
+  GLint slot[3];
+  if (sparse_) {
+    commit(index, true);
+    brick.slot = GLint(index);
+    for (int axis = 0; axis < 3; ++axis) {
+      slot[axis] = begin[axis] / brick_size_[axis];
+    }
+  } else {
+    brick.slot = free_slots_.back();
+    free_slots_.pop_back();
+    slot[0] = brick.slot % slot_count_[0];
+    slot[1] = brick.slot / slot_count_[0] % slot_count_[1];
+    slot[2] = brick.slot / (slot_count_[0] * slot_count_[1]);
+  }
+  brick.lru_position = lru_.insert(lru_.end(), index);
+
+  GLsizei pixel_size = GetPixelSize(format_, type_);
+  bool at_edge = false;
+  for (int axis = 0; axis < 3; ++axis) {
+    at_edge = at_edge || begin[axis] < border_ ||
+              begin[axis] + brick_size_[axis] + border_ > size_[axis];
+  }
+  Bind(texture_);
+  if (!sparse_ && at_edge && pixel_size != 0) {
+    // The slot was used by other bricks before, so the parts of it, that are
+    // outside the volume, are filled with the edge voxels, otherwise the
+    // filtering would blend in the stale data.
+    std::vector<unsigned char> voxels =
+        OGLWRAP_GatherClamped(file_.data() + offset_, size_, begin, border_,
+                              slotSize(0), slotSize(1), slotSize(2),
+                              pixel_size);
+    ScopedUnpackVolumeRegion region(slotSize(0) * pixel_size, slotSize(1),
+                                    0, 0, 0, format_, type_);
+    texture_.subUpload(slot[0] * slotSize(0), slot[1] * slotSize(1),
+                       slot[2] * slotSize(2), slotSize(0), slotSize(1),
+                       slotSize(2), format_, type_, voxels.data());
+  } else {
+    // The border duplicates the neighbouring voxels. Sparse volumes have no
+    // border, and their texels past the edges of the volume are undefined.
+    GLint source[3], source_size[3], destination[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      source[axis] = std::max(begin[axis] - border_, 0);
+      source_size[axis] = std::min(end[axis] + border_, size_[axis]) -
+                          source[axis];
+      destination[axis] = slot[axis] * slotSize(axis) + border_ -
+                          (begin[axis] - source[axis]);
+    }
+
+    // The brick is read straight from the mapping, the unpack parameters
+    // select its voxels.
+    GLsizei row_pitch = size_[0] * pixel_size;
+    ScopedUnpackVolumeRegion region(row_pitch, size_[1], source[0], source[1],
+                                    source[2], format_, type_);
+    texture_.subUpload(destination[0], destination[1], destination[2],
+                       source_size[0], source_size[1], source_size[2],
+                       format_, type_, file_.data() + offset_);
+  }
+
+  GLushort* entry = &page_table_data_[index * 4];
+  entry[0] = GLushort(slot[0]);
+  entry[1] = GLushort(slot[1]);
+  entry[2] = GLushort(slot[2]);
+  entry[3] = 1;
+  page_table_dirty_ = true;
+}
+
+inline void BrickedVolume::pageOut(size_t index) {
+  Brick& brick = bricks_[index];
+  if (sparse_) {
+    commit(index, false);
+  } else {
+    free_slots_.push_back(brick.slot);
+  }
+  lru_.erase(brick.lru_position);
+  brick.slot = -1;
+
+  std::fill_n(&page_table_data_[index * 4], 4, 0);
+  page_table_dirty_ = true;
+}
+
+inline void BrickedVolume::commit(size_t index, bool commit) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexPageCommitmentARB)
+  // The whole brick is committed, even if it's over the edge of the volume,
+  // so the region is a multiple of the page size.
+  GLint begin[3], end[3];
+  getBrickBox(index, begin, end);
+  Bind(texture_);
+  gl(TexPageCommitmentARB(GL_TEXTURE_3D, 0, begin[0], begin[1], begin[2],
+                          brick_size_[0], brick_size_[1], brick_size_[2],
+                          commit ? GL_TRUE : GL_FALSE));
+#else
+  (void)index;
+  (void)commit;
+#endif
+}
+
+inline void BrickedVolume::uploadPageTable() {
+  ScopedUnpackVolumeRegion region(brick_count_[0] * 4 * sizeof(GLushort),
+                                  brick_count_[1], 0, 0, 0,
+                                  PixelDataFormat::kRgbaInteger,
+                                  PixelDataType::kUnsignedShort);
+  Bind(page_table_);
+  page_table_.subUpload(0, 0, 0, brick_count_[0], brick_count_[1],
+                        brick_count_[2], PixelDataFormat::kRgbaInteger,
+                        PixelDataType::kUnsignedShort,
+                        page_table_data_.data());
+  page_table_dirty_ = false;
+}
+
+#endif  // GL_TEXTURE_3D && glTexStorage3D && glTexSubImage3D
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_BRICKED_VOLUME_INL_H_
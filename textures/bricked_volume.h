@@ -0,0 +1,184 @@
+// Copyright (c) Tamas Csala
+
+/** @file bricked_volume.h
+    @brief Implements volumes, whose bricks are paged in from a memory mapped
+           file on demand.
+*/
+
+#ifndef OGLWRAP_TEXTURES_BRICKED_VOLUME_H_
+#define OGLWRAP_TEXTURES_BRICKED_VOLUME_H_
+
+#include <list>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include "../config.h"
+#include "../mapped_file.h"
+#include "./texture_3D.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(GL_TEXTURE_3D) \
+    && defined(glTexStorage3D) && defined(glTexSubImage3D))
+/// A volume, that is split into bricks, which are only uploaded when needed.
+/** The voxels are read from a memory mapped file, where they are stored as a
+  * raw array (x fastest, then y, then z), and the bricks are uploaded straight
+  * from the mapping, so only the pages of the file, that the resident bricks
+  * cover, are ever read. The bricks are stored in one of two ways:
+  *  - With ARB_sparse_texture, the texture covers the whole volume (rounded
+  *    up to whole bricks), and the memory of a brick is committed when it's
+  *    paged in, and decommitted when it's evicted. The bricks are aligned to
+  *    the virtual page size of the format. The texels past the edges of the
+  *    volume are undefined.
+  *  - Otherwise the bricks are packed into the slots of a cache texture. Every
+  *    slot has a one voxel border, that duplicates the neighbouring bricks, so
+  *    trilinear filtering is seamless. At the edges of the volume, the border
+  *    (and the rest of the slot outside the volume) repeats the edge voxels.
+  *
+  * The page table is a GL_RGBA16UI texture with a texel for every brick. A
+  * resident brick has 1 in its alpha channel, and the position of its slot in
+  * the rgb channels. In a shader, a voxel at v is at
+  * entry.xyz * slotSize() + border() + (v - brick * brickSize()) in texture().
+  * For sparse volumes the slot of a brick is the brick itself, and the border
+  * is zero, so this is v. The textures are bound by the functions, that modify
+  * them. */
+class BrickedVolume {
+ public:
+  /// Allocates the storage of the volume, and the page table.
+  /** No brick is resident after this.
+    * @param file - The file, that contains the voxels.
+    * @param offset - The offset of the first voxel in the file in bytes.
+    * @param width, height, depth - The size of the volume in voxels.
+    * @param internal_format - The sized internal format of the texture.
+    * @param format, type - The layout of the voxels in the file.
+    * @param max_resident_bricks - The maximum number of bricks, that are
+    *                              resident at once.
+    * @param brick_size - The size of a brick in voxels along every axis.
+    *                     Sparse volumes round it up to the page size.
+    * @param allow_sparse - Use a sparse texture if it's supported.
+    * @throw std::invalid_argument if the brick size isn't positive.
+    * @throw std::runtime_error if the file is smaller than the volume.
+    * @see glTexStorage3D, GL_ARB_sparse_texture */
+  BrickedVolume(MappedFile file, size_t offset, GLsizei width, GLsizei height,
+                GLsizei depth, PixelDataInternalFormat internal_format,
+                PixelDataFormat format, PixelDataType type,
+                size_t max_resident_bricks, GLsizei brick_size = 64,
+                bool allow_sparse = true);
+
+  BrickedVolume(const BrickedVolume&) = delete;
+  BrickedVolume& operator=(const BrickedVolume&) = delete;
+
+  /// Returns the texture, that contains the resident bricks.
+  const Texture3D& texture() const { return texture_; }
+
+  /// Returns the page table texture.
+  const Texture3D& pageTable() const { return page_table_; }
+
+  /// Returns true if the bricks are stored in a sparse texture.
+  bool isSparse() const { return sparse_; }
+
+  /// Returns the size of a brick in voxels along an axis (0, 1 or 2).
+  GLsizei brickSize(int axis) const { return brick_size_[axis]; }
+
+  /// Returns the size of a slot of texture() in texels along an axis.
+  GLsizei slotSize(int axis) const { return brick_size_[axis] + 2*border_; }
+
+  /// Returns the number of duplicated voxels around a brick in its slot.
+  GLsizei border() const { return border_; }
+
+  /// Returns the number of bricks along an axis.
+  GLsizei brickCount(int axis) const { return brick_count_[axis]; }
+
+  /// Returns the number of resident bricks.
+  size_t residentCount() const { return lru_.size(); }
+
+  /// Returns the maximum number of bricks, that are resident at once.
+  size_t maxResidentBricks() const { return max_resident_; }
+
+  /// Returns true if a brick is resident.
+  /** @param x, y, z - The position of the brick in bricks. */
+  bool isResident(GLint x, GLint y, GLint z) const {
+    return bricks_[brickIndex(x, y, z)].slot >= 0;
+  }
+
+  /// Marks the beginning of a new frame.
+  /** The bricks requested in the previous frames become candidates of
+    * eviction. */
+  void beginFrame() { ++frame_; }
+
+  /// Requests a brick to be resident.
+  /** The bricks are paged in by update() in the order of their requests, so
+    * the most important ones should be requested first.
+    * @param x, y, z - The position of the brick in bricks. */
+  void request(GLint x, GLint y, GLint z);
+
+  /// Requests every brick, that intersects a box of voxels.
+  /** @param x_min, y_min, z_min - The first voxel of the box.
+    * @param x_max, y_max, z_max - The voxel after the last one of the box. */
+  void requestVoxels(GLint x_min, GLint y_min, GLint z_min,
+                     GLint x_max, GLint y_max, GLint z_max);
+
+  /// Pages in the requested bricks, and updates the page table.
+  /** If there are too many resident bricks, the least recently requested ones
+    * are evicted. The bricks requested in the current frame are never
+    * evicted, so some requests might stay unserved; they should be requested
+    * again in the next frame.
+    * @param max_bricks - The maximum number of bricks to page in.
+    * @return The number of bricks paged in.
+    * @see glTexSubImage3D, glTexPageCommitmentARB */
+  size_t update(size_t max_bricks = 16);
+
+ private:
+  struct Brick {
+    GLint slot = -1;
+    bool pending = false;
+    size_t last_used = 0;
+    std::list<size_t>::iterator lru_position;
+  };
+
+  MappedFile file_;
+  size_t offset_;
+  GLsizei size_[3];
+  PixelDataFormat format_;
+  PixelDataType type_;
+  GLsizei brick_size_[3];
+  GLsizei brick_count_[3];
+  GLsizei slot_count_[3] = {0, 0, 0};
+  GLsizei border_ = 0;
+  bool sparse_ = false;
+  size_t max_resident_;
+  size_t frame_ = 1;
+
+  Texture3D texture_, page_table_;
+  std::vector<GLushort> page_table_data_;
+  bool page_table_dirty_ = true;
+
+  std::vector<Brick> bricks_;
+  std::vector<size_t> pending_;
+  std::list<size_t> lru_;  // The resident bricks, least recently used first
+  std::vector<GLint> free_slots_;
+
+  size_t brickIndex(GLint x, GLint y, GLint z) const {
+    return (size_t(z) * brick_count_[1] + y) * brick_count_[0] + x;
+  }
+
+  bool initSparse(PixelDataInternalFormat internal_format,
+                  GLsizei brick_size);
+  void initCache(PixelDataInternalFormat internal_format);
+  void pageIn(size_t index);
+  void pageOut(size_t index);
+  void commit(size_t index, bool commit);
+  void uploadPageTable();
+  void getBrickBox(size_t index, GLint* begin, GLint* end) const;
+};
+#endif  // GL_TEXTURE_3D && glTexStorage3D && glTexSubImage3D
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./bricked_volume-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_BRICKED_VOLUME_H_
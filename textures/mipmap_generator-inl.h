@@ -0,0 +1,328 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_MIPMAP_GENERATOR_INL_H_
+#define OGLWRAP_TEXTURES_MIPMAP_GENERATOR_INL_H_
+
+#include <cmath>
+#include <algorithm>
+
+#include "./mipmap_generator.h"
+#include "../context/pixel_ops.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Four floats, that are processed together: the channels of a texel in the
+/// mipmap filters, or four texels in the block encoders.
+struct OGLWRAP_Float4 {
+#if OGLWRAP_SIMD_SSE2
+  __m128 v;
+
+  static OGLWRAP_Float4 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+  static OGLWRAP_Float4 Splat(float f) { return {_mm_set1_ps(f)}; }
+  void store(float* p) const { _mm_storeu_ps(p, v); }
+  OGLWRAP_Float4 operator+(OGLWRAP_Float4 o) const {
+    return {_mm_add_ps(v, o.v)};
+  }
+  OGLWRAP_Float4 operator*(OGLWRAP_Float4 o) const {
+    return {_mm_mul_ps(v, o.v)};
+  }
+  OGLWRAP_Float4 operator-(OGLWRAP_Float4 o) const {
+    return {_mm_sub_ps(v, o.v)};
+  }
+  static OGLWRAP_Float4 Min(OGLWRAP_Float4 a, OGLWRAP_Float4 b) {
+    return {_mm_min_ps(a.v, b.v)};
+  }
+  /// Returns the lanes of x, where a < b, and the lanes of y elsewhere.
+  static OGLWRAP_Float4 SelectLess(OGLWRAP_Float4 a, OGLWRAP_Float4 b,
+                                   OGLWRAP_Float4 x, OGLWRAP_Float4 y) {
+    __m128 mask = _mm_cmplt_ps(a.v, b.v);
+    return {_mm_or_ps(_mm_and_ps(mask, x.v), _mm_andnot_ps(mask, y.v))};
+  }
+#elif OGLWRAP_SIMD_NEON
+  float32x4_t v;
+
+  static OGLWRAP_Float4 Load(const float* p) { return {vld1q_f32(p)}; }
+  static OGLWRAP_Float4 Splat(float f) { return {vdupq_n_f32(f)}; }
+  void store(float* p) const { vst1q_f32(p, v); }
+  OGLWRAP_Float4 operator+(OGLWRAP_Float4 o) const {
+    return {vaddq_f32(v, o.v)};
+  }
+  OGLWRAP_Float4 operator*(OGLWRAP_Float4 o) const {
+    return {vmulq_f32(v, o.v)};
+  }
+  OGLWRAP_Float4 operator-(OGLWRAP_Float4 o) const {
+    return {vsubq_f32(v, o.v)};
+  }
+  static OGLWRAP_Float4 Min(OGLWRAP_Float4 a, OGLWRAP_Float4 b) {
+    return {vminq_f32(a.v, b.v)};
+  }
+  /// Returns the lanes of x, where a < b, and the lanes of y elsewhere.
+  static OGLWRAP_Float4 SelectLess(OGLWRAP_Float4 a, OGLWRAP_Float4 b,
+                                   OGLWRAP_Float4 x, OGLWRAP_Float4 y) {
+    return {vbslq_f32(vcltq_f32(a.v, b.v), x.v, y.v)};
+  }
+#else
+  float v[4];
+
+  static OGLWRAP_Float4 Load(const float* p) {
+    return {{p[0], p[1], p[2], p[3]}};
+  }
+  static OGLWRAP_Float4 Splat(float f) { return {{f, f, f, f}}; }
+  void store(float* p) const { std::copy(v, v + 4, p); }
+  OGLWRAP_Float4 operator+(OGLWRAP_Float4 o) const {
+    return {{v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2], v[3] + o.v[3]}};
+  }
+  OGLWRAP_Float4 operator*(OGLWRAP_Float4 o) const {
+    return {{v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2], v[3] * o.v[3]}};
+  }
+  OGLWRAP_Float4 operator-(OGLWRAP_Float4 o) const {
+    return {{v[0] - o.v[0], v[1] - o.v[1], v[2] - o.v[2], v[3] - o.v[3]}};
+  }
+  static OGLWRAP_Float4 Min(OGLWRAP_Float4 a, OGLWRAP_Float4 b) {
+    return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]),
+             std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+  }
+  /// Returns the lanes of x, where a < b, and the lanes of y elsewhere.
+  static OGLWRAP_Float4 SelectLess(OGLWRAP_Float4 a, OGLWRAP_Float4 b,
+                                   OGLWRAP_Float4 x, OGLWRAP_Float4 y) {
+    return {{a.v[0] < b.v[0] ? x.v[0] : y.v[0],
+             a.v[1] < b.v[1] ? x.v[1] : y.v[1],
+             a.v[2] < b.v[2] ? x.v[2] : y.v[2],
+             a.v[3] < b.v[3] ? x.v[3] : y.v[3]}};
+  }
+#endif
+};
+
+/// The zeroth order modified Bessel function of the first kind.
+inline float OGLWRAP_BesselI0(float x) {
+  float sum = 1.0f, term = 1.0f;
+  for (int k = 1; k < 16; ++k) {
+    term *= (x / (2*k)) * (x / (2*k));
+    sum += term;
+  }
+  return sum;
+}
+
+/// Returns the normalized weights of the 6 taps of the Kaiser filter.
+inline const float* OGLWRAP_KaiserWeights() {
+  static const std::vector<float> weights = [] {
+    const float kPi = 3.14159265358979f;
+    const float kRadius = 1.5f, kAlpha = 4.0f;
+    std::vector<float> values(6);
+    float sum = 0.0f;
+    for (int i = 0; i < 6; ++i) {
+      // The distance of the source texel from the destination texel, in
+      // destination texels.
+      float x = (i - 2.5f) * 0.5f;
+      float sinc = x == 0.0f ? 1.0f : std::sin(kPi * x) / (kPi * x);
+      float ratio = x / kRadius;
+      float window = OGLWRAP_BesselI0(kAlpha * std::sqrt(1 - ratio*ratio)) /
+                     OGLWRAP_BesselI0(kAlpha);
+      values[i] = sinc * window;
+      sum += values[i];
+    }
+    for (float& value : values) {
+      value /= sum;
+    }
+    return values;
+  }();
+  return weights.data();
+}
+
+/// Halves an image of four float channels with a box filter.
+inline void OGLWRAP_DownsampleBox(const float* src, GLsizei src_width,
+                                  GLsizei src_height, float* dst,
+                                  GLsizei dst_width, GLsizei dst_height) {
+  for (GLsizei y = 0; y < dst_height; ++y) {
+    // On odd sizes, the last texel covers the remaining row or column of the
+    // source too (3 taps instead of 2), so it isn't dropped.
+    GLsizei rows = 2*y + 3 == src_height ? 3 : 2;
+    for (GLsizei x = 0; x < dst_width; ++x) {
+      GLsizei columns = 2*x + 3 == src_width ? 3 : 2;
+      OGLWRAP_Float4 sum = OGLWRAP_Float4::Splat(0.0f);
+      for (GLsizei j = 0; j < rows; ++j) {
+        const float* row =
+            src + size_t(std::min(2*y + j, src_height - 1)) * src_width * 4;
+        for (GLsizei i = 0; i < columns; ++i) {
+          sum = sum + OGLWRAP_Float4::Load(
+              row + std::min(2*x + i, src_width - 1) * 4);
+        }
+      }
+      OGLWRAP_Float4 scale = OGLWRAP_Float4::Splat(1.0f / (rows * columns));
+      (sum * scale).store(dst + (size_t(y) * dst_width + x) * 4);
+    }
+  }
+}
+
+/// Halves an image of four float channels with the separable Kaiser filter.
+inline void OGLWRAP_DownsampleKaiser(const float* src, GLsizei src_width,
+                                     GLsizei src_height, float* dst,
+                                     GLsizei dst_width, GLsizei dst_height) {
+  const float* weights = OGLWRAP_KaiserWeights();
+  OGLWRAP_Float4 w[6];
+  for (int i = 0; i < 6; ++i) {
+    w[i] = OGLWRAP_Float4::Splat(weights[i]);
+  }
+
+  // Horizontal pass: src_height rows of dst_width texels.
+  std::vector<float> tmp(size_t(dst_width) * src_height * 4);
+  for (GLsizei y = 0; y < src_height; ++y) {
+    const float* row = src + size_t(y) * src_width * 4;
+    for (GLsizei x = 0; x < dst_width; ++x) {
+      OGLWRAP_Float4 sum = OGLWRAP_Float4::Splat(0.0f);
+      for (int i = 0; i < 6; ++i) {
+        GLsizei sx = std::min(std::max(2*x - 2 + i, 0), src_width - 1);
+        sum = sum + OGLWRAP_Float4::Load(row + sx*4) * w[i];
+      }
+      sum.store(tmp.data() + (size_t(y) * dst_width + x) * 4);
+    }
+  }
+
+  // Vertical pass
+  for (GLsizei y = 0; y < dst_height; ++y) {
+    for (GLsizei x = 0; x < dst_width; ++x) {
+      OGLWRAP_Float4 sum = OGLWRAP_Float4::Splat(0.0f);
+      for (int i = 0; i < 6; ++i) {
+        GLsizei sy = std::min(std::max(2*y - 2 + i, 0), src_height - 1);
+        sum = sum + OGLWRAP_Float4::Load(
+            tmp.data() + (size_t(sy) * dst_width + x) * 4) * w[i];
+      }
+      sum.store(dst + (size_t(y) * dst_width + x) * 4);
+    }
+  }
+}
+
+/// Returns the ratio of texels, whose scaled alpha is above the cutoff.
+inline float OGLWRAP_AlphaCoverage(const std::vector<float>& image,
+                                   float cutoff, float scale) {
+  size_t covered = 0, texels = image.size() / 4;
+  for (size_t i = 0; i < texels; ++i) {
+    if (image[i*4 + 3] * scale > cutoff) {
+      ++covered;
+    }
+  }
+  return float(covered) / texels;
+}
+
+/// Finds the alpha scale, that gives the closest coverage to the desired one.
+inline float OGLWRAP_AlphaScale(const std::vector<float>& image, float cutoff,
+                                float coverage) {
+  float low = 0.0f, high = 4.0f;
+  for (int i = 0; i < 16; ++i) {
+    float mid = (low + high) / 2;
+    if (OGLWRAP_AlphaCoverage(image, cutoff, mid) < coverage) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  // Small levels can't hit the coverage exactly, pick the nearer side.
+  float low_error = coverage - OGLWRAP_AlphaCoverage(image, cutoff, low);
+  float high_error = OGLWRAP_AlphaCoverage(image, cutoff, high) - coverage;
+  return low_error < high_error ? low : high;
+}
+
+inline MipmapChain::MipmapChain(const GLubyte* data, GLsizei width,
+                                GLsizei height, GLsizei channels,
+                                const MipmapOptions& options) {
+  const float* srgb_to_linear = OGLWRAP_SrgbToLinearTable();
+  GLsizei srgb_channels = options.srgb ? std::min<GLsizei>(channels, 3) : 0;
+  bool has_alpha = channels == 4;
+  bool keep_coverage = has_alpha && options.alpha_cutoff > 0.0f;
+
+  // Every level is filtered in linear space with four float channels.
+  std::vector<float> image(size_t(width) * height * 4);
+  for (size_t i = 0; i < size_t(width) * height; ++i) {
+    for (GLsizei c = 0; c < 4; ++c) {
+      float value = c == 3 ? 1.0f : 0.0f;
+      if (c < channels) {
+        GLubyte texel = data[i*channels + c];
+        value = c < srgb_channels ? srgb_to_linear[texel] : texel / 255.0f;
+      }
+      image[i*4 + c] = value;
+    }
+  }
+
+  levels_.emplace_back(data, data + size_t(width) * height * channels);
+  widths_.push_back(width);
+  heights_.push_back(height);
+
+  float coverage = keep_coverage
+      ? OGLWRAP_AlphaCoverage(image, options.alpha_cutoff, 1.0f) : 0.0f;
+
+  std::vector<float> next;
+  while (width > 1 || height > 1) {
+    GLsizei next_width = std::max<GLsizei>(width / 2, 1);
+    GLsizei next_height = std::max<GLsizei>(height / 2, 1);
+    next.resize(size_t(next_width) * next_height * 4);
+    if (options.filter == MipmapFilter::kKaiser) {
+      OGLWRAP_DownsampleKaiser(image.data(), width, height, next.data(),
+                               next_width, next_height);
+    } else {
+      OGLWRAP_DownsampleBox(image.data(), width, height, next.data(),
+                            next_width, next_height);
+    }
+    image.swap(next);
+    width = next_width;
+    height = next_height;
+
+    // The scaled alpha only affects this level, the next one is still
+    // filtered from the original values.
+    float alpha_scale = keep_coverage
+        ? OGLWRAP_AlphaScale(image, options.alpha_cutoff, coverage) : 1.0f;
+
+    std::vector<GLubyte> level(size_t(width) * height * channels);
+    for (size_t i = 0; i < size_t(width) * height; ++i) {
+      for (GLsizei c = 0; c < channels; ++c) {
+        float value = image[i*4 + c];
+        if (c == 3) {
+          value *= alpha_scale;
+        }
+        if (c < srgb_channels) {
+          level[i*channels + c] = OGLWRAP_LinearToSrgbByte(value);
+        } else {
+          value = std::min(std::max(value, 0.0f), 1.0f);
+          level[i*channels + c] = GLubyte(value * 255.0f + 0.5f);
+        }
+      }
+    }
+    levels_.push_back(std::move(level));
+    widths_.push_back(width);
+    heights_.push_back(height);
+  }
+}
+
+inline std::vector<const void*> MipmapChain::pointers() const {
+  std::vector<const void*> result;
+  for (const std::vector<GLubyte>& level : levels_) {
+    result.push_back(level.data());
+  }
+  return result;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexImage2D)
+template<Texture2DType texture_t>
+void MipmapChain::upload(Texture2DBase<texture_t>& texture,
+                         PixelDataInternalFormat internal_format,
+                         PixelDataFormat format) const {
+  for (GLsizei level = 0; level < levelCount(); ++level) {
+    // The levels are tightly packed, the previous unpack parameters are
+    // restored after the upload.
+    ScopedUnpackRegion region(
+        widths_[level] * GetPixelSize(format, PixelDataType::kUnsignedByte),
+        0, 0, format, PixelDataType::kUnsignedByte);
+    texture.uploadMipmap(level, internal_format, widths_[level],
+                         heights_[level], format, PixelDataType::kUnsignedByte,
+                         levels_[level].data());
+  }
+  texture.maxLevel(levelCount() - 1);
+}
+#endif
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_MIPMAP_GENERATOR_INL_H_
@@ -0,0 +1,100 @@
+// Copyright (c) Tamas Csala
+
+/** @file mipmap_generator.h
+    @brief Implements generating mipmaps on the CPU.
+*/
+
+#ifndef OGLWRAP_TEXTURES_MIPMAP_GENERATOR_H_
+#define OGLWRAP_TEXTURES_MIPMAP_GENERATOR_H_
+
+#include <vector>
+
+#include "../config.h"
+#include "./texture_2D.h"
+#include "./pixel_conversion.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The filters the CPU mipmap generator can use.
+enum class MipmapFilter {
+  /// Averages 2x2 texels (3 texels wide at the odd edges, so none of them is
+  /// dropped). Fast, but slightly blurry.
+  kBox,
+  /// A Kaiser windowed sinc filter with 6x6 taps. Keeps the mipmaps sharper.
+  kKaiser
+};
+
+/// The parameters of the CPU mipmap generation.
+struct MipmapOptions {
+  MipmapFilter filter = MipmapFilter::kBox;
+
+  /// Treat the color channels as sRGB encoded, and filter them in linear
+  /// space (as it is needed for kSrgb8 and kSrgb8Alpha8 textures).
+  bool srgb = false;
+
+  /// If it isn't zero, the alpha channel of every level is scaled so the
+  /// ratio of texels with alpha above this value stays the same as in the
+  /// base level. Keeps alpha tested foliage and fences from fading out in the
+  /// distance.
+  float alpha_cutoff = 0.0f;
+};
+
+/// An image with every level of its mipmap chain, generated on the CPU.
+/** The generation doesn't use OpenGL, so it can run on worker threads. */
+class MipmapChain {
+ public:
+  /// Generates the mipmaps of an image.
+  /** The filtering is done with SSE or NEON where they are available, and
+    * with scalar code everywhere else.
+    * @param data - The pixels of the base level, with 8 bits per channel and
+    *               tightly packed rows.
+    * @param width, height - The size of the base level.
+    * @param channels - The number of channels (1-4). The fourth one is alpha.
+    * @param options - The parameters of the generation. */
+  MipmapChain(const GLubyte* data, GLsizei width, GLsizei height,
+              GLsizei channels, const MipmapOptions& options = MipmapOptions());
+
+  /// Returns the number of levels, including the base level.
+  GLsizei levelCount() const { return levels_.size(); }
+
+  /// Returns the width of a level.
+  GLsizei width(GLsizei level) const { return widths_[level]; }
+
+  /// Returns the height of a level.
+  GLsizei height(GLsizei level) const { return heights_[level]; }
+
+  /// Returns the texels of a level.
+  const GLubyte* data(GLsizei level) const { return levels_[level].data(); }
+
+  /// Returns the texels of every level, that can be passed to
+  /// Texture2DBase::uploadImmutable.
+  std::vector<const void*> pointers() const;
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexImage2D)
+  template<Texture2DType texture_t>
+  /// Uploads every level to a texture, and sets its maximum level.
+  /** The texture should be bound. The unpack parameters are restored after
+    * the upload.
+    * @param texture - The texture to upload to.
+    * @param internal_format - The internal format of the texture.
+    * @param format - The format of the pixel data, that matches the number
+    *                 of channels.
+    * @see glTexImage2D */
+  void upload(Texture2DBase<texture_t>& texture,
+              PixelDataInternalFormat internal_format,
+              PixelDataFormat format) const;
+#endif
+
+ private:
+  std::vector<std::vector<GLubyte>> levels_;
+  std::vector<GLsizei> widths_, heights_;
+};
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./mipmap_generator-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_MIPMAP_GENERATOR_H_
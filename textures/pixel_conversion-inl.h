@@ -0,0 +1,556 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_PIXEL_CONVERSION_INL_H_
+#define OGLWRAP_TEXTURES_PIXEL_CONVERSION_INL_H_
+
+#include <cmath>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define OGLWRAP_SIMD_SSE2 1
+  #if defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define OGLWRAP_SIMD_SSSE3 1
+  #endif
+  #if defined(__F16C__)
+    #include <immintrin.h>
+    #define OGLWRAP_SIMD_F16C 1
+  #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define OGLWRAP_SIMD_NEON 1
+#endif
+
+#include "./pixel_size.h"
+#include "./pixel_conversion.h"
+#include "../context/pixel_ops.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Returns the linear value of every sRGB encoded byte.
+inline const float* OGLWRAP_SrgbToLinearTable() {
+  static const std::vector<float> table = [] {
+    std::vector<float> values(256);
+    for (int i = 0; i < 256; ++i) {
+      float c = i / 255.0f;
+      values[i] = c <= 0.04045f ? c / 12.92f
+                                : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return values;
+  }();
+  return table.data();
+}
+
+static const int kOGLWRAP_LinearToSrgbTableSize = 1 << 14;
+
+/// Returns the sRGB encoded bytes of evenly spaced linear values in [0, 1].
+inline const GLubyte* OGLWRAP_LinearToSrgbTable() {
+  static const std::vector<GLubyte> table = [] {
+    std::vector<GLubyte> values(kOGLWRAP_LinearToSrgbTableSize);
+    for (int i = 0; i < kOGLWRAP_LinearToSrgbTableSize; ++i) {
+      float c = float(i) / (kOGLWRAP_LinearToSrgbTableSize - 1);
+      float s = c <= 0.0031308f ? c * 12.92f
+                                : 1.055f * std::pow(c, 1 / 2.4f) - 0.055f;
+      values[i] = GLubyte(s * 255.0f + 0.5f);
+    }
+    return values;
+  }();
+  return table.data();
+}
+
+/// Encodes a linear value to an sRGB byte.
+inline GLubyte OGLWRAP_LinearToSrgbByte(float value) {
+  // NaN fails every comparison, so it becomes zero instead of reaching the
+  // float to int conversion.
+  value = value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+  return OGLWRAP_LinearToSrgbTable()[
+      int(value * (kOGLWRAP_LinearToSrgbTableSize - 1) + 0.5f)];
+}
+
+inline void ConvertRgbToRgba(const GLubyte* src, GLubyte* dst, size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSSE3
+  // Four pixels at a time, a 16 bytes load reads 12 bytes of the source.
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                        6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(0xFF000000);
+  for (; i + 6 <= count; i += 4) {
+    __m128i rgb = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i*3));
+    __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), rgba);
+  }
+#elif OGLWRAP_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x3_t rgb = vld3q_u8(src + i*3);
+    uint8x16x4_t rgba;
+    rgba.val[0] = rgb.val[0];
+    rgba.val[1] = rgb.val[1];
+    rgba.val[2] = rgb.val[2];
+    rgba.val[3] = vdupq_n_u8(255);
+    vst4q_u8(dst + i*4, rgba);
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i*4 + 0] = src[i*3 + 0];
+    dst[i*4 + 1] = src[i*3 + 1];
+    dst[i*4 + 2] = src[i*3 + 2];
+    dst[i*4 + 3] = 255;
+  }
+}
+
+inline void ConvertRgbaToRgb(const GLubyte* src, GLubyte* dst, size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,
+                                        10, 12, 13, 14, -1, -1, -1, -1);
+  for (; i + 4 <= count; i += 4) {
+    __m128i rgba = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i*4));
+    __m128i rgb = _mm_shuffle_epi8(rgba, shuffle);
+    // Store exactly 12 bytes, so the next pixels aren't overwritten.
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i*3), rgb);
+    int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+    std::memcpy(dst + i*3 + 8, &last, 4);
+  }
+#elif OGLWRAP_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t rgba = vld4q_u8(src + i*4);
+    uint8x16x3_t rgb;
+    rgb.val[0] = rgba.val[0];
+    rgb.val[1] = rgba.val[1];
+    rgb.val[2] = rgba.val[2];
+    vst3q_u8(dst + i*3, rgb);
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i*3 + 0] = src[i*4 + 0];
+    dst[i*3 + 1] = src[i*4 + 1];
+    dst[i*3 + 2] = src[i*4 + 2];
+  }
+}
+
+inline void SwapRedBlue(const GLubyte* src, GLubyte* dst, size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSE2
+  const __m128i green_alpha = _mm_set1_epi32(0xFF00FF00);
+  const __m128i low_byte = _mm_set1_epi32(0x000000FF);
+  for (; i + 4 <= count; i += 4) {
+    __m128i pixels = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i*4));
+    __m128i swapped = _mm_or_si128(
+        _mm_and_si128(pixels, green_alpha),
+        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), low_byte),
+                     _mm_slli_epi32(_mm_and_si128(pixels, low_byte), 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), swapped);
+  }
+#elif OGLWRAP_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(src + i*4);
+    uint8x16_t red = pixels.val[0];
+    pixels.val[0] = pixels.val[2];
+    pixels.val[2] = red;
+    vst4q_u8(dst + i*4, pixels);
+  }
+#endif
+  for (; i < count; ++i) {
+    GLubyte red = src[i*4 + 0];
+    dst[i*4 + 0] = src[i*4 + 2];
+    dst[i*4 + 1] = src[i*4 + 1];
+    dst[i*4 + 2] = red;
+    dst[i*4 + 3] = src[i*4 + 3];
+  }
+}
+
+inline void SwapRedBlueRgb(const GLubyte* src, GLubyte* dst, size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7,
+                                        6, 11, 10, 9, -1, -1, -1, -1);
+  for (; i + 6 <= count; i += 4) {
+    __m128i pixels = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i*3));
+    __m128i swapped = _mm_shuffle_epi8(pixels, shuffle);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i*3), swapped);
+    int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(swapped, 8));
+    std::memcpy(dst + i*3 + 8, &last, 4);
+  }
+#elif OGLWRAP_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x3_t pixels = vld3q_u8(src + i*3);
+    uint8x16_t red = pixels.val[0];
+    pixels.val[0] = pixels.val[2];
+    pixels.val[2] = red;
+    vst3q_u8(dst + i*3, pixels);
+  }
+#endif
+  for (; i < count; ++i) {
+    GLubyte red = src[i*3 + 0];
+    dst[i*3 + 0] = src[i*3 + 2];
+    dst[i*3 + 1] = src[i*3 + 1];
+    dst[i*3 + 2] = red;
+  }
+}
+
+/// Computes round(a * b / 255) for bytes.
+inline GLubyte OGLWRAP_MultiplyBytes(unsigned a, unsigned b) {
+  unsigned x = a * b + 128;
+  return GLubyte((x + (x >> 8)) >> 8);
+}
+
+inline void PremultiplyAlpha(const GLubyte* src, GLubyte* dst, size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rounding = _mm_set1_epi16(128);
+  const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+  for (; i + 4 <= count; i += 4) {
+    __m128i pixels = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i*4));
+    __m128i halves[2] = {_mm_unpacklo_epi8(pixels, zero),
+                         _mm_unpackhi_epi8(pixels, zero)};
+    for (__m128i& half : halves) {
+      __m128i alpha = _mm_shufflehi_epi16(
+          _mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)),
+          _MM_SHUFFLE(3, 3, 3, 3));
+      __m128i x = _mm_add_epi16(_mm_mullo_epi16(half, alpha), rounding);
+      half = _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+    __m128i result = _mm_packus_epi16(halves[0], halves[1]);
+    result = _mm_or_si128(_mm_andnot_si128(alpha_mask, result),
+                          _mm_and_si128(alpha_mask, pixels));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*4), result);
+  }
+#elif OGLWRAP_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(src + i*4);
+    for (int c = 0; c < 3; ++c) {
+      uint16x8_t low = vmull_u8(vget_low_u8(pixels.val[c]),
+                                vget_low_u8(pixels.val[3]));
+      uint16x8_t high = vmull_u8(vget_high_u8(pixels.val[c]),
+                                 vget_high_u8(pixels.val[3]));
+      pixels.val[c] = vcombine_u8(vraddhn_u16(low, vrshrq_n_u16(low, 8)),
+                                  vraddhn_u16(high, vrshrq_n_u16(high, 8)));
+    }
+    vst4q_u8(dst + i*4, pixels);
+  }
+#endif
+  for (; i < count; ++i) {
+    GLubyte alpha = src[i*4 + 3];
+    dst[i*4 + 0] = OGLWRAP_MultiplyBytes(src[i*4 + 0], alpha);
+    dst[i*4 + 1] = OGLWRAP_MultiplyBytes(src[i*4 + 1], alpha);
+    dst[i*4 + 2] = OGLWRAP_MultiplyBytes(src[i*4 + 2], alpha);
+    dst[i*4 + 3] = alpha;
+  }
+}
+
+/// Converts a float to a half float, rounding to the nearest even.
+inline GLushort OGLWRAP_FloatToHalf(GLfloat value) {
+  GLuint bits;
+  std::memcpy(&bits, &value, 4);
+  GLuint sign = (bits >> 16) & 0x8000;
+  GLuint abs = bits & 0x7FFFFFFF;
+
+  if (abs >= 0x7F800000) {  // inf or nan
+    return GLushort(sign | 0x7C00 | (abs > 0x7F800000 ? 0x200 : 0));
+  } else if (abs >= 0x477FF000) {  // rounds to inf
+    return GLushort(sign | 0x7C00);
+  } else if (abs < 0x38800000) {  // zero or denormal
+    GLfloat abs_value;
+    std::memcpy(&abs_value, &abs, 4);
+    return GLushort(sign | GLuint(std::nearbyint(abs_value * 16777216.0f)));
+  } else {
+    // Rebias the exponent, and round the mantissa to the nearest even.
+    abs += 0xC8000FFF + ((abs >> 13) & 1);
+    return GLushort(sign | (abs >> 13));
+  }
+}
+
+/// Converts a half float to a float.
+inline GLfloat OGLWRAP_HalfToFloat(GLushort half) {
+  GLuint sign = GLuint(half & 0x8000) << 16;
+  GLuint exponent = (half >> 10) & 0x1F;
+  GLuint mantissa = half & 0x3FF;
+  GLuint bits;
+  if (exponent == 0) {
+    GLfloat value = mantissa / 16777216.0f;
+    std::memcpy(&bits, &value, 4);
+    bits |= sign;
+  } else if (exponent == 31) {
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  GLfloat result;
+  std::memcpy(&result, &bits, 4);
+  return result;
+}
+
+inline void ConvertFloatToHalf(const GLfloat* src, GLushort* dst,
+                               size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_F16C
+  for (; i + 4 <= count; i += 4) {
+    __m128i halves = _mm_cvtps_ph(_mm_loadu_ps(src + i),
+                                  _MM_FROUND_TO_NEAREST_INT);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), halves);
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = OGLWRAP_FloatToHalf(src[i]);
+  }
+}
+
+inline void ConvertHalfToFloat(const GLushort* src, GLfloat* dst,
+                               size_t count) {
+  size_t i = 0;
+#if OGLWRAP_SIMD_F16C
+  for (; i + 4 <= count; i += 4) {
+    __m128 floats = _mm_cvtph_ps(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+    _mm_storeu_ps(dst + i, floats);
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = OGLWRAP_HalfToFloat(src[i]);
+  }
+}
+
+inline void ConvertSrgbToLinear(const GLubyte* src, GLfloat* dst,
+                                size_t count) {
+  // A table lookup is faster than any vectorized evaluation of the curve.
+  const float* table = OGLWRAP_SrgbToLinearTable();
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = table[src[i]];
+  }
+}
+
+inline void ConvertLinearToSrgb(const GLfloat* src, GLubyte* dst,
+                                size_t count) {
+  const GLubyte* table = OGLWRAP_LinearToSrgbTable();
+  size_t i = 0;
+#if OGLWRAP_SIMD_SSE2
+  // Computes the table indices four at a time.
+  const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(kOGLWRAP_LinearToSrgbTableSize - 1);
+  alignas(16) int32_t indices[4];
+  for (; i + 4 <= count; i += 4) {
+    __m128 values = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices),
+                    _mm_cvtps_epi32(_mm_mul_ps(values, scale)));
+    dst[i + 0] = table[indices[0]];
+    dst[i + 1] = table[indices[1]];
+    dst[i + 2] = table[indices[2]];
+    dst[i + 3] = table[indices[3]];
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = OGLWRAP_LinearToSrgbByte(src[i]);
+  }
+}
+
+inline void FlipRows(void* data, size_t row_size, GLsizei height) {
+  GLubyte* bytes = static_cast<GLubyte*>(data);
+  std::vector<GLubyte> temp(row_size);
+  for (GLsizei y = 0; y < height / 2; ++y) {
+    GLubyte* top = bytes + y * row_size;
+    GLubyte* bottom = bytes + (height - 1 - y) * row_size;
+    std::memcpy(temp.data(), top, row_size);
+    std::memcpy(top, bottom, row_size);
+    std::memcpy(bottom, temp.data(), row_size);
+  }
+}
+
+template<void (*kernel)(const GLubyte*, GLubyte*, size_t)>
+/// Adapts a byte kernel to PixelConversionFunc.
+void OGLWRAP_ByteConversion(const void* src, void* dst, size_t count) {
+  kernel(static_cast<const GLubyte*>(src), static_cast<GLubyte*>(dst), count);
+}
+
+template<void (*kernel)(const GLubyte*, GLubyte*, size_t),
+         void (*swap)(const GLubyte*, GLubyte*, size_t)>
+/// Runs a byte kernel, and swaps the red and blue channels of its result.
+void OGLWRAP_SwappedByteConversion(const void* src, void* dst, size_t count) {
+  GLubyte* bytes = static_cast<GLubyte*>(dst);
+  kernel(static_cast<const GLubyte*>(src), bytes, count);
+  swap(bytes, bytes, count);
+}
+
+template<GLsizei components>
+/// Converts count pixels of float components to half floats.
+void OGLWRAP_FloatToHalfConversion(const void* src, void* dst, size_t count) {
+  ConvertFloatToHalf(static_cast<const GLfloat*>(src),
+                     static_cast<GLushort*>(dst), count * components);
+}
+
+template<GLsizei components>
+/// Converts count pixels of half float components to floats.
+void OGLWRAP_HalfToFloatConversion(const void* src, void* dst, size_t count) {
+  ConvertHalfToFloat(static_cast<const GLushort*>(src),
+                     static_cast<GLfloat*>(dst), count * components);
+}
+
+inline PixelConversionFunc FindPixelConversion(PixelDataFormat src_format,
+                                               PixelDataType src_type,
+                                               PixelDataFormat dst_format,
+                                               PixelDataType dst_type) {
+  using Format = PixelDataFormat;
+  using Type = PixelDataType;
+
+  if (src_type == Type::kUnsignedByte && dst_type == Type::kUnsignedByte) {
+    // The kernels only know these layouts. The integer formats have the same
+    // component counts, but they mustn't be mistaken for them.
+    auto is_color = [](Format format) {
+      return format == Format::kRgb || format == Format::kBgr ||
+             format == Format::kRgba || format == Format::kBgra;
+    };
+    bool src_bgr = src_format == Format::kBgr || src_format == Format::kBgra;
+    bool dst_bgr = dst_format == Format::kBgr || dst_format == Format::kBgra;
+    bool src_alpha = src_format == Format::kRgba || src_format == Format::kBgra;
+    bool dst_alpha = dst_format == Format::kRgba || dst_format == Format::kBgra;
+    if (!is_color(src_format) || !is_color(dst_format) ||
+        src_format == dst_format) {
+      return nullptr;
+    } else if (src_alpha == dst_alpha) {
+      return src_alpha ? OGLWRAP_ByteConversion<SwapRedBlue>
+                       : OGLWRAP_ByteConversion<SwapRedBlueRgb>;
+    } else if (src_bgr == dst_bgr) {
+      return src_alpha ? OGLWRAP_ByteConversion<ConvertRgbaToRgb>
+                       : OGLWRAP_ByteConversion<ConvertRgbToRgba>;
+    } else {
+      return src_alpha
+          ? OGLWRAP_SwappedByteConversion<ConvertRgbaToRgb, SwapRedBlueRgb>
+          : OGLWRAP_SwappedByteConversion<ConvertRgbToRgba, SwapRedBlue>;
+    }
+  }
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_HALF_FLOAT)
+  if (src_format == dst_format) {
+    bool to_half = src_type == Type::kFloat && dst_type == Type::kHalfFloat;
+    bool to_float = src_type == Type::kHalfFloat && dst_type == Type::kFloat;
+    if (to_half || to_float) {
+      switch (GetComponentCount(src_format)) {
+        case 1: return to_half ? OGLWRAP_FloatToHalfConversion<1>
+                               : OGLWRAP_HalfToFloatConversion<1>;
+        case 2: return to_half ? OGLWRAP_FloatToHalfConversion<2>
+                               : OGLWRAP_HalfToFloatConversion<2>;
+        case 3: return to_half ? OGLWRAP_FloatToHalfConversion<3>
+                               : OGLWRAP_HalfToFloatConversion<3>;
+        case 4: return to_half ? OGLWRAP_FloatToHalfConversion<4>
+                               : OGLWRAP_HalfToFloatConversion<4>;
+      }
+    }
+  }
+#endif
+
+  return nullptr;
+}
+
+inline bool ConvertPixels(GLsizei width, GLsizei height,
+                          PixelDataFormat src_format, PixelDataType src_type,
+                          const void* src,
+                          PixelDataFormat dst_format, PixelDataType dst_type,
+                          void* dst, bool flip_rows) {
+  size_t src_row = size_t(width) * GetPixelSize(src_format, src_type);
+  size_t dst_row = size_t(width) * GetPixelSize(dst_format, dst_type);
+  if (src_row == 0 || dst_row == 0) {
+    return false;
+  }
+
+  PixelConversionFunc convert = nullptr;
+  if (src_format != dst_format || src_type != dst_type) {
+    convert = FindPixelConversion(src_format, src_type, dst_format, dst_type);
+    if (!convert) {
+      return false;
+    }
+  }
+
+  // The kernels can only work in place if they don't change the pixel size,
+  // otherwise they'd overwrite the source pixels before reading them.
+  std::vector<GLubyte> src_copy;
+  if (src == dst && convert && src_row != dst_row) {
+    const GLubyte* begin = static_cast<const GLubyte*>(src);
+    src_copy.assign(begin, begin + src_row * height);
+    src = src_copy.data();
+  }
+
+  const GLubyte* src_bytes = static_cast<const GLubyte*>(src);
+  GLubyte* dst_bytes = static_cast<GLubyte*>(dst);
+  if (src == dst) {
+    if (convert) {
+      convert(src, dst, size_t(width) * height);
+    }
+    if (flip_rows) {
+      FlipRows(dst, dst_row, height);
+    }
+  } else if (!flip_rows) {
+    if (convert) {
+      convert(src, dst, size_t(width) * height);
+    } else {
+      std::memcpy(dst, src, src_row * height);
+    }
+  } else {
+    // Flipping while converting avoids a second pass over the image.
+    for (GLsizei y = 0; y < height; ++y) {
+      const GLubyte* src_line = src_bytes + y * src_row;
+      GLubyte* dst_line = dst_bytes + (height - 1 - y) * dst_row;
+      if (convert) {
+        convert(src_line, dst_line, width);
+      } else {
+        std::memcpy(dst_line, src_line, src_row);
+      }
+    }
+  }
+  return true;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glReadPixels) \
+    && defined(GL_IMPLEMENTATION_COLOR_READ_FORMAT))
+inline void ReadPixelsConverted(GLint x, GLint y, GLsizei width,
+                                GLsizei height, PixelDataFormat format,
+                                PixelDataType type, void* data,
+                                bool flip_rows) {
+  GLint read_format, read_type;
+  gl(GetIntegerv(GL_IMPLEMENTATION_COLOR_READ_FORMAT, &read_format));
+  gl(GetIntegerv(GL_IMPLEMENTATION_COLOR_READ_TYPE, &read_type));
+
+  PixelDataFormat native_format = PixelDataFormat(read_format);
+  PixelDataType native_type = PixelDataType(read_type);
+  PixelConversionFunc convert =
+      FindPixelConversion(native_format, native_type, format, type);
+  if (!convert) {
+    GLsizei row_size = width * GetPixelSize(format, type);
+    {
+      ScopedPackRegion tightly_packed(row_size, 0, 0, format, type);
+      ReadPixels(x, y, width, height, format, type, data);
+    }
+    if (flip_rows) {
+      FlipRows(data, row_size, height);
+    }
+    return;
+  }
+
+  GLsizei native_row_size = width * GetPixelSize(native_format, native_type);
+  std::vector<GLubyte> native(size_t(native_row_size) * height);
+  {
+    ScopedPackRegion tightly_packed(native_row_size, 0, 0, native_format,
+                                    native_type);
+    ReadPixels(x, y, width, height, native_format, native_type,
+               native.data());
+  }
+  ConvertPixels(width, height, native_format, native_type, native.data(),
+                format, type, data, flip_rows);
+}
+#endif
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_PIXEL_CONVERSION_INL_H_
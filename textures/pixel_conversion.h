@@ -0,0 +1,114 @@
+// Copyright (c) Tamas Csala
+
+/** @file pixel_conversion.h
+    @brief Implements converting client side pixels between layouts.
+*/
+
+#ifndef OGLWRAP_TEXTURES_PIXEL_CONVERSION_H_
+#define OGLWRAP_TEXTURES_PIXEL_CONVERSION_H_
+
+#include <cstddef>
+
+#include "../config.h"
+#include "../enums/pixel_data_type.h"
+#include "../enums/pixel_data_format.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+// The conversion kernels work on tightly packed arrays of pixels (or
+// components, where it's noted), and use SSE2/SSSE3/F16C or NEON instructions
+// where they are available. The source and the destination must not overlap,
+// unless they have the same pixel size, in which case the conversion can be
+// done in place.
+
+/// Expands RGB (or BGR) bytes to RGBA (or BGRA), with an opaque alpha.
+void ConvertRgbToRgba(const GLubyte* src, GLubyte* dst, size_t count);
+
+/// Drops the alpha of RGBA (or BGRA) bytes.
+void ConvertRgbaToRgb(const GLubyte* src, GLubyte* dst, size_t count);
+
+/// Swaps the red and blue channels of RGBA bytes (RGBA <-> BGRA).
+void SwapRedBlue(const GLubyte* src, GLubyte* dst, size_t count);
+
+/// Swaps the red and blue channels of RGB bytes (RGB <-> BGR).
+void SwapRedBlueRgb(const GLubyte* src, GLubyte* dst, size_t count);
+
+/// Multiplies the color channels of RGBA (or BGRA) bytes with their alpha.
+void PremultiplyAlpha(const GLubyte* src, GLubyte* dst, size_t count);
+
+/// Converts count floats to half floats, rounding to the nearest.
+void ConvertFloatToHalf(const GLfloat* src, GLushort* dst, size_t count);
+
+/// Converts count half floats to floats.
+void ConvertHalfToFloat(const GLushort* src, GLfloat* dst, size_t count);
+
+/// Decodes count sRGB encoded bytes to linear floats.
+void ConvertSrgbToLinear(const GLubyte* src, GLfloat* dst, size_t count);
+
+/// Encodes count linear floats (clamped to [0, 1]) to sRGB bytes.
+void ConvertLinearToSrgb(const GLfloat* src, GLubyte* dst, size_t count);
+
+/// Reverses the order of the rows of an image in place.
+/** Converts between the bottom-up row order of OpenGL and the top-down order
+  * of most image files.
+  * @param data - The pixels of the image.
+  * @param row_size - The size of a row in bytes, including its padding.
+  * @param height - The number of rows. */
+void FlipRows(void* data, size_t row_size, GLsizei height);
+
+/// A kernel, that converts count tightly packed pixels.
+using PixelConversionFunc = void (*)(const void* src, void* dst, size_t count);
+
+/// Returns the kernel, that converts between two client side pixel layouts.
+/** Supports byte RGB, BGR, RGBA and BGRA reordering, and float <-> half float
+  * conversion of the same format.
+  * @return The kernel, or nullptr if the conversion isn't supported. */
+PixelConversionFunc FindPixelConversion(PixelDataFormat src_format,
+                                        PixelDataType src_type,
+                                        PixelDataFormat dst_format,
+                                        PixelDataType dst_type);
+
+/// Converts an image between two client side pixel layouts.
+/** The rows of both images must be tightly packed. The conversion can be
+  * done in place (src == dst), if dst is large enough for the converted
+  * image. If the pixel size changes, the source is copied first.
+  * @param width, height - The size of the image.
+  * @param src_format, src_type, src - The layout and the pixels of the source.
+  * @param dst_format, dst_type, dst - The layout and the pixels of the
+  *                                    destination.
+  * @param flip_rows - Reverse the order of the rows too.
+  * @return False if the conversion isn't supported. */
+bool ConvertPixels(GLsizei width, GLsizei height,
+                   PixelDataFormat src_format, PixelDataType src_type,
+                   const void* src,
+                   PixelDataFormat dst_format, PixelDataType dst_type,
+                   void* dst, bool flip_rows = false);
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glReadPixels) \
+    && defined(GL_IMPLEMENTATION_COLOR_READ_FORMAT))
+/// Reads a block of pixels from the framebuffer, converting them on the CPU.
+/** Drivers often convert the pixels on a slow path if the requested layout
+  * isn't the one of the framebuffer. This function reads the pixels in the
+  * layout the implementation prefers, and converts them with the kernels above.
+  * If there isn't a kernel for the conversion, the driver does it. The rows
+  * of data are tightly packed, the pack parameters are only changed while
+  * reading, and they are restored afterwards.
+  * @param x, y - The lower left corner of the block.
+  * @param width, height - The size of the block.
+  * @param format, type - The layout of data.
+  * @param data - Receives the pixels.
+  * @param flip_rows - Store the rows top-down.
+  * @see glReadPixels, GL_IMPLEMENTATION_COLOR_READ_FORMAT */
+void ReadPixelsConverted(GLint x, GLint y, GLsizei width, GLsizei height,
+                         PixelDataFormat format, PixelDataType type,
+                         void* data, bool flip_rows = false);
+#endif
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./pixel_conversion-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_PIXEL_CONVERSION_H_
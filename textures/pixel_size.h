@@ -0,0 +1,156 @@
+// Copyright (c) Tamas Csala
+
+/** @file pixel_size.h
+    @brief Implements functions that compute the size of client side pixels.
+*/
+
+#ifndef OGLWRAP_TEXTURES_PIXEL_SIZE_H_
+#define OGLWRAP_TEXTURES_PIXEL_SIZE_H_
+
+#include "../config.h"
+#include "../enums/pixel_data_type.h"
+#include "../enums/pixel_data_format.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Returns the number of components of a pixel format.
+/** @param format - The format of the pixel data. */
+inline GLsizei GetComponentCount(PixelDataFormat format) {
+  switch (format) {
+    case PixelDataFormat::kStencilIndex:
+    case PixelDataFormat::kDepthComponent:
+    case PixelDataFormat::kRed:
+    case PixelDataFormat::kGreen:
+    case PixelDataFormat::kBlue:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RED_INTEGER)
+    case PixelDataFormat::kRedInteger:
+    case PixelDataFormat::kGreenInteger:
+    case PixelDataFormat::kBlueInteger:
+#endif
+      return 1;
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_DEPTH_STENCIL)
+    case PixelDataFormat::kDepthStencil:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RG)
+    case PixelDataFormat::kRg:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RG_INTEGER)
+    case PixelDataFormat::kRgInteger:
+#endif
+      return 2;
+    case PixelDataFormat::kRgb:
+    case PixelDataFormat::kBgr:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RGB_INTEGER)
+    case PixelDataFormat::kRgbInteger:
+    case PixelDataFormat::kBgrInteger:
+#endif
+      return 3;
+    case PixelDataFormat::kRgba:
+    case PixelDataFormat::kBgra:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_RGBA_INTEGER)
+    case PixelDataFormat::kRgbaInteger:
+    case PixelDataFormat::kBgraInteger:
+#endif
+      return 4;
+  }
+  return 0;
+}
+
+/// Returns the size of the elements of a data type in bytes.
+/** For packed types, a whole pixel is one element. Returns zero if the size
+  * isn't known.
+  * @param type - The data type of the pixel data. */
+inline GLsizei GetElementSize(PixelDataType type) {
+  switch (type) {
+    case PixelDataType::kUnsignedByte:
+    case PixelDataType::kByte:
+    case PixelDataType::kUnsignedByte332:
+    case PixelDataType::kUnsignedByte233Rev:
+      return 1;
+    case PixelDataType::kUnsignedShort:
+    case PixelDataType::kShort:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_HALF_FLOAT)
+    case PixelDataType::kHalfFloat:
+#endif
+    case PixelDataType::kUnsignedShort565:
+    case PixelDataType::kUnsignedShort565Rev:
+    case PixelDataType::kUnsignedShort4444:
+    case PixelDataType::kUnsignedShort4444Rev:
+    case PixelDataType::kUnsignedShort5551:
+    case PixelDataType::kUnsignedShort1555Rev:
+      return 2;
+    case PixelDataType::kUnsignedInt:
+    case PixelDataType::kInt:
+    case PixelDataType::kFloat:
+    case PixelDataType::kUnsignedInt8888:
+    case PixelDataType::kUnsignedInt8888Rev:
+    case PixelDataType::kUnsignedInt1010102:
+    case PixelDataType::kUnsignedInt2101010Rev:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNSIGNED_INT_24_8)
+    case PixelDataType::kUnsignedInt248:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNSIGNED_INT_10F_11F_11F_REV)
+    case PixelDataType::kUnsignedInt10F11F11FRev:
+    case PixelDataType::kUnsignedInt5999Rev:
+#endif
+      return 4;
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_FLOAT_32_UNSIGNED_INT_24_8_REV)
+    case PixelDataType::kFloat32UnsignedInt248Rev:
+      return 8;
+#endif
+  }
+  return 0;
+}
+
+/// Returns the size of a pixel in bytes, or zero if it isn't known.
+/** @param format - The format of the pixel data.
+  * @param type - The data type of the pixel data. For packed types the whole
+  *               pixel is stored in one element of the type. */
+inline GLsizei GetPixelSize(PixelDataFormat format, PixelDataType type) {
+  switch (type) {
+    case PixelDataType::kUnsignedByte:
+    case PixelDataType::kByte:
+      return GetComponentCount(format);
+    case PixelDataType::kUnsignedShort:
+    case PixelDataType::kShort:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_HALF_FLOAT)
+    case PixelDataType::kHalfFloat:
+#endif
+      return 2 * GetComponentCount(format);
+    case PixelDataType::kUnsignedInt:
+    case PixelDataType::kInt:
+    case PixelDataType::kFloat:
+      return 4 * GetComponentCount(format);
+    case PixelDataType::kUnsignedByte332:
+    case PixelDataType::kUnsignedByte233Rev:
+      return 1;
+    case PixelDataType::kUnsignedShort565:
+    case PixelDataType::kUnsignedShort565Rev:
+    case PixelDataType::kUnsignedShort4444:
+    case PixelDataType::kUnsignedShort4444Rev:
+    case PixelDataType::kUnsignedShort5551:
+    case PixelDataType::kUnsignedShort1555Rev:
+      return 2;
+    case PixelDataType::kUnsignedInt8888:
+    case PixelDataType::kUnsignedInt8888Rev:
+    case PixelDataType::kUnsignedInt1010102:
+    case PixelDataType::kUnsignedInt2101010Rev:
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNSIGNED_INT_24_8)
+    case PixelDataType::kUnsignedInt248:
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_UNSIGNED_INT_10F_11F_11F_REV)
+    case PixelDataType::kUnsignedInt10F11F11FRev:
+    case PixelDataType::kUnsignedInt5999Rev:
+#endif
+      return 4;
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_FLOAT_32_UNSIGNED_INT_24_8_REV)
+    case PixelDataType::kFloat32UnsignedInt248Rev:
+      return 8;
+#endif
+  }
+  return 0;
+}
+
+}  // namespace oglwrap
+
+#endif  // OGLWRAP_TEXTURES_PIXEL_SIZE_H_
@@ -0,0 +1,302 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_STREAMING_TEXTURE_INL_H_
+#define OGLWRAP_TEXTURES_STREAMING_TEXTURE_INL_H_
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+#include "./streaming_texture.h"
+#include "../context/binding.h"
+#include "../context/pixel_ops.h"
+#include "../context/extensions.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexStorage2D) \
+    && defined(glTexSubImage2D) && defined(glCompressedTexSubImage2D) \
+    && defined(glMapBufferRange) && defined(glUnmapBuffer))
+
+inline StreamingTexture2D::StreamingTexture2D(const AssetPack& pack,
+                                              const AssetPackEntry& entry,
+                                              GLsizei initial_size,
+                                              bool allow_sparse)
+    : pack_(&pack), entry_(&entry) {
+  GLint level_count = entry.level_count;
+  resident_level_ = requested_level_ = level_count - 1;
+  if (level_count == 0) {
+    return;
+  }
+
+  PixelDataInternalFormat internal_format =
+      PixelDataInternalFormat(entry.internal_format);
+  sparse_ = allow_sparse && initSparse(internal_format);
+  if (!sparse_) {
+    Bind(texture_);
+    texture_.storage(level_count, internal_format, entry.levels[0].width,
+                     entry.levels[0].height);
+  }
+  texture_.maxLevel(level_count - 1);
+
+  GLint level = level_count - 1;
+  while (level > 0 && entry.levels[level - 1].width <= GLuint(initial_size) &&
+         entry.levels[level - 1].height <= GLuint(initial_size)) {
+    --level;
+  }
+
+  for (GLint i = level_count - 1; i >= level; --i) {
+    commitLevel(i, true);
+    uploadLevel(i, pack.levelData(entry, i));
+  }
+  makeResident(level);
+}
+
+inline bool StreamingTexture2D::initSparse(
+    PixelDataInternalFormat internal_format) {
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexPageCommitmentARB) \
+    && defined(glGetInternalformativ))
+  if (!IsExtensionSupported("GL_ARB_sparse_texture")) {
+    return false;
+  }
+
+  GLint page_size_count = 0;
+  gl(GetInternalformativ(GL_TEXTURE_2D, GLenum(internal_format),
+                         GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &page_size_count));
+  GLint max_size = 0;
+  gl(GetIntegerv(GL_MAX_SPARSE_TEXTURE_SIZE_ARB, &max_size));
+  GLint width = entry_->levels[0].width, height = entry_->levels[0].height;
+  if (page_size_count == 0 || std::max(width, height) > max_size) {
+    return false;
+  }
+
+  // The size of a sparse texture must be a multiple of the page size. The
+  // size of the asset can't be changed, as that would change the texture
+  // coordinates.
+  GLint page_width = 1, page_height = 1;
+  gl(GetInternalformativ(GL_TEXTURE_2D, GLenum(internal_format),
+                         GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &page_width));
+  gl(GetInternalformativ(GL_TEXTURE_2D, GLenum(internal_format),
+                         GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &page_height));
+  if (page_width <= 0 || page_height <= 0 || width % page_width != 0 ||
+      height % page_height != 0) {
+    return false;
+  }
+
+  Bind(texture_);
+  gl(TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE));
+  gl(TexParameteri(GL_TEXTURE_2D, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0));
+  texture_.storage(entry_->level_count, internal_format, width, height);
+
+  // The allocation can still fail. That leaves the texture mutable, which is
+  // checked instead of glGetError, because the debug error checking already
+  // consumes the error. The sparse flag can't be cleared from the texture
+  // object, so it's recreated for the regular storage.
+  GLint immutable = GL_FALSE;
+  gl(GetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_FORMAT,
+                       &immutable));
+  if (!immutable) {
+    texture_ = Texture2D();
+    return false;
+  }
+  gl(GetTexParameteriv(GL_TEXTURE_2D, GL_NUM_SPARSE_LEVELS_ARB,
+                       &sparse_levels_));
+  return true;
+#else
+  (void)internal_format;
+  return false;
+#endif
+}
+
+inline void StreamingTexture2D::commitLevel(GLint level, bool commit) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexPageCommitmentARB)
+  // Decommitting a level of the mip tail would decommit the coarsest levels,
+  // that must stay resident.
+  if (!sparse_ || (!commit && level >= sparse_levels_)) {
+    return;
+  }
+  const AssetPackLevel& info = entry_->levels[level];
+  Bind(texture_);
+  gl(TexPageCommitmentARB(GL_TEXTURE_2D, level, 0, 0, 0, info.width,
+                          info.height, 1, commit ? GL_TRUE : GL_FALSE));
+#else
+  (void)level;
+  (void)commit;
+#endif
+}
+
+inline StreamingTexture2D::~StreamingTexture2D() {
+  if (isStreaming()) {
+    worker_.wait();
+    Bind(buffer_);
+    gl(UnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    Unbind(BufferType::kPixelUnpackBuffer);
+  }
+}
+
+inline void StreamingTexture2D::requestLevel(GLint level) {
+  requested_level_ = std::max(std::min(requested_level_, level), 0);
+}
+
+inline bool StreamingTexture2D::streamNextLevel() {
+  if (isStreaming() || requested_level_ >= resident_level_) {
+    return false;
+  }
+
+  GLint level = resident_level_ - 1;
+  size_t size = levelSize(level);
+
+  // The previous data store might still be read by an upload, orphan it.
+  Bind(buffer_);
+  buffer_.data(GLsizei(size), nullptr, BufferUsage::kStreamDraw);
+  Bitfield<BufferMapAccessFlags> access =
+      {BufferMapAccessFlags::kMapWriteBit,
+       BufferMapAccessFlags::kMapInvalidateBufferBit};
+  void* mapped = gl(MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access));
+  Unbind(BufferType::kPixelUnpackBuffer);
+  if (!mapped) {
+    return false;
+  }
+
+  // The worker only touches client memory, so it doesn't need a GL context.
+  // Reading the level from the mapping is what loads it from the disk.
+  const void* source = pack_->levelData(*entry_, level);
+  worker_ = std::async(std::launch::async, [=]() {
+    std::memcpy(mapped, source, size);
+  });
+  streamed_level_ = level;
+  return true;
+}
+
+inline bool StreamingTexture2D::finishStreaming() {
+  if (!isStreaming() || worker_.wait_for(std::chrono::seconds(0)) !=
+                        std::future_status::ready) {
+    return false;
+  }
+
+  GLint level = streamed_level_;
+  streamed_level_ = -1;
+  worker_.get();
+
+  Bind(buffer_);
+  // The data store can get corrupted while it's mapped (for example on a
+  // screen mode change), the level is streamed again later in that case. The
+  // level is dropped too, if the levels above it were evicted meanwhile.
+  bool valid = gl(UnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+  valid = valid && level == resident_level_ - 1;
+  if (valid) {
+    commitLevel(level, true);
+    Bind(texture_);
+    uploadLevel(level, nullptr);  // An offset into the unpack buffer
+  }
+  Unbind(BufferType::kPixelUnpackBuffer);
+
+  if (valid) {
+    makeResident(level);
+  }
+  return valid;
+}
+
+inline void StreamingTexture2D::evictLevels(GLint level) {
+  level = std::min(level, levelCount() - 1);
+  GLint previous_level = resident_level_;
+  if (level <= previous_level) {
+    return;
+  }
+
+  // The evicted levels mustn't be sampled after their pages are gone.
+  makeResident(level);
+  for (GLint i = previous_level; i < level; ++i) {
+    commitLevel(i, false);
+  }
+}
+
+inline void StreamingTexture2D::uploadLevel(GLint level, const void* data) {
+  const AssetPackLevel& info = entry_->levels[level];
+  if (entry_->format == 0) {
+    texture_.subUploadCompressedMipmap(
+        level, 0, 0, info.width, info.height,
+        PixelDataInternalFormat(entry_->internal_format), info.size, data);
+  } else {
+    // The rows are tightly packed in the pack. The previous unpack parameters
+    // are restored after the upload.
+    PixelDataFormat format = PixelDataFormat(entry_->format);
+    PixelDataType type = PixelDataType(entry_->type);
+    ScopedUnpackRegion region(info.width * GetPixelSize(format, type), 0, 0,
+                              format, type);
+    texture_.subUploadMipmap(level, 0, 0, info.width, info.height, format,
+                             type, data);
+  }
+}
+
+inline void StreamingTexture2D::makeResident(GLint level) {
+  Bind(texture_);
+  texture_.baseLevel(level);
+  texture_.minLod(GLfloat(level));
+  resident_level_ = level;
+}
+
+inline void TextureStreamer::add(StreamingTexture2D& texture) {
+  textures_.push_back(&texture);
+}
+
+inline void TextureStreamer::remove(StreamingTexture2D& texture) {
+  textures_.erase(std::remove(textures_.begin(), textures_.end(), &texture),
+                  textures_.end());
+}
+
+inline void TextureStreamer::update() {
+  size_t streams = 0;
+  std::vector<StreamingTexture2D*> candidates;
+  for (StreamingTexture2D* texture : textures_) {
+    texture->finishStreaming();
+    if (texture->isStreaming()) {
+      ++streams;
+    } else if (texture->requestedLevel() < texture->residentLevel()) {
+      candidates.push_back(texture);
+    }
+  }
+
+  // The textures, that are the most blurry compared to their requests come
+  // first, and the smaller uploads break the ties.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const StreamingTexture2D* a, const StreamingTexture2D* b) {
+    GLint a_missing = a->residentLevel() - a->requestedLevel();
+    GLint b_missing = b->residentLevel() - b->requestedLevel();
+    if (a_missing != b_missing) {
+      return a_missing > b_missing;
+    }
+    return a->levelSize(a->residentLevel() - 1) <
+           b->levelSize(b->residentLevel() - 1);
+  });
+
+  size_t bytes = 0;
+  for (StreamingTexture2D* texture : candidates) {
+    if (streams >= max_streams_) {
+      break;
+    }
+    size_t size = texture->levelSize(texture->residentLevel() - 1);
+    if (bytes > 0 && bytes + size > bytes_per_frame_) {
+      continue;
+    }
+    if (texture->streamNextLevel()) {
+      bytes += size;
+      ++streams;
+    }
+  }
+
+  for (StreamingTexture2D* texture : textures_) {
+    texture->clearRequest();
+  }
+}
+
+#endif  // glTexStorage2D && glTexSubImage2D && glCompressedTexSubImage2D &&
+        // glMapBufferRange && glUnmapBuffer
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_STREAMING_TEXTURE_INL_H_
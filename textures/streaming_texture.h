@@ -0,0 +1,184 @@
+// Copyright (c) Tamas Csala
+
+/** @file streaming_texture.h
+    @brief Implements textures, whose finer mipmap levels are streamed from an
+           asset pack on demand.
+*/
+
+#ifndef OGLWRAP_TEXTURES_STREAMING_TEXTURE_H_
+#define OGLWRAP_TEXTURES_STREAMING_TEXTURE_H_
+
+#include <future>
+#include <vector>
+#include <cstddef>
+
+#include "../config.h"
+#include "../buffer.h"
+#include "../asset_pack.h"
+#include "./texture_2D.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexStorage2D) \
+    && defined(glTexSubImage2D) && defined(glCompressedTexSubImage2D) \
+    && defined(glMapBufferRange) && defined(glUnmapBuffer))
+/// A two-dimensional texture, whose finer mipmap levels are uploaded on
+/// demand.
+/** Only the smallest levels are uploaded when the texture is created. The
+  * renderer requests the level it needs every frame, and the finer levels are
+  * uploaded one at a time, the coarsest first: a worker thread copies a level
+  * from the memory mapped pack into a pixel unpack buffer, and the texture is
+  * updated from that buffer once the copy has finished. GL_TEXTURE_BASE_LEVEL
+  * and GL_TEXTURE_MIN_LOD are clamped to the finest uploaded level, so the
+  * texture is always complete. The texture is bound by the functions, that
+  * modify it. Use a TextureStreamer to prioritize the uploads of many
+  * textures.
+  *
+  * With ARB_sparse_texture, only the pages of the resident levels are
+  * committed, so the levels, that aren't needed don't take video memory, and
+  * evictLevels() gives the memory of the finer levels back. Without it, the
+  * storage of every level is allocated upfront, and streaming only saves the
+  * upload bandwidth and the load time, but not video memory. */
+class StreamingTexture2D {
+ public:
+  /// Allocates the storage of every level, and uploads the smallest ones.
+  /** @param pack - The pack, that contains the texture. It must outlive the
+    *               streaming texture.
+    * @param entry - A texture asset of the pack.
+    * @param initial_size - The levels, that aren't wider or higher than this
+    *                       are uploaded immediately. The coarsest level is
+    *                       always uploaded.
+    * @param allow_sparse - Use a sparse texture if it's supported, and the
+    *                       size of the base level is a multiple of the page
+    *                       size.
+    * @see glTexStorage2D, glTexSubImage2D, glCompressedTexSubImage2D,
+    *      GL_ARB_sparse_texture */
+  StreamingTexture2D(const AssetPack& pack, const AssetPackEntry& entry,
+                     GLsizei initial_size = 64, bool allow_sparse = true);
+
+  /// Waits for the level, that is being copied, and unmaps its buffer.
+  ~StreamingTexture2D();
+
+  StreamingTexture2D(const StreamingTexture2D&) = delete;
+  StreamingTexture2D& operator=(const StreamingTexture2D&) = delete;
+
+  /// Returns the texture.
+  const Texture2D& texture() const { return texture_; }
+
+  /// Returns the number of levels of the texture asset.
+  GLint levelCount() const { return entry_->level_count; }
+
+  /// Returns true if only the resident levels take video memory.
+  bool isSparse() const { return sparse_; }
+
+  /// Returns the finest level, that is uploaded.
+  GLint residentLevel() const { return resident_level_; }
+
+  /// Returns the finest level, that was requested since the last update.
+  GLint requestedLevel() const { return requested_level_; }
+
+  /// Returns the size of a level in bytes.
+  size_t levelSize(GLint level) const { return entry_->levels[level].size; }
+
+  /// Returns true if a level is being copied by a worker thread.
+  bool isStreaming() const { return streamed_level_ >= 0; }
+
+  /// Requests a level to be uploaded.
+  /** Should be called every frame the texture is used, with the finest level
+    * the frame samples (for example computed from the screen space size of
+    * the object, or read back from a feedback buffer). The finest request of
+    * the frame is kept.
+    * @param level - The requested level. */
+  void requestLevel(GLint level);
+
+  /// Forgets the requests, so the next frame can make new ones.
+  void clearRequest() { requested_level_ = levelCount() - 1; }
+
+  /// Starts copying the next finer level, if it's requested.
+  /** Does nothing if a level is already being copied.
+    * @return True if a copy was started.
+    * @see glBufferData, glMapBufferRange */
+  bool streamNextLevel();
+
+  /// Uploads the level, that was being copied, if the copy has finished.
+  /** Never waits for the worker thread.
+    * @return True if a new level became resident.
+    * @see glUnmapBuffer, glTexSubImage2D, glCompressedTexSubImage2D */
+  bool finishStreaming();
+
+  /// Makes the levels finer than a level non-resident.
+  /** They are streamed again when they are requested. A sparse texture
+    * decommits their pages, except for the ones in the mip tail, that is
+    * committed as a whole.
+    * @param level - The new finest resident level.
+    * @see glTexPageCommitmentARB */
+  void evictLevels(GLint level);
+
+ private:
+  const AssetPack* pack_;
+  const AssetPackEntry* entry_;
+  Texture2D texture_;
+  BufferObject<BufferType::kPixelUnpackBuffer> buffer_;
+  GLint resident_level_;
+  GLint requested_level_;
+  GLint streamed_level_ = -1;
+  bool sparse_ = false;
+  GLint sparse_levels_ = 0;  // The levels before the mip tail
+  std::future<void> worker_;
+
+  bool initSparse(PixelDataInternalFormat internal_format);
+  void commitLevel(GLint level, bool commit);
+  void uploadLevel(GLint level, const void* data);
+  void makeResident(GLint level);
+};
+
+/// Decides which streaming textures should upload their next level.
+/** Every frame, the textures, that are furthest from their requested level
+  * start streaming first, within a limit of bytes and concurrent copies. */
+class TextureStreamer {
+ public:
+  /// Creates a streamer.
+  /** @param bytes_per_frame - The maximum number of bytes, whose copy is
+    *                          started in a frame. A larger level is still
+    *                          streamed if it is the first one of a frame.
+    * @param max_streams - The maximum number of levels copied at once. */
+  explicit TextureStreamer(size_t bytes_per_frame = size_t(16) << 20,
+                           size_t max_streams = 4)
+      : bytes_per_frame_(bytes_per_frame), max_streams_(max_streams) {}
+
+  /// Adds a texture to the streamer. It must outlive its membership.
+  void add(StreamingTexture2D& texture);
+
+  /// Removes a texture from the streamer.
+  void remove(StreamingTexture2D& texture);
+
+  /// Uploads the finished levels, and starts streaming new ones.
+  /** Should be called once per frame, after the requests of the frame. The
+    * requests are cleared afterwards. */
+  void update();
+
+  /// Returns the number of textures in the streamer.
+  size_t size() const { return textures_.size(); }
+
+  /// Returns the number of bytes, whose copy can be started in a frame.
+  size_t bytesPerFrame() const { return bytes_per_frame_; }
+
+  /// Sets the number of bytes, whose copy can be started in a frame.
+  void bytesPerFrame(size_t bytes) { bytes_per_frame_ = bytes; }
+
+ private:
+  std::vector<StreamingTexture2D*> textures_;
+  size_t bytes_per_frame_;
+  size_t max_streams_;
+};
+#endif  // glTexStorage2D && glTexSubImage2D && glCompressedTexSubImage2D &&
+        // glMapBufferRange && glUnmapBuffer
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./streaming_texture-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_STREAMING_TEXTURE_H_
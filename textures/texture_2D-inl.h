@@ -4,7 +4,13 @@
 #define OGLWRAP_TEXTURES_TEXTURE_2D_INL_H_
 
 #include "./texture_2D.h"
+#include "./pixel_conversion.h"
 #include "../context/binding.h"
+#include "../context/pixel_ops.h"
+
+#if OGLWRAP_USE_IMAGEMAGICK
+  #include "./block_compression.h"
+#endif
 
 #include "../define_internal_macros.h"
 
@@ -31,33 +37,182 @@ void Texture2DBase<texture_t>::uploadMipmap(
                 width, height, 0, GLenum(format), GLenum(type), data));
 }
 
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::uploadMipmap(
+    GLint level, PixelDataInternalFormat internal_format, GLsizei width,
+    GLsizei height, PixelDataFormat format, PixelDataType type,
+    const void *data, GLint src_x, GLint src_y, GLsizei row_pitch) {
+  ScopedUnpackRegion region(row_pitch, src_x, src_y, format, type);
+  if (!region.valid()) {
+#if OGLWRAP_DEBUG
+    OGLWRAP_PRINT_ERROR("Invalid row pitch",
+      "Texture2DBase::uploadMipmap was called with a row pitch, that can't "
+      "be expressed with the unpack parameters. The upload is skipped.");
+#endif
+    return;
+  }
+  uploadMipmap(level, internal_format, width, height, format, type, data);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glCompressedTexImage2D)
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::uploadCompressedMipmap(
+    GLint level, PixelDataInternalFormat internal_format, GLsizei width,
+    GLsizei height, GLsizei image_size, const void *data) {
+  OGLWRAP_CHECK_BINDING();
+  OGLWRAP_CHECK_BINDLESS_TEXTURE_MODIFIED(this->bindless_handle_);
+  gl(CompressedTexImage2D(GLenum(texture_t), level, GLenum(internal_format),
+                          width, height, 0, image_size, data));
+}
+#endif
+
 template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::subUpload(
     GLint x_offset, GLint y_offset, GLsizei width, GLsizei height,
     PixelDataFormat format, PixelDataType type, const void *data) {
+#if OGLWRAP_USE_DSA
+  gl(TextureSubImage2D(this->texture_, 0, x_offset, y_offset, width, height,
+                       GLenum(format), GLenum(type), data));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexSubImage2D(GLenum(texture_t), 0, x_offset, y_offset,
                    width, height, GLenum(format), GLenum(type), data));
+#endif
 }
 
 template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::subUploadMipmap(
     GLint level, GLint x_offset, GLint y_offset, GLsizei width, GLsizei height,
     PixelDataFormat format, PixelDataType type, const void *data) {
+#if OGLWRAP_USE_DSA
+  gl(TextureSubImage2D(this->texture_, level, x_offset, y_offset, width, height,
+                       GLenum(format), GLenum(type), data));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexSubImage2D(GLenum(texture_t), level, x_offset, y_offset,
                    width, height, GLenum(format), GLenum(type), data));
+#endif
 }
 
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::subUploadMipmap(
+    GLint level, GLint x_offset, GLint y_offset, GLsizei width, GLsizei height,
+    PixelDataFormat format, PixelDataType type, const void *data, GLint src_x,
+    GLint src_y, GLsizei row_pitch) {
+  ScopedUnpackRegion region(row_pitch, src_x, src_y, format, type);
+  if (!region.valid()) {
+#if OGLWRAP_DEBUG
+    OGLWRAP_PRINT_ERROR("Invalid row pitch",
+      "Texture2DBase::subUploadMipmap was called with a row pitch, that can't "
+      "be expressed with the unpack parameters. The upload is skipped.");
+#endif
+    return;
+  }
+  subUploadMipmap(level, x_offset, y_offset, width, height, format, type,
+                  data);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glCompressedTexSubImage2D)
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::subUploadCompressedMipmap(
+    GLint level, GLint x_offset, GLint y_offset, GLsizei width, GLsizei height,
+    PixelDataInternalFormat format, GLsizei image_size, const void *data) {
+#if OGLWRAP_USE_DSA
+  gl(CompressedTextureSubImage2D(this->texture_, level, x_offset, y_offset,
+                                 width, height, GLenum(format), image_size,
+                                 data));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(CompressedTexSubImage2D(GLenum(texture_t), level, x_offset, y_offset,
+                             width, height, GLenum(format), image_size, data));
+#endif
+}
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glTexStorage2D)
 template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::storage(GLsizei levels, GLenum internal_format,
                                        GLsizei width, GLsizei height) {
-  OGLWRAP_CHECK_BINDING();
   OGLWRAP_CHECK_BINDLESS_TEXTURE_MODIFIED(this->bindless_handle_);
+#if OGLWRAP_USE_DSA
+  gl(TextureStorage2D(this->texture_, levels, GLenum(internal_format), width,
+                      height));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(TexStorage2D(GLenum(texture_t), levels, GLenum(internal_format),
                   width, height));
+#endif
 }
+
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::storage(GLsizei levels,
+                                       PixelDataInternalFormat internal_format,
+                                       GLsizei width, GLsizei height) {
+  storage(levels, GLenum(internal_format), width, height);
+}
+
+template<Texture2DType texture_t>
+GLsizei Texture2DBase<texture_t>::MipmapLevelCount(GLsizei width,
+                                                   GLsizei height) {
+  switch (texture_t) {
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_RECTANGLE)
+    case Texture2DType::kTextureRectangle:
+      return 1;
+#endif
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_1D_ARRAY)
+    case Texture2DType::kTexture1DArray:
+      return GetMipmapLevelCount(width);
+#endif
+    default:
+      return GetMipmapLevelCount(width, height);
+  }
+}
+
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::storage(PixelDataInternalFormat internal_format,
+                                       GLsizei width, GLsizei height) {
+  storage(MipmapLevelCount(width, height), GLenum(internal_format),
+          width, height);
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage2D) \
+    && defined(glGenerateMipmap))
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::uploadImmutable(
+    PixelDataInternalFormat internal_format, GLsizei width, GLsizei height,
+    PixelDataFormat format, PixelDataType type, const void *data,
+    bool generate_mipmaps) {
+  GLsizei levels = generate_mipmaps ? MipmapLevelCount(width, height) : 1;
+  storage(levels, GLenum(internal_format), width, height);
+  subUpload(0, 0, width, height, format, type, data);
+  if (levels > 1) {
+    this->generateMipmap();
+  }
+  this->maxLevel(levels - 1);
+}
+#endif  // glTexSubImage2D && glGenerateMipmap
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexSubImage2D)
+template<Texture2DType texture_t>
+void Texture2DBase<texture_t>::uploadImmutable(
+    PixelDataInternalFormat internal_format, GLsizei width, GLsizei height,
+    PixelDataFormat format, PixelDataType type,
+    const std::vector<const void*>& levels) {
+  storage(levels.size(), GLenum(internal_format), width, height);
+  for (size_t level = 0; level < levels.size(); ++level) {
+    GLsizei level_width = std::max<GLsizei>(width >> level, 1);
+    GLsizei level_height = std::max<GLsizei>(height >> level, 1);
+#if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_1D_ARRAY)
+    if (texture_t == Texture2DType::kTexture1DArray) {
+      level_height = height;  // The layer count doesn't shrink.
+    }
+#endif
+    subUploadMipmap(level, 0, 0, level_width, level_height, format, type,
+                    levels[level]);
+  }
+  this->maxLevel(levels.size() - 1);
+}
+#endif  // glTexSubImage2D
 #endif  // glTexStorage2D
 
 template<Texture2DType texture_t>
@@ -82,33 +237,53 @@ template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::copySub(
     GLint x_offset, GLint y_offset, GLint x,
     GLint y, GLsizei width, GLsizei height) {
+#if OGLWRAP_USE_DSA
+  gl(CopyTextureSubImage2D(this->texture_, 0, x_offset, y_offset, x, y, width,
+                           height));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(CopyTexSubImage2D(GLenum(texture_t), 0, x_offset, y_offset,
                        x, y, width, height));
+#endif
 }
 
 template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::copySubMipmap(
     GLint level, GLint x_offset, GLint y_offset,
     GLint x, GLint y, GLsizei width, GLsizei height) {
+#if OGLWRAP_USE_DSA
+  gl(CopyTextureSubImage2D(this->texture_, level, x_offset, y_offset, x, y,
+                           width, height));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(CopyTexSubImage2D(GLenum(texture_t), level, x_offset, y_offset,
                        x, y, width, height));
+#endif
 }
 
 template<Texture2DType texture_t>
 GLsizei Texture2DBase<texture_t>::width(GLint level) const {
-  OGLWRAP_CHECK_BINDING();
   GLsizei data;
+#if OGLWRAP_USE_DSA
+  gl(GetTextureLevelParameteriv(this->texture_, level, GL_TEXTURE_WIDTH,
+                                &data));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(GetTexLevelParameteriv(GLenum(texture_t), level, GL_TEXTURE_WIDTH, &data));
+#endif
   return data;
 }
 
 template<Texture2DType texture_t>
 GLsizei Texture2DBase<texture_t>::height(GLint level) const {
-  OGLWRAP_CHECK_BINDING();
   GLsizei data;
+#if OGLWRAP_USE_DSA
+  gl(GetTextureLevelParameteriv(this->texture_, level, GL_TEXTURE_HEIGHT,
+                                &data));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(GetTexLevelParameteriv(GLenum(texture_t), level, GL_TEXTURE_HEIGHT, &data));
+#endif
   return data;
 }
 
@@ -124,7 +299,8 @@ void Texture2DBase<texture_t>::getCompressedImage(GLint level,
 #if OGLWRAP_USE_IMAGEMAGICK
 template<Texture2DType texture_t>
 void Texture2DBase<texture_t>::loadTexture(const std::string& file,
-                                          std::string format_string) {
+                                          std::string format_string,
+                                          bool cache_compressed) {
   try {
     bool srgb{false}, compressed{false}, alpha{false};
     size_t s_pos = format_string.find('S');
@@ -139,6 +315,51 @@ void Texture2DBase<texture_t>::loadTexture(const std::string& file,
     }
     alpha = format_string.find('A') != std::string::npos;
 
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glCompressedTexImage2D) \
+    && defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) \
+    && defined(GL_COMPRESSED_RGBA_BPTC_UNORM) \
+    && defined(GL_COMPRESSED_RG_RGTC2))
+    if (compressed) {
+      // Compressing on the CPU is faster and more consistent than letting the
+      // driver do it, and the result can be cached for the next load.
+      auto decode = [&](std::vector<GLubyte>* rgba, GLsizei* width,
+                        GLsizei* height) {
+        Magick::Image image = Magick::Image(file);
+        Magick::Blob blob;
+        image.write(&blob, format_string);
+        size_t count = image.columns() * image.rows();
+        const GLubyte* data = static_cast<const GLubyte*>(blob.data());
+        if (format_string.length() == 4) {
+          rgba->assign(data, data + count * 4);
+        } else if (format_string.length() == 3) {
+          rgba->resize(count * 4);
+          ConvertRgbToRgba(data, rgba->data(), count);
+        } else {
+          return false;
+        }
+        *width = image.columns();
+        *height = image.rows();
+        return true;
+      };
+      BlockFormat block_format = alpha ? BlockFormat::kBc3 : BlockFormat::kBc1;
+      CompressedImage image;
+      if (cache_compressed) {
+        image = LoadCompressedImage(file, block_format, decode, srgb, false);
+      } else {
+        std::vector<GLubyte> rgba;
+        GLsizei width = 0, height = 0;
+        if (decode(&rgba, &width, &height) && width > 0 && height > 0) {
+          image = CompressedImage(block_format, rgba.data(), width, height,
+                                  srgb, false);
+        }
+      }
+      if (image.levelCount() > 0) {
+        image.upload(*this);
+        return;
+      }
+    }
+#endif
+
     Magick::Image image = Magick::Image(file);
     Magick::Blob blob;
     image.write(&blob, format_string);
@@ -154,21 +375,26 @@ void Texture2DBase<texture_t>::loadTexture(const std::string& file,
                          : (alpha ? InternalFormat::kRgba8
                                   : InternalFormat::kRgb8));
 
-    bool bad_alignment = (image.columns() * format_string.length()) % 4 != 0;
-    GLint unpack_aligment;
-
-    if (bad_alignment) {
-      gl(GetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_aligment));
-      gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    // Drivers convert three component uploads on a slow path, so they are
+    // expanded to RGBA on the CPU, which also makes every row 4 byte aligned.
+    const void* data = blob.data();
+    size_t components = format_string.length();
+    std::vector<GLubyte> expanded;
+    if (components == 3) {
+      size_t count = image.columns() * image.rows();
+      expanded.resize(count * 4);
+      ConvertRgbToRgba(static_cast<const GLubyte*>(blob.data()),
+                       expanded.data(), count);
+      data = expanded.data();
+      components = 4;
     }
 
-    upload(internal_format, image.columns(), image.rows(),
-           alpha ? PixelDataFormat::kRgba : PixelDataFormat::kRgb,
-           PixelDataType::kUnsignedByte, blob.data());
-
-    if (bad_alignment) {
-      gl(PixelStorei(GL_UNPACK_ALIGNMENT, unpack_aligment));
-    }
+    PixelDataFormat format =
+        components == 4 ? PixelDataFormat::kRgba : PixelDataFormat::kRgb;
+    ScopedUnpackRegion region(image.columns() * components, 0, 0, format,
+                              PixelDataType::kUnsignedByte);
+    upload(internal_format, image.columns(), image.rows(), format,
+           PixelDataType::kUnsignedByte, data);
   } catch (const Magick::Error& error) {
     std::cerr << "Error loading texture: " << error.what() << std::endl;
   }
@@ -7,6 +7,8 @@
 #ifndef OGLWRAP_TEXTURES_TEXTURE_2D_H_
 #define OGLWRAP_TEXTURES_TEXTURE_2D_H_
 
+#include <vector>
+
 #include "./texture_base.h"
 #include "../enums/texture2D_type.h"
 
@@ -46,6 +48,40 @@ class Texture2DBase : public TextureBase<TextureType(texture_t)> {
                     GLsizei width, GLsizei height, PixelDataFormat format,
                     PixelDataType type, const void *data);
 
+  /// Uploads a mipmap from a sub-rectangle of a larger client side image.
+  /** Sets the unpack row length, skip and alignment parameters for the
+    * upload, and restores them afterwards.
+    * @param level - Specifies the level-of-detail number. Level 0 is the base image level. Level n is the nth mipmap reduction image.
+    * @param internal_format - Specifies the number, order, and size of the color components in the texture.
+    * @param width, height - Specifies the size of the texture image (and of the sub-rectangle).
+    * @param format - Specifies the format of the pixel data.
+    * @param type - Specifies the data type of the pixel data.
+    * @param data - Specifies a pointer to the first pixel of the whole client side image.
+    * @param src_x, src_y - The position of the sub-rectangle in the client side image.
+    * @param row_pitch - The distance of the rows of the client side image in
+    *                    bytes. If GetRowLengthAndAlignment can't express
+    *                    it, nothing is uploaded.
+    * @see glTexImage2D, glPixelStore */
+  void uploadMipmap(GLint level, PixelDataInternalFormat internal_format,
+                    GLsizei width, GLsizei height, PixelDataFormat format,
+                    PixelDataType type, const void *data, GLint src_x,
+                    GLint src_y, GLsizei row_pitch);
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glCompressedTexImage2D)
+  /// Uploads a mipmap of the image, that is already compressed.
+  /** @param level - Specifies the level-of-detail number. Level 0 is the base image level. Level n is the nth mipmap reduction image.
+    * @param internal_format - Specifies the compressed format of the image.
+    * @param width - Specifies the width of the texture image.
+    * @param height - Specifies the height of the texture image.
+    * @param image_size - Specifies the number of unsigned bytes of image data.
+    * @param data - Specifies a pointer to the compressed image data in memory.
+    * @see glCompressedTexImage2D */
+  void uploadCompressedMipmap(GLint level,
+                              PixelDataInternalFormat internal_format,
+                              GLsizei width, GLsizei height,
+                              GLsizei image_size, const void *data);
+#endif
+
   /// Updates a part of the base image.
   /** @param x_offset, y_offset - Specifies a texel offset in the x/y direction within the texture array.
     * @param width, height - Specifies the width/height of the texture subimage.
@@ -69,6 +105,41 @@ class Texture2DBase : public TextureBase<TextureType(texture_t)> {
                        GLsizei height, PixelDataFormat format,
                        PixelDataType type, const void *data);
 
+  /// Updates a part of a mipmap image from a sub-rectangle of a larger client side image.
+  /** Sets the unpack row length, skip and alignment parameters for the
+    * upload, and restores them afterwards. Useful for updating dirty regions
+    * of a texture from a CPU side copy, without repacking the pixels.
+    * @param level - Specifies the level-of-detail number. Level 0 is the base image level. Level n is the nth mipmap reduction image.
+    * @param x_offset, y_offset - Specifies a texel offset in the x/y direction within the texture array.
+    * @param width, height - Specifies the width/height of the texture subimage.
+    * @param format - Specifies the format of the pixel data.
+    * @param type - Specifies the data type of the pixel data.
+    * @param data - Specifies a pointer to the first pixel of the whole client side image.
+    * @param src_x, src_y - The position of the sub-rectangle in the client side image.
+    * @param row_pitch - The distance of the rows of the client side image in
+    *                    bytes. If GetRowLengthAndAlignment can't express
+    *                    it, nothing is uploaded.
+    * @see glTexSubImage2D, glPixelStore */
+  void subUploadMipmap(GLint level, GLint x_offset, GLint y_offset, GLsizei width,
+                       GLsizei height, PixelDataFormat format,
+                       PixelDataType type, const void *data, GLint src_x,
+                       GLint src_y, GLsizei row_pitch);
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glCompressedTexSubImage2D)
+  /// Updates a part of a mipmap image with already compressed data.
+  /** @param level - Specifies the level-of-detail number. Level 0 is the base image level. Level n is the nth mipmap reduction image.
+    * @param x_offset, y_offset - Specifies a texel offset in the x/y direction within the texture array.
+    * @param width, height - Specifies the width/height of the texture subimage.
+    * @param format - Specifies the compressed format of the image.
+    * @param image_size - Specifies the number of unsigned bytes of image data.
+    * @param data - Specifies a pointer to the compressed image data in memory.
+    * @see glCompressedTexSubImage2D */
+  void subUploadCompressedMipmap(GLint level, GLint x_offset, GLint y_offset,
+                                 GLsizei width, GLsizei height,
+                                 PixelDataInternalFormat format,
+                                 GLsizei image_size, const void *data);
+#endif
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glTexStorage2D)
   /// Simultaneously specify storage for all levels of a two-dimensional or one-dimensional array texture
   /** @param levels - Specify the number of texture levels.
@@ -77,6 +148,68 @@ class Texture2DBase : public TextureBase<TextureType(texture_t)> {
     * @param height - Specifies the height of the texture, in texels. */
   void storage(GLsizei levels, GLenum internal_format, GLsizei width,
                GLsizei height);
+
+  /// Simultaneously specify immutable storage for all levels of the texture.
+  /** @param levels - Specify the number of texture levels.
+    * @param internal_format - Specifies the sized internal format to be used to store texture image data.
+    * @param width - Specifies the width of the texture, in texels.
+    * @param height - Specifies the height of the texture, in texels.
+    * @see glTexStorage2D */
+  void storage(GLsizei levels, PixelDataInternalFormat internal_format,
+               GLsizei width, GLsizei height);
+
+  /// Specifies immutable storage for a complete mipmap chain.
+  /** The number of levels is computed from the size (rectangle textures only
+    * have one level, and the height of 1D arrays is their layer count).
+    * @param internal_format - Specifies the sized internal format to be used to store texture image data.
+    * @param width - Specifies the width of the texture, in texels.
+    * @param height - Specifies the height of the texture, in texels.
+    * @see glTexStorage2D */
+  void storage(PixelDataInternalFormat internal_format, GLsizei width,
+               GLsizei height);
+
+  /// Returns the number of levels in a complete mipmap chain of this class.
+  /** @param width, height - The size of the base level. */
+  static GLsizei MipmapLevelCount(GLsizei width, GLsizei height);
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage2D) \
+    && defined(glGenerateMipmap))
+  /// Creates an immutable texture from the base image.
+  /** Allocates immutable storage, uploads the base level, generates the rest
+    * of the mipmaps if it is requested, and sets the maximum level, so the
+    * texture is complete. The driver doesn't have to check the completeness
+    * of immutable textures when they are used.
+    * @param internal_format - Specifies the sized internal format to be used to store texture image data.
+    * @param width, height - Specifies the size of the base image.
+    * @param format - Specifies the format of the pixel data.
+    * @param type - Specifies the data type of the pixel data.
+    * @param data - Specifies a pointer to the image data in memory.
+    * @param generate_mipmaps - Allocate and generate the full mipmap chain, or
+    *                           only allocate the base level.
+    * @see glTexStorage2D, glTexSubImage2D, glGenerateMipmap */
+  void uploadImmutable(PixelDataInternalFormat internal_format,
+                       GLsizei width, GLsizei height, PixelDataFormat format,
+                       PixelDataType type, const void *data,
+                       bool generate_mipmaps = true);
+#endif  // glTexSubImage2D && glGenerateMipmap
+
+#if OGLWRAP_DEFINE_EVERYTHING || defined(glTexSubImage2D)
+  /// Creates an immutable texture from every level of the image.
+  /** Allocates immutable storage for as many levels as given, uploads them,
+    * and sets the maximum level, so the texture is complete.
+    * @param internal_format - Specifies the sized internal format to be used to store texture image data.
+    * @param width, height - Specifies the size of the base image.
+    * @param format - Specifies the format of the pixel data.
+    * @param type - Specifies the data type of the pixel data.
+    * @param levels - The image data of the levels, starting with the base
+    *                 level. Each level is half as large as the previous one
+    *                 (but at least 1 texel).
+    * @see glTexStorage2D, glTexSubImage2D */
+  void uploadImmutable(PixelDataInternalFormat internal_format,
+                       GLsizei width, GLsizei height, PixelDataFormat format,
+                       PixelDataType type,
+                       const std::vector<const void*>& levels);
+#endif  // glTexSubImage2D
 #endif  // glTexStorage2D
 
   /// Copies pixels from the current GL_READ_BUFFER into the base mipmap of this texture.
@@ -133,10 +266,17 @@ class Texture2DBase : public TextureBase<TextureType(texture_t)> {
 
 #if OGLWRAP_USE_IMAGEMAGICK
   /// Loads in, and uploads an image from a file using Magick++.
-  /** @param file - Path to the image file.
+  /** If the format string contains 'C', the image is compressed to BC1 (or BC3
+    * if it has alpha) on the CPU.
+    * @param file - Path to the image file.
     * @param format_string - Specifies the number and order of components to be read.
-    * @see glTexImage2D */
-  void loadTexture(const std::string& file, std::string format_string = "CSRGBA");
+    * @param cache_compressed - Cache the compressed image in a file next to
+    *                           the image (like "grass.png.bc3"), so later
+    *                           loads skip the compression. The directory of
+    *                           the image has to be writable.
+    * @see glTexImage2D, glCompressedTexImage2D, LoadCompressedImage */
+  void loadTexture(const std::string& file, std::string format_string = "CSRGBA",
+                   bool cache_compressed = false);
 #endif
 };
 
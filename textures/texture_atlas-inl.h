@@ -0,0 +1,301 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_TEXTURE_ATLAS_INL_H_
+#define OGLWRAP_TEXTURES_TEXTURE_ATLAS_INL_H_
+
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include "./texture_atlas.h"
+#include "../context/binding.h"
+#include "../context/pixel_ops.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline SkylinePacker::SkylinePacker(GLsizei width, GLsizei height)
+    : width_(width), height_(height) {
+  clear();
+}
+
+inline void SkylinePacker::clear() {
+  skyline_.clear();
+  skyline_.push_back(Node{0, 0, width_});
+  used_area_ = 0;
+}
+
+inline GLint SkylinePacker::fit(size_t node, GLsizei width,
+                                GLsizei height) const {
+  GLint x = skyline_[node].x;
+  if (x + width > width_) {
+    return -1;
+  }
+
+  // The rectangle has to sit on the highest node it spans.
+  GLint y = 0;
+  GLsizei width_left = width;
+  for (size_t i = node; width_left > 0; ++i) {
+    y = std::max(y, skyline_[i].y);
+    width_left -= skyline_[i].width;
+  }
+  return y + height > height_ ? -1 : y;
+}
+
+inline bool SkylinePacker::insert(GLsizei width, GLsizei height,
+                                  GLint* x, GLint* y) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+
+  size_t best_node = skyline_.size();
+  GLint best_y = 0;
+  GLint best_top = std::numeric_limits<GLint>::max();
+  GLsizei best_width = std::numeric_limits<GLsizei>::max();
+  for (size_t i = 0; i < skyline_.size(); ++i) {
+    GLint node_y = fit(i, width, height);
+    if (node_y < 0) {
+      continue;
+    }
+    GLint top = node_y + height;
+    if (top < best_top || (top == best_top && skyline_[i].width < best_width)) {
+      best_node = i;
+      best_y = node_y;
+      best_top = top;
+      best_width = skyline_[i].width;
+    }
+  }
+  if (best_node == skyline_.size()) {
+    return false;
+  }
+
+  Node node{skyline_[best_node].x, best_top, width};
+  skyline_.insert(skyline_.begin() + best_node, node);
+
+  // Shrink or remove the nodes, that are covered by the new one.
+  for (size_t i = best_node + 1; i < skyline_.size();) {
+    const Node& prev = skyline_[i - 1];
+    GLint overlap = prev.x + prev.width - skyline_[i].x;
+    if (overlap <= 0) {
+      break;
+    }
+    skyline_[i].x += overlap;
+    skyline_[i].width -= overlap;
+    if (skyline_[i].width <= 0) {
+      skyline_.erase(skyline_.begin() + i);
+    } else {
+      break;
+    }
+  }
+
+  // Merge the neighbouring nodes of the same height.
+  for (size_t i = 0; i + 1 < skyline_.size();) {
+    if (skyline_[i].y == skyline_[i + 1].y) {
+      skyline_[i].width += skyline_[i + 1].width;
+      skyline_.erase(skyline_.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+
+  used_area_ += size_t(width) * size_t(height);
+  *x = node.x;
+  *y = best_y;
+  return true;
+}
+
+/// Copies an image into the middle of a larger one, repeating its edges.
+inline std::vector<unsigned char> OGLWRAP_PadImage(const void* data,
+                                                   GLsizei width,
+                                                   GLsizei height,
+                                                   GLsizei padding,
+                                                   GLsizei pixel_size) {
+  GLsizei padded_width = width + 2*padding;
+  GLsizei padded_height = height + 2*padding;
+  std::vector<unsigned char> padded(
+      size_t(padded_width) * padded_height * pixel_size);
+  const unsigned char* src = static_cast<const unsigned char*>(data);
+
+  for (GLsizei y = 0; y < padded_height; ++y) {
+    GLsizei src_y = std::min(std::max(y - padding, 0), height - 1);
+    const unsigned char* src_row = src + size_t(src_y) * width * pixel_size;
+    unsigned char* dst_row = padded.data() + size_t(y) * padded_width * pixel_size;
+    for (GLsizei x = 0; x < padding; ++x) {
+      std::memcpy(dst_row + x * pixel_size, src_row, pixel_size);
+      std::memcpy(dst_row + (padding + width + x) * pixel_size,
+                  src_row + (width - 1) * pixel_size, pixel_size);
+    }
+    std::memcpy(dst_row + padding * pixel_size, src_row,
+                size_t(width) * pixel_size);
+  }
+  return padded;
+}
+
+/// Returns a zero filled image, that is large enough for any pixel type.
+/** No pixel is larger than 16 bytes (four 32 bit components), and zero bytes
+  * are zero in every format, so it clears an area, even if the size of the
+  * pixels isn't known. */
+inline std::vector<unsigned char> OGLWRAP_ZeroImage(GLsizei width,
+                                                    GLsizei height) {
+  return std::vector<unsigned char>(size_t(width) * height * 16, 0);
+}
+
+/// Computes the region of an image, that was placed at (x, y) with padding.
+inline AtlasRegion OGLWRAP_MakeAtlasRegion(GLsizei layer, GLint x, GLint y,
+                                           GLsizei width, GLsizei height,
+                                           GLsizei padding,
+                                           GLsizei page_width,
+                                           GLsizei page_height) {
+  AtlasRegion region;
+  region.layer = layer;
+  region.x = x + padding;
+  region.y = y + padding;
+  region.width = width;
+  region.height = height;
+  region.uv = glm::vec4(float(region.x) / page_width,
+                        float(region.y) / page_height,
+                        float(region.x + width) / page_width,
+                        float(region.y + height) / page_height);
+  return region;
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage3D) \
+    && defined(glTexStorage3D) && defined(GL_TEXTURE_2D_ARRAY))
+
+inline TextureArrayAtlas::TextureArrayAtlas(
+    PixelDataInternalFormat internal_format, GLsizei width, GLsizei height,
+    GLsizei layers, GLsizei padding, GLsizei levels)
+    : layers_(layers, SkylinePacker(width, height)), padding_(padding) {
+  Bind(texture_);
+  texture_.storage(levels, internal_format, width, height, layers);
+}
+
+inline bool TextureArrayAtlas::insert(GLsizei width, GLsizei height,
+                                      PixelDataFormat format,
+                                      PixelDataType type, const void* data,
+                                      AtlasRegion* region) {
+  GLsizei padded_width = width + 2*padding_;
+  GLsizei padded_height = height + 2*padding_;
+  for (size_t layer = 0; layer < layers_.size(); ++layer) {
+    SkylinePacker& packer = layers_[layer];
+    GLint x, y;
+    if (!packer.insert(padded_width, padded_height, &x, &y)) {
+      continue;
+    }
+
+    *region = OGLWRAP_MakeAtlasRegion(layer, x, y, width, height, padding_,
+                                      packer.width(), packer.height());
+    Bind(texture_);
+    // Every upload reads a tightly packed image, the unpack parameters are
+    // restored after them. Unknown pixel types fall back to an alignment of 1.
+    GLsizei pixel_size = GetPixelSize(format, type);
+    if (pixel_size != 0 && padding_ > 0) {
+      std::vector<unsigned char> padded =
+          OGLWRAP_PadImage(data, width, height, padding_, pixel_size);
+      ScopedUnpackRegion tight(padded_width * pixel_size, 0, 0, format, type);
+      texture_.subUpload(x, y, layer, padded_width, padded_height, 1,
+                         format, type, padded.data());
+    } else {
+      if (padding_ > 0) {
+        // The edges of unknown pixel types can't be repeated, so the padding
+        // is cleared to zero instead.
+        std::vector<unsigned char> zeros =
+            OGLWRAP_ZeroImage(padded_width, padded_height);
+        ScopedUnpackRegion tight(padded_width * pixel_size, 0, 0, format,
+                                 type);
+        texture_.subUpload(x, y, layer, padded_width, padded_height, 1,
+                           format, type, zeros.data());
+      }
+      ScopedUnpackRegion tight(width * pixel_size, 0, 0, format, type);
+      texture_.subUpload(region->x, region->y, layer, width, height, 1,
+                         format, type, data);
+    }
+    return true;
+  }
+  return false;
+}
+
+inline void TextureArrayAtlas::generateMipmap() {
+  Bind(texture_);
+  texture_.generateMipmap();
+}
+
+inline GLsizei TextureArrayAtlas::usedLayers() const {
+  return std::count_if(layers_.begin(), layers_.end(),
+                       [](const SkylinePacker& packer) {
+                         return packer.occupancy() > 0.0f;
+                       });
+}
+
+#endif  // glTexSubImage3D && glTexStorage3D && GL_TEXTURE_2D_ARRAY
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage2D) \
+    && defined(glTexStorage2D))
+
+inline bool TextureAtlas::insert(GLsizei width, GLsizei height,
+                                 PixelDataFormat format, PixelDataType type,
+                                 const void* data, AtlasRegion* region) {
+  GLsizei padded_width = width + 2*padding_;
+  GLsizei padded_height = height + 2*padding_;
+  if (padded_width > width_ || padded_height > height_) {
+    return false;
+  }
+
+  size_t page = 0;
+  GLint x, y;
+  while (page < packers_.size() &&
+         !packers_[page].insert(padded_width, padded_height, &x, &y)) {
+    ++page;
+  }
+  if (page == packers_.size()) {
+    pages_.emplace_back();
+    Bind(pages_.back());
+    pages_.back().storage(levels_, GLenum(internal_format_), width_, height_);
+    packers_.emplace_back(width_, height_);
+    packers_.back().insert(padded_width, padded_height, &x, &y);
+  }
+
+  *region = OGLWRAP_MakeAtlasRegion(page, x, y, width, height, padding_,
+                                    width_, height_);
+  Texture2D& texture = pages_[page];
+  Bind(texture);
+  // Every upload reads a tightly packed image, the unpack parameters are
+  // restored after them. Unknown pixel types fall back to an alignment of 1.
+  GLsizei pixel_size = GetPixelSize(format, type);
+  if (pixel_size != 0 && padding_ > 0) {
+    std::vector<unsigned char> padded =
+        OGLWRAP_PadImage(data, width, height, padding_, pixel_size);
+    ScopedUnpackRegion tight(padded_width * pixel_size, 0, 0, format, type);
+    texture.subUpload(x, y, padded_width, padded_height, format, type,
+                      padded.data());
+  } else {
+    if (padding_ > 0) {
+      // The edges of unknown pixel types can't be repeated, so the padding
+      // is cleared to zero instead.
+      std::vector<unsigned char> zeros =
+          OGLWRAP_ZeroImage(padded_width, padded_height);
+      ScopedUnpackRegion tight(padded_width * pixel_size, 0, 0, format, type);
+      texture.subUpload(x, y, padded_width, padded_height, format, type,
+                        zeros.data());
+    }
+    ScopedUnpackRegion tight(width * pixel_size, 0, 0, format, type);
+    texture.subUpload(region->x, region->y, width, height, format, type, data);
+  }
+  return true;
+}
+
+inline void TextureAtlas::generateMipmap() {
+  for (Texture2D& page : pages_) {
+    Bind(page);
+    page.generateMipmap();
+  }
+}
+
+#endif  // glTexSubImage2D && glTexStorage2D
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_TEXTURE_ATLAS_INL_H_
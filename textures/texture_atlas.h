@@ -0,0 +1,191 @@
+// Copyright (c) Tamas Csala
+
+/** @file texture_atlas.h
+    @brief Implements packing many small images into a few textures.
+*/
+
+#ifndef OGLWRAP_TEXTURES_TEXTURE_ATLAS_H_
+#define OGLWRAP_TEXTURES_TEXTURE_ATLAS_H_
+
+#include <vector>
+
+#include "../config.h"
+#include "./pixel_size.h"
+#include "./texture_2D.h"
+#include "./texture_3D.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// Allocates rectangles in a fixed size area with the skyline algorithm.
+/** The skyline is the upper edge of the allocated area, and every rectangle is
+  * placed on it at the position, where its top edge is the lowest. It's fast
+  * and wastes little space if the rectangles are inserted in the order of
+  * decreasing height. */
+class SkylinePacker {
+ public:
+  /// Creates an empty area.
+  /** @param width - The width of the area.
+    * @param height - The height of the area. */
+  SkylinePacker(GLsizei width, GLsizei height);
+
+  /// Allocates a rectangle.
+  /** @param width - The width of the rectangle.
+    * @param height - The height of the rectangle.
+    * @param x - Receives the x coordinate of the allocated rectangle.
+    * @param y - Receives the y coordinate of the allocated rectangle.
+    * @return False if the rectangle doesn't fit. */
+  bool insert(GLsizei width, GLsizei height, GLint* x, GLint* y);
+
+  /// Frees every rectangle.
+  void clear();
+
+  /// Returns the ratio of the allocated and the whole area.
+  float occupancy() const {
+    return float(used_area_) / (float(width_) * float(height_));
+  }
+
+  GLsizei width() const { return width_; }
+  GLsizei height() const { return height_; }
+
+ private:
+  struct Node {
+    GLint x, y;
+    GLsizei width;
+  };
+
+  GLsizei width_, height_;
+  size_t used_area_ = 0;
+  std::vector<Node> skyline_;
+
+  /// Returns the y coordinate a rectangle would get at a node, or -1.
+  GLint fit(size_t node, GLsizei width, GLsizei height) const;
+};
+
+/// The location of an image inside an atlas.
+struct AtlasRegion {
+  /// The layer of the array texture, or the index of the page of the atlas.
+  GLsizei layer;
+  /// The texture coordinates of the image: (u_min, v_min, u_max, v_max).
+  glm::vec4 uv;
+  /// The texel coordinates of the image, without the padding.
+  GLint x, y;
+  GLsizei width, height;
+};
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage3D) \
+    && defined(glTexStorage3D) && defined(GL_TEXTURE_2D_ARRAY))
+/// Packs images into the layers of a two-dimensional array texture.
+/** Every image is surrounded by a padding, that repeats its edge texels (or
+  * is zero, if GetPixelSize doesn't know the pixel type), so filtering (and
+  * mipmaps up to log2(padding) levels) don't bleed the neighbouring images
+  * into it. The texture is bound by the functions, that modify it. */
+class TextureArrayAtlas {
+ public:
+  /// Allocates the storage of the array texture.
+  /** @param internal_format - The sized internal format of the texture.
+    * @param width - The width of the layers.
+    * @param height - The height of the layers.
+    * @param layers - The number of layers.
+    * @param padding - The number of texels around every image.
+    * @param levels - The number of mipmap levels.
+    * @see glTexStorage3D */
+  TextureArrayAtlas(PixelDataInternalFormat internal_format, GLsizei width,
+                    GLsizei height, GLsizei layers, GLsizei padding = 2,
+                    GLsizei levels = 1);
+
+  /// Adds an image to the atlas.
+  /** The rows of the image must be tightly packed. The unpack parameters are
+    * restored after the upload. The mipmaps of the layer aren't updated, call
+    * generateMipmap() after the images are added.
+    * @param width - The width of the image.
+    * @param height - The height of the image.
+    * @param format - The format of the pixel data.
+    * @param type - The data type of the pixel data.
+    * @param data - The pixels of the image.
+    * @param region - Receives the location of the image.
+    * @return False if the atlas is full.
+    * @see glTexSubImage3D */
+  bool insert(GLsizei width, GLsizei height, PixelDataFormat format,
+              PixelDataType type, const void* data, AtlasRegion* region);
+
+  /// Regenerates the mipmaps of every layer.
+  /** @see glGenerateMipmap */
+  void generateMipmap();
+
+  /// Returns the array texture.
+  const Texture2DArray& texture() const { return texture_; }
+
+  /// Returns the number of layers, that have at least one image.
+  GLsizei usedLayers() const;
+
+ private:
+  Texture2DArray texture_;
+  std::vector<SkylinePacker> layers_;
+  GLsizei padding_;
+};
+#endif  // glTexSubImage3D && glTexStorage3D && GL_TEXTURE_2D_ARRAY
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexSubImage2D) \
+    && defined(glTexStorage2D))
+/// Packs images into two-dimensional textures, creating new pages on demand.
+/** Every image is surrounded by a padding, that repeats its edge texels (or
+  * is zero, if GetPixelSize doesn't know the pixel type), so filtering (and
+  * mipmaps up to log2(padding) levels) don't bleed the neighbouring images
+  * into it. The textures are bound by the functions, that modify them. */
+class TextureAtlas {
+ public:
+  /// Creates an atlas without any pages.
+  /** @param internal_format - The sized internal format of the pages.
+    * @param width - The width of the pages.
+    * @param height - The height of the pages.
+    * @param padding - The number of texels around every image.
+    * @param levels - The number of mipmap levels of the pages. */
+  TextureAtlas(PixelDataInternalFormat internal_format, GLsizei width,
+               GLsizei height, GLsizei padding = 2, GLsizei levels = 1)
+      : internal_format_(internal_format), width_(width), height_(height)
+      , padding_(padding), levels_(levels) {}
+
+  /// Adds an image to the atlas, creating a new page if it's needed.
+  /** The rows of the image must be tightly packed. The unpack parameters are
+    * restored after the upload. The mipmaps of the page aren't updated, call
+    * generateMipmap() after the images are added.
+    * @param width - The width of the image.
+    * @param height - The height of the image.
+    * @param format - The format of the pixel data.
+    * @param type - The data type of the pixel data.
+    * @param data - The pixels of the image.
+    * @param region - Receives the location of the image.
+    * @return False if the image is larger than a page.
+    * @see glTexStorage2D, glTexSubImage2D */
+  bool insert(GLsizei width, GLsizei height, PixelDataFormat format,
+              PixelDataType type, const void* data, AtlasRegion* region);
+
+  /// Regenerates the mipmaps of every page.
+  /** @see glGenerateMipmap */
+  void generateMipmap();
+
+  /// Returns a page of the atlas.
+  const Texture2D& page(GLsizei index) const { return pages_[index]; }
+
+  /// Returns the number of pages.
+  GLsizei pageCount() const { return pages_.size(); }
+
+ private:
+  PixelDataInternalFormat internal_format_;
+  GLsizei width_, height_, padding_, levels_;
+  std::vector<Texture2D> pages_;
+  std::vector<SkylinePacker> packers_;
+};
+#endif  // glTexSubImage2D && glTexStorage2D
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./texture_atlas-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_TEXTURE_ATLAS_H_
@@ -15,104 +15,156 @@ namespace OGLWRAP_NAMESPACE_NAME {
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glGenerateMipmap)
 template <TextureType texture_t>
 void TextureBase<texture_t>::generateMipmap() {
+#if OGLWRAP_USE_DSA
+  gl(GenerateTextureMipmap(texture_));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(GenerateMipmap(GLenum(texture_t)));
+#endif
 }
 #endif
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::borderColor(glm::vec4 color) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameterfv(texture_, GL_TEXTURE_BORDER_COLOR,
+                        glm::value_ptr(color)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameterfv(GLenum(texture_t), GL_TEXTURE_BORDER_COLOR,
                     glm::value_ptr(color)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::minFilter(enums::MinFilter filtermode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_MIN_FILTER, GLenum(filtermode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_MIN_FILTER,
                    GLenum(filtermode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::magFilter(enums::MagFilter filtermode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_MAG_FILTER, GLenum(filtermode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_MAG_FILTER,
                    GLenum(filtermode)));
+#endif
 }
 
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::wrapS(WrapMode wrap_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_WRAP_S, GLenum(wrap_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_WRAP_S, GLenum(wrap_mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::wrapT(WrapMode wrap_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_WRAP_T, GLenum(wrap_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_WRAP_T, GLenum(wrap_mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::wrapP(WrapMode wrap_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_WRAP_R, GLenum(wrap_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_WRAP_R, GLenum(wrap_mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::swizzleR(SwizzleMode swizzle_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_SWIZZLE_R, GLenum(swizzle_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_SWIZZLE_R,
                    GLenum(swizzle_mode)));
+#endif
 }
 
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::swizzleG(SwizzleMode swizzle_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_SWIZZLE_G, GLenum(swizzle_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_SWIZZLE_G,
                    GLenum(swizzle_mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::swizzleB(SwizzleMode swizzle_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_SWIZZLE_B, GLenum(swizzle_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_SWIZZLE_B,
                    GLenum(swizzle_mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::swizzleA(SwizzleMode swizzle_mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_SWIZZLE_A, GLenum(swizzle_mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_SWIZZLE_A,
                    GLenum(swizzle_mode)));
+#endif
 }
 
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::swizzleRGBA(SwizzleMode swizzle_mode) {
-  OGLWRAP_CHECK_BINDING();
   const GLint swizzle_array[4] = {GLint(swizzle_mode), GLint(swizzle_mode),
                                   GLint(swizzle_mode), GLint(swizzle_mode)};
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteriv(texture_, GL_TEXTURE_SWIZZLE_RGBA, swizzle_array));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(TexParameteriv(GLenum(texture_t), GL_TEXTURE_SWIZZLE_RGBA, swizzle_array));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::anisotropy(float value) {
-  OGLWRAP_CHECK_BINDING();
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_MAX_ANISOTROPY_EXT)
+#if OGLWRAP_USE_DSA
+  gl(TextureParameterf(texture_, GL_TEXTURE_MAX_ANISOTROPY_EXT, value));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(TexParameterf(GLenum(texture_t), GL_TEXTURE_MAX_ANISOTROPY_EXT, value));
 #endif
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::maxAnisotropy() {
-  OGLWRAP_CHECK_BINDING();
 #if OGLWRAP_DEFINE_EVERYTHING || defined(GL_TEXTURE_MAX_ANISOTROPY_EXT)
   GLfloat maxAniso = 0.0f;
   gl(GetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso));
-  gl(TexParameterf(GLenum(texture_t), GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAniso));
+  anisotropy(maxAniso);
 #endif
 }
 
@@ -120,22 +172,64 @@ void TextureBase<texture_t>::maxAnisotropy() {
 template <TextureType texture_t>
 void TextureBase<texture_t>::buffer(PixelDataInternalFormat internal_format,
                                     const TextureBuffer& buffer) {
-  OGLWRAP_CHECK_BINDING();
   OGLWRAP_CHECK_BINDLESS_TEXTURE_MODIFIED(bindless_handle_);
+#if OGLWRAP_USE_DSA
+  gl(TextureBuffer(texture_, GLenum(internal_format), buffer.expose()));
+#else
+  OGLWRAP_CHECK_BINDING();
   gl(TexBuffer(GLenum(texture_t), GLenum(internal_format), buffer.expose()));
+#endif
 }
 #endif
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::compareMode(enums::CompareMode mode) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_COMPARE_MODE, GLenum(mode)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_COMPARE_MODE, GLenum(mode)));
+#endif
 }
 
 template <TextureType texture_t>
 void TextureBase<texture_t>::compareFunc(enums::CompareFunc func) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_COMPARE_FUNC, GLenum(func)));
+#else
   OGLWRAP_CHECK_BINDING();
   gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_COMPARE_FUNC, GLenum(func)));
+#endif
+}
+
+template <TextureType texture_t>
+void TextureBase<texture_t>::baseLevel(GLint level) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_BASE_LEVEL, level));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_BASE_LEVEL, level));
+#endif
+}
+
+template <TextureType texture_t>
+void TextureBase<texture_t>::maxLevel(GLint level) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameteri(texture_, GL_TEXTURE_MAX_LEVEL, level));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(TexParameteri(GLenum(texture_t), GL_TEXTURE_MAX_LEVEL, level));
+#endif
+}
+
+template <TextureType texture_t>
+void TextureBase<texture_t>::minLod(GLfloat lod) {
+#if OGLWRAP_USE_DSA
+  gl(TextureParameterf(texture_, GL_TEXTURE_MIN_LOD, lod));
+#else
+  OGLWRAP_CHECK_BINDING();
+  gl(TexParameterf(GLenum(texture_t), GL_TEXTURE_MIN_LOD, lod));
+#endif
 }
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glGetTextureHandleARB)
@@ -11,6 +11,8 @@
   #include <Magick++.h>
 #endif
 
+#include <algorithm>
+
 #include "../config.h"
 #include "../buffer.h"
 #include "../globjects.h"
@@ -35,6 +37,19 @@
 
 namespace OGLWRAP_NAMESPACE_NAME {
 
+/// Returns the number of levels in a complete mipmap chain.
+/** @param width, height, depth - The size of the base level. */
+inline GLsizei GetMipmapLevelCount(GLsizei width, GLsizei height = 1,
+                                   GLsizei depth = 1) {
+  GLsizei size = std::max(width, std::max(height, depth));
+  GLsizei levels = 1;
+  while (size > 1) {
+    size >>= 1;
+    ++levels;
+  }
+  return levels;
+}
+
 template <TextureType texture_t>
 /// This class is implementing the base functions for textures.
 /** You shouldn't use this class directly.
@@ -42,7 +57,11 @@ template <TextureType texture_t>
 class TextureBase {
  public:
   /// Creates a new texture
+#if OGLWRAP_USE_DSA
+  TextureBase() : texture_{globjects::Texture::Create(GLenum(texture_t))} {}
+#else
   TextureBase() = default;
+#endif
 
   /// Moves a texture
   TextureBase(TextureBase&&) noexcept = default;
@@ -144,6 +163,23 @@ class TextureBase {
     * @see glTexParameteri, GL_TEXTURE_COMPARE_FUNC */
   void compareFunc(enums::CompareFunc func);
 
+  /// Sets the lowest defined mipmap level.
+  /** @param level - The index of the base level.
+    * @see glTexParameteri, GL_TEXTURE_BASE_LEVEL */
+  void baseLevel(GLint level);
+
+  /// Sets the highest defined mipmap level.
+  /** Levels above it aren't needed for the texture to be complete.
+    * @param level - The index of the highest level.
+    * @see glTexParameteri, GL_TEXTURE_MAX_LEVEL */
+  void maxLevel(GLint level);
+
+  /// Sets the minimum level-of-detail parameter.
+  /** Limits the selection of the highest resolution mipmap.
+    * @param lod - The minimum level-of-detail.
+    * @see glTexParameterf, GL_TEXTURE_MIN_LOD */
+  void minLod(GLfloat lod);
+
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glGetTextureHandleARB)
   /// Generates a handle for the texture to be used bindless.
   /** @see glGetTextureHandleARB */
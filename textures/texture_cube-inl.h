@@ -5,7 +5,9 @@
 
 #include <string>
 #include "./texture_cube.h"
+#include "./pixel_conversion.h"
 #include "../context/binding.h"
+#include "../context/pixel_ops.h"
 
 #include "../define_internal_macros.h"
 
@@ -168,21 +170,26 @@ inline void TextureCube::loadTexture(TextureCubeTarget target,
                          : (alpha ? InternalFormat::kRgba8
                                   : InternalFormat::kRgb8));
 
-    bool bad_alignment = (image.columns() * format_string.length()) % 4 != 0;
-    GLint unpack_aligment;
-
-    if (bad_alignment) {
-      gl(GetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_aligment));
-      gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    // Drivers convert three component uploads on a slow path, so they are
+    // expanded to RGBA on the CPU, which also makes every row 4 byte aligned.
+    const void* data = blob.data();
+    size_t components = format_string.length();
+    std::vector<GLubyte> expanded;
+    if (components == 3) {
+      size_t count = image.columns() * image.rows();
+      expanded.resize(count * 4);
+      ConvertRgbToRgba(static_cast<const GLubyte*>(blob.data()),
+                       expanded.data(), count);
+      data = expanded.data();
+      components = 4;
     }
 
-    upload(target, internal_format, image.columns(), image.rows(),
-           alpha ? PixelDataFormat::kRgba : PixelDataFormat::kRgb,
-           PixelDataType::kUnsignedByte, blob.data());
-
-    if (bad_alignment) {
-      gl(PixelStorei(GL_UNPACK_ALIGNMENT, unpack_aligment));
-    }
+    PixelDataFormat format =
+        components == 4 ? PixelDataFormat::kRgba : PixelDataFormat::kRgb;
+    ScopedUnpackRegion region(image.columns() * components, 0, 0, format,
+                              PixelDataType::kUnsignedByte);
+    upload(target, internal_format, image.columns(), image.rows(), format,
+           PixelDataType::kUnsignedByte, data);
   } catch (const Magick::Error& error) {
     std::cerr << "Error loading texture: " << error.what() << std::endl;
   }
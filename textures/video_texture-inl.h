@@ -0,0 +1,232 @@
+// Copyright (c) Tamas Csala
+
+#ifndef OGLWRAP_TEXTURES_VIDEO_TEXTURE_INL_H_
+#define OGLWRAP_TEXTURES_VIDEO_TEXTURE_INL_H_
+
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "./video_texture.h"
+#include "../context/binding.h"
+#include "../context/pixel_ops.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+inline std::string GetYuvToRgbShaderSource(VideoFormat format,
+                                           YuvColorSpace color_space,
+                                           bool full_range) {
+  // The red and blue weights of the luma, that define the standard.
+  double kr = 0.299, kb = 0.114;
+  if (color_space == YuvColorSpace::kBt709) {
+    kr = 0.2126;
+    kb = 0.0722;
+  }
+  double kg = 1.0 - kr - kb;
+  double r_cr = 2.0 * (1.0 - kr);
+  double b_cb = 2.0 * (1.0 - kb);
+  double g_cb = -b_cb * kb / kg;
+  double g_cr = -r_cr * kr / kg;
+
+  std::ostringstream source;
+  source.precision(7);
+  source << std::fixed;
+  source << "vec3 YuvToRgb(float y, vec2 cbcr) {\n";
+  if (full_range) {
+    source << "  cbcr -= 0.5019608;\n";
+  } else {
+    // Limited range: Y is in [16, 235], Cb and Cr are in [16, 240].
+    source << "  y = (y - 0.0627451) * 1.1643836;\n"
+           << "  cbcr = (cbcr - 0.5019608) * 1.1383929;\n";
+  }
+  source << "  return clamp(vec3(y + " << r_cr << " * cbcr.y,\n"
+         << "                    y - " << -g_cb << " * cbcr.x - "
+         << -g_cr << " * cbcr.y,\n"
+         << "                    y + " << b_cb << " * cbcr.x), 0.0, 1.0);\n"
+         << "}\n\n";
+
+  if (format == VideoFormat::kNv12) {
+    source << "vec3 YuvToRgb(sampler2D y_plane, sampler2D uv_plane, "
+              "vec2 texcoord) {\n"
+           << "  return YuvToRgb(texture(y_plane, texcoord).r,\n"
+           << "                  texture(uv_plane, texcoord).rg);\n"
+           << "}\n";
+  } else {
+    source << "vec3 YuvToRgb(sampler2D y_plane, sampler2D u_plane, "
+              "sampler2D v_plane,\n"
+           << "              vec2 texcoord) {\n"
+           << "  return YuvToRgb(texture(y_plane, texcoord).r,\n"
+           << "                  vec2(texture(u_plane, texcoord).r,\n"
+           << "                       texture(v_plane, texcoord).r));\n"
+           << "}\n";
+  }
+  return source.str();
+}
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexStorage2D) \
+    && defined(glTexSubImage2D) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync) \
+    && defined(GL_RG))
+
+inline VideoTexture::VideoTexture(VideoFormat format, GLsizei width,
+                                  GLsizei height, size_t ring_size)
+    : format_(format), width_(width), height_(height)
+    , buffers_(std::max<size_t>(ring_size, 1))
+    , fences_(buffers_.size()) {
+  for (int i = 0; i < planeCount(); ++i) {
+    bool interleaved = format_ == VideoFormat::kNv12 && i == 1;
+    Bind(planes_[i]);
+    planes_[i].storage(1, interleaved ? PixelDataInternalFormat::kRg8
+                                      : PixelDataInternalFormat::kR8,
+                       planeWidth(i), planeHeight(i));
+    planes_[i].minFilter(MinFilter::kLinear);
+    planes_[i].magFilter(MagFilter::kLinear);
+    planes_[i].wrapS(WrapMode::kClampToEdge);
+    planes_[i].wrapT(WrapMode::kClampToEdge);
+  }
+
+  for (auto& buffer : buffers_) {
+    Bind(buffer);
+    buffer.data(GLsizei(frameSize()), nullptr, BufferUsage::kStreamDraw);
+  }
+  Unbind(BufferType::kPixelUnpackBuffer);
+}
+
+inline VideoTexture::~VideoTexture() {
+  if (mapped_) {
+    Bind(buffers_[current_]);
+    gl(UnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    Unbind(BufferType::kPixelUnpackBuffer);
+  }
+}
+
+inline GLsizei VideoTexture::planeRowSize(int index) const {
+  bool interleaved = format_ == VideoFormat::kNv12 && index == 1;
+  return planeWidth(index) * (interleaved ? 2 : 1);
+}
+
+inline size_t VideoTexture::planeOffset(int index) const {
+  size_t offset = 0;
+  for (int i = 0; i < index; ++i) {
+    offset += size_t(planeRowSize(i)) * planeHeight(i);
+  }
+  return offset;
+}
+
+inline bool VideoTexture::canBeginFrame() const {
+  const std::unique_ptr<Sync>& fence = fences_[current_];
+  return !fence || fence->clientWaitStatus(0, false) != GL_TIMEOUT_EXPIRED;
+}
+
+inline GLubyte* VideoTexture::beginFrame(GLuint64 timeout) {
+  if (mapped_) {
+    return mapped_;
+  }
+
+  // The fence guarantees, that the GPU is done with the buffer. A failed wait
+  // would fail forever, so the fence is dropped, and the driver synchronizes
+  // the mapping instead.
+  bool synchronized = true;
+  std::unique_ptr<Sync>& fence = fences_[current_];
+  if (fence) {
+    GLenum status = fence->clientWaitStatus(timeout);
+    if (status == GL_TIMEOUT_EXPIRED) {
+      ++dropped_frame_count_;
+      return nullptr;
+    }
+    synchronized = status != GL_WAIT_FAILED;
+    fence.reset();
+  }
+
+  Bitfield<BufferMapAccessFlags> access =
+      {BufferMapAccessFlags::kMapWriteBit,
+       BufferMapAccessFlags::kMapInvalidateBufferBit};
+  if (synchronized) {
+    access |= BufferMapAccessFlags::kMapUnsynchronizedBit;
+  }
+  Bind(buffers_[current_]);
+  void* mapped = gl(MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameSize(),
+                                   access));
+  Unbind(BufferType::kPixelUnpackBuffer);
+  mapped_ = static_cast<GLubyte*>(mapped);
+  return mapped_;
+}
+
+inline bool VideoTexture::endFrame(double timestamp) {
+  if (!mapped_) {
+    return false;
+  }
+  mapped_ = nullptr;
+
+  Bind(buffers_[current_]);
+  bool valid = gl(UnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+  if (valid) {
+    for (int i = 0; i < planeCount(); ++i) {
+      bool interleaved = format_ == VideoFormat::kNv12 && i == 1;
+      PixelDataFormat format = interleaved ? PixelDataFormat::kRg
+                                           : PixelDataFormat::kRed;
+      ScopedUnpackRegion region(planeRowSize(i), 0, 0, format,
+                                PixelDataType::kUnsignedByte);
+      Bind(planes_[i]);
+      // An offset into the unpack buffer
+      const void* offset = reinterpret_cast<const void*>(planeOffset(i));
+      planes_[i].subUpload(0, 0, planeWidth(i), planeHeight(i), format,
+                           PixelDataType::kUnsignedByte, offset);
+    }
+    fences_[current_].reset(new Sync());
+    timestamp_ = timestamp;
+    ++frame_count_;
+  }
+  Unbind(BufferType::kPixelUnpackBuffer);
+
+  current_ = (current_ + 1) % buffers_.size();
+  return valid;
+}
+
+inline bool VideoTexture::uploadFrame(const GLubyte* const* planes,
+                                      const GLsizei* strides,
+                                      double timestamp, GLuint64 timeout) {
+  for (int i = 0; i < planeCount(); ++i) {
+    if (strides[i] < planeRowSize(i)) {
+      std::stringstream message;
+      message << "VideoTexture::uploadFrame: the stride of plane " << i
+              << " (" << strides[i] << ") is shorter than its rows ("
+              << planeRowSize(i) << ")";
+      throw std::invalid_argument(message.str());
+    }
+  }
+
+  GLubyte* frame = beginFrame(timeout);
+  if (!frame) {
+    return false;
+  }
+
+  for (int i = 0; i < planeCount(); ++i) {
+    GLubyte* dst = frame + planeOffset(i);
+    size_t row_size = planeRowSize(i);
+    if (strides[i] == GLsizei(row_size)) {
+      std::memcpy(dst, planes[i], row_size * planeHeight(i));
+      continue;
+    }
+    for (GLsizei row = 0; row < planeHeight(i); ++row) {
+      std::memcpy(dst + row * row_size, planes[i] + size_t(row) * strides[i],
+                  row_size);
+    }
+  }
+
+  return endFrame(timestamp);
+}
+
+#endif  // glTexStorage2D && glTexSubImage2D && glMapBufferRange &&
+        // glUnmapBuffer && glFenceSync && glDeleteSync && glClientWaitSync &&
+        // GL_RG
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+
+#endif  // OGLWRAP_TEXTURES_VIDEO_TEXTURE_INL_H_
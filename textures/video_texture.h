@@ -0,0 +1,192 @@
+// Copyright (c) Tamas Csala
+
+/** @file video_texture.h
+    @brief Implements streaming planar YUV video frames into textures.
+*/
+
+#ifndef OGLWRAP_TEXTURES_VIDEO_TEXTURE_H_
+#define OGLWRAP_TEXTURES_VIDEO_TEXTURE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "../config.h"
+#include "../sync.h"
+#include "../buffer.h"
+#include "./texture_2D.h"
+
+#include "../define_internal_macros.h"
+
+namespace OGLWRAP_NAMESPACE_NAME {
+
+/// The planar YUV layouts of video frames.
+enum class VideoFormat {
+  /// A full resolution Y plane, and an interleaved UV plane at half the
+  /// resolution in both directions.
+  kNv12,
+  /// A full resolution Y plane, and separate U and V planes at half the
+  /// resolution in both directions.
+  kI420
+};
+
+/// The YUV to RGB conversions of the common video standards.
+enum class YuvColorSpace {
+  /// ITU-R BT.601, used by standard definition video.
+  kBt601,
+  /// ITU-R BT.709, used by high definition video.
+  kBt709
+};
+
+/// Returns the number of planes of a video format.
+inline int GetPlaneCount(VideoFormat format) {
+  return format == VideoFormat::kNv12 ? 2 : 3;
+}
+
+/// Returns the GLSL source of a function, that samples a frame in RGB.
+/** The function is vec3 YuvToRgb(sampler2D y_plane, sampler2D uv_plane,
+  * vec2 texcoord) for NV12 and vec3 YuvToRgb(sampler2D y_plane,
+  * sampler2D u_plane, sampler2D v_plane, vec2 texcoord) for I420. The source
+  * doesn't have a #version line, it's meant to be inserted into a shader.
+  * @param format - The layout of the frames.
+  * @param color_space - The standard the video was encoded with.
+  * @param full_range - True if the values use the full [0, 255] range, false
+  *                     for the usual limited (video) range. */
+std::string GetYuvToRgbShaderSource(VideoFormat format,
+                                    YuvColorSpace color_space =
+                                        YuvColorSpace::kBt709,
+                                    bool full_range = false);
+
+#if OGLWRAP_DEFINE_EVERYTHING || (defined(glTexStorage2D) \
+    && defined(glTexSubImage2D) && defined(glMapBufferRange) \
+    && defined(glUnmapBuffer) && defined(glFenceSync) \
+    && defined(glDeleteSync) && defined(glClientWaitSync) \
+    && defined(GL_RG))
+/// Streams video frames into a texture per plane, without converting them.
+/** The Y plane goes into an R8 texture, the chroma planes into an RG8 (NV12)
+  * or two R8 (I420) textures, so a frame takes half as much bandwidth as an
+  * RGB one, and the shader does the color conversion (see
+  * GetYuvToRgbShaderSource()). The frames are written into a ring of pixel
+  * unpack buffers, and the textures are updated from them, so neither the
+  * copy, nor the upload waits for the GPU to finish reading an earlier frame.
+  * A fence guards every buffer of the ring, and beginFrame() can give up
+  * waiting for it, which lets the caller drop the frame instead of stalling.
+  * The textures are bound by the functions, that modify them. */
+class VideoTexture {
+ public:
+  /// Allocates the textures and the buffer ring.
+  /** @param format - The layout of the frames.
+    * @param width, height - The size of the frames in pixels.
+    * @param ring_size - The number of frames, that can be in flight at once.
+    * @see glTexStorage2D, glBufferData */
+  VideoTexture(VideoFormat format, GLsizei width, GLsizei height,
+               size_t ring_size = 3);
+
+  /// Unmaps the buffer of the current frame, if there's one.
+  ~VideoTexture();
+
+  VideoTexture(const VideoTexture&) = delete;
+  VideoTexture& operator=(const VideoTexture&) = delete;
+
+  /// Returns the layout of the frames.
+  VideoFormat format() const { return format_; }
+
+  /// Returns the width of the frames in pixels.
+  GLsizei width() const { return width_; }
+
+  /// Returns the height of the frames in pixels.
+  GLsizei height() const { return height_; }
+
+  /// Returns the number of planes.
+  int planeCount() const { return GetPlaneCount(format_); }
+
+  /// Returns the texture of a plane (Y, then UV or U and V).
+  const Texture2D& plane(int index) const { return planes_[index]; }
+
+  /// Returns the width of a plane in texels.
+  GLsizei planeWidth(int index) const {
+    return index == 0 ? width_ : (width_ + 1) / 2;
+  }
+
+  /// Returns the height of a plane in texels.
+  GLsizei planeHeight(int index) const {
+    return index == 0 ? height_ : (height_ + 1) / 2;
+  }
+
+  /// Returns the size of a row of a plane in bytes, in the buffers.
+  GLsizei planeRowSize(int index) const;
+
+  /// Returns the offset of a plane from the start of a frame in bytes.
+  size_t planeOffset(int index) const;
+
+  /// Returns the size of a frame in bytes, with tightly packed planes.
+  size_t frameSize() const { return planeOffset(planeCount()); }
+
+  /// Returns true if beginFrame() wouldn't have to wait for the GPU.
+  /** @see glClientWaitSync */
+  bool canBeginFrame() const;
+
+  /// Maps the next buffer of the ring, so a frame can be written into it.
+  /** The planes should be written at planeOffset(), with planeRowSize() long
+    * rows.
+    * @param timeout - The maximum time to wait for the GPU to release the
+    *                  buffer, in nanoseconds.
+    * @return The mapped buffer, or nullptr if the buffer is still in use
+    *         after the timeout, and the frame should be dropped. If waiting
+    *         on the fence of the buffer fails, the fence is dropped, and the
+    *         mapping is synchronized by the driver.
+    * @see glClientWaitSync, glMapBufferRange */
+  GLubyte* beginFrame(GLuint64 timeout = GL_TIMEOUT_IGNORED);
+
+  /// Unmaps the buffer of the frame, and updates the textures from it.
+  /** @param timestamp - The presentation time of the frame, which is
+    *                    returned by timestamp() afterwards.
+    * @return False if the buffer was corrupted while it was mapped, and the
+    *         textures weren't updated.
+    * @see glUnmapBuffer, glTexSubImage2D, glFenceSync */
+  bool endFrame(double timestamp = 0.0);
+
+  /// Copies a frame into the next buffer, and updates the textures from it.
+  /** @param planes - The first byte of each plane.
+    * @param strides - The distance of the rows of each plane in bytes. They
+    *                  can't be less than planeRowSize().
+    * @param timestamp - The presentation time of the frame.
+    * @param timeout - The maximum time to wait for the GPU, in nanoseconds.
+    * @return False if the frame was dropped.
+    * @throw std::invalid_argument if a stride is less than the row size. */
+  bool uploadFrame(const GLubyte* const* planes, const GLsizei* strides,
+                   double timestamp = 0.0,
+                   GLuint64 timeout = GL_TIMEOUT_IGNORED);
+
+  /// Returns the presentation time of the frame in the textures.
+  double timestamp() const { return timestamp_; }
+
+  /// Returns the number of frames uploaded so far.
+  size_t frameCount() const { return frame_count_; }
+
+  /// Returns the number of frames dropped by beginFrame() so far.
+  size_t droppedFrameCount() const { return dropped_frame_count_; }
+
+ private:
+  VideoFormat format_;
+  GLsizei width_, height_;
+  Texture2D planes_[3];
+  std::vector<BufferObject<BufferType::kPixelUnpackBuffer>> buffers_;
+  std::vector<std::unique_ptr<Sync>> fences_;
+  size_t current_ = 0;
+  GLubyte* mapped_ = nullptr;
+  double timestamp_ = 0.0;
+  size_t frame_count_ = 0;
+  size_t dropped_frame_count_ = 0;
+};
+#endif  // glTexStorage2D && glTexSubImage2D && glMapBufferRange &&
+        // glUnmapBuffer && glFenceSync && glDeleteSync && glClientWaitSync &&
+        // GL_RG
+
+}  // namespace oglwrap
+
+#include "../undefine_internal_macros.h"
+#include "./video_texture-inl.h"
+
+#endif  // OGLWRAP_TEXTURES_VIDEO_TEXTURE_H_
@@ -132,6 +132,43 @@ class VertexAttribObject {
     }
     return *this;
   }
+
+#if OGLWRAP_DEFINE_EVERYTHING \
+      || (defined(glGenBuffers) && defined(glDeleteBuffers))
+  template <typename Vertex>
+  /**
+   * @brief Sets up an attribute, that is read from a member of the elements of
+   *        an array buffer view.
+   *
+   * The stride is the size of the view's element type, and the offset is
+   * computed from the view's offset.
+   *
+   * @param view               Specifies the range of the array buffer the
+   *                           attribute is read from. Its buffer must be bound
+   *                           to GL_ARRAY_BUFFER.
+   * @param values_per_vertex  The dimension of the attribute data. For example
+   *                           is 3 for a vec3.
+   * @param type               The data type of each component in the array.
+   * @param member_offset      Specifies the offset of the attribute inside an
+   *                           element of the view in bytes (use offsetof).
+   * @see glVertexAttribPointer, glVertexAttribIPointer, glVertexAttribLPointer
+   */
+  VertexAttribObject& setup(const ArrayBufferView<Vertex>& view,
+                            GLuint values_per_vertex,
+                            DataType type,
+                            size_t member_offset = 0) {
+#if OGLWRAP_DEBUG
+    if (member_offset >= sizeof(Vertex)) {
+      OGLWRAP_PRINT_ERROR("Attribute offset out of range",
+        "VertexAttribObject::setup was called with a member offset, that is "
+        "not inside the element type of the buffer view.");
+    }
+#endif
+    return setup(values_per_vertex, type, sizeof(Vertex),
+                 static_cast<const GLubyte*>(view.offsetPointer())
+                     + member_offset);
+  }
+#endif  // glGenBuffers && glDeleteBuffers
 #endif  // glVertexAttribPointer && glVertexAttribIPointer
 
 #if OGLWRAP_DEFINE_EVERYTHING || defined(glVertexAttribPointer)